@@ -0,0 +1,156 @@
+#include "Abdeckung.h"
+
+#include <algorithm>
+#include <cmath>
+
+const int Abdeckung::EIMER;
+const int Abdeckung::RAND;
+const size_t Abdeckung::NEBEN_MAX;
+const uint32_t Abdeckung::KEIN_EIMER;
+
+void Abdeckung::baue( const WaypointList &punkte, bool mitPfad, const std::vector<Turm> &tuerme){
+	m_punkte = punkte;
+	m_mitPfad = mitPfad;
+
+	// Die Strecken genau so wie in Pfad.cpp, dann passen sie zu
+	// EinheitenPool::strecke.
+	m_bis.assign(m_punkte.size(), 0.0);
+	for( size_t k = 1; k < m_punkte.size(); ++k){
+		double wegX = m_punkte[k][0] - m_punkte[k-1][0];
+		double wegY = m_punkte[k][1] - m_punkte[k-1][1];
+		m_bis[k] = m_bis[k-1] + std::sqrt(wegX*wegX + wegY*wegY);
+	}
+	m_anzahlEimer = m_bis.empty() ? 1 : eimer(m_bis.back()) + 1;
+
+	// Pro Turm die Stücke des Weges in seiner Reichweite. Für Abschnitt k
+	// von A nach B mit Richtung u und einen Turm bei C: welche t in [0, L]
+	// erfüllen |A + t*u - C|² <= r²? Das ist eine quadratische Gleichung.
+	m_turmAnfang.assign(1, 0);
+	m_turmBereiche.clear();
+	std::vector<uint32_t> proEimer(m_anzahlEimer, 0);
+	for( auto &t:tuerme){
+		const size_t anfang = m_turmBereiche.size();
+		const auto c = t.getPosition();
+		const double r = t.getReichweite() + RAND;
+		for( size_t k = 1; k < m_punkte.size(); ++k){
+			const double laenge = m_bis[k] - m_bis[k-1];
+			if( laenge <= 0) continue;
+			const double ux = (m_punkte[k][0] - m_punkte[k-1][0]) / laenge;
+			const double uy = (m_punkte[k][1] - m_punkte[k-1][1]) / laenge;
+			const double wx = m_punkte[k-1][0] - c[0];
+			const double wy = m_punkte[k-1][1] - c[1];
+			const double p = wx*ux + wy*uy;
+			const double d = p*p - (wx*wx + wy*wy - r*r);
+			if( d < 0) continue;
+			const double t0 = std::max(0.0, -p - std::sqrt(d));
+			const double t1 = std::min(laenge, -p + std::sqrt(d));
+			if( t0 > t1) continue;
+
+			Bereich b{eimer(m_bis[k-1] + t0 - RAND), eimer(m_bis[k-1] + t1 + RAND)};
+			// Stücke, die sich berühren, kommen zusammen. So steht keine
+			// Einheit zweimal in den Eimern eines Turms.
+			if( m_turmBereiche.size() > anfang && b.von <= m_turmBereiche.back().bis + 1){
+				m_turmBereiche.back().bis = std::max(m_turmBereiche.back().bis, b.bis);
+			}else{
+				m_turmBereiche.push_back(b);
+			}
+		}
+		for( size_t b = anfang; b < m_turmBereiche.size(); ++b){
+			for( uint32_t e = m_turmBereiche[b].von; e <= m_turmBereiche[b].bis; ++e) ++proEimer[e];
+		}
+		m_turmAnfang.push_back(m_turmBereiche.size());
+	}
+
+	// Und umgekehrt: pro Eimer die Türme.
+	m_eimerTuermeAnfang.assign(m_anzahlEimer + 1, 0);
+	for( uint32_t e = 0; e < m_anzahlEimer; ++e){
+		m_eimerTuermeAnfang[e + 1] = m_eimerTuermeAnfang[e] + proEimer[e];
+	}
+	m_eimerTuerme.assign(m_eimerTuermeAnfang.back(), 0);
+	std::fill(proEimer.begin(), proEimer.end(), 0);
+	for( uint32_t n = 0; n < tuerme.size(); ++n){
+		for( uint32_t b = m_turmAnfang[n]; b < m_turmAnfang[n + 1]; ++b){
+			for( uint32_t e = m_turmBereiche[b].von; e <= m_turmBereiche[b].bis; ++e){
+				m_eimerTuerme[m_eimerTuermeAnfang[e] + proEimer[e]++] = n;
+			}
+		}
+	}
+
+	m_wach.assign(tuerme.size(), 0);
+	m_wache.clear();
+	// Mehr können es nie werden, sortiere() holt dafür keinen Speicher.
+	m_wache.reserve(tuerme.size());
+	m_neben.reserve(NEBEN_MAX);
+}
+
+uint32_t Abdeckung::eimer( double strecke) const{
+	if( strecke <= 0) return 0;
+	uint32_t e = (uint32_t)(strecke / EIMER);
+	return m_anzahlEimer > 0 ? std::min(e, m_anzahlEimer - 1) : e;
+}
+
+double Abdeckung::strecke( const EinheitenPool &pool, size_t i) const{
+	if( m_mitPfad) return std::min(pool.strecke(i), m_bis.back());
+
+	// Auf Abschnitt k: wie weit ist es von Wegpunkt k-1 aus in Richtung k?
+	const uint32_t k = pool.wegAbschnitt(i);
+	if( k == 0 || k >= m_punkte.size()) return -1.0;
+	const double laenge = m_bis[k] - m_bis[k-1];
+	if( laenge <= 0) return m_bis[k];
+	auto pos = pool.getPosition(i);
+	const double weiter = ((pos[0] - m_punkte[k-1][0]) * (double)(m_punkte[k][0] - m_punkte[k-1][0])
+			+ (pos[1] - m_punkte[k-1][1]) * (double)(m_punkte[k][1] - m_punkte[k-1][1])) / laenge;
+	return m_bis[k-1] + std::max(0.0, std::min(laenge, weiter));
+}
+
+bool Abdeckung::sortiere( const EinheitenPool &pool){
+	// Aus den Wachen vom letzten Frame werden wieder Schläfer.
+	for( uint32_t n:m_wache) m_wach[n] = 0;
+	m_wache.clear();
+	m_neben.clear();
+	if( m_punkte.size() < 2) return false;
+
+	// Zählen, dann verteilen. Wer vorher kam, steht im Eimer auch vorne.
+	// Die Listen pro Einheit wachsen nur mit dem Pool, nicht mit jedem
+	// neuen Spawn.
+	const size_t anzahl = pool.size();
+	m_eimerVon.reserve(pool.capacity());
+	m_einheiten.reserve(pool.capacity());
+	m_eimerVon.resize(anzahl);
+	m_eimerAnfang.assign(m_anzahlEimer + 1, 0);
+	for( size_t i = 0; i < anzahl; ++i){
+		double s = strecke(pool, i);
+		if( s < 0){
+			if( m_neben.size() == NEBEN_MAX) return false;
+			m_neben.push_back(i);
+			m_eimerVon[i] = KEIN_EIMER;
+			continue;
+		}
+		m_eimerVon[i] = eimer(s);
+		++m_eimerAnfang[m_eimerVon[i] + 1];
+	}
+	for( uint32_t e = 0; e < m_anzahlEimer; ++e){
+		const uint32_t drin = m_eimerAnfang[e + 1];
+		m_eimerAnfang[e + 1] += m_eimerAnfang[e];
+
+		// Ist jemand im Eimer, werden seine Türme geweckt.
+		if( drin == 0) continue;
+		for( uint32_t k = m_eimerTuermeAnfang[e]; k < m_eimerTuermeAnfang[e + 1]; ++k){
+			const uint32_t n = m_eimerTuerme[k];
+			if( m_wach[n]) continue;
+			m_wach[n] = 1;
+			m_wache.push_back(n);
+		}
+	}
+	m_einheiten.resize(anzahl - m_neben.size());
+	for( size_t i = 0; i < anzahl; ++i){
+		if( m_eimerVon[i] == KEIN_EIMER) continue;
+		m_einheiten[m_eimerAnfang[m_eimerVon[i]]++] = i;
+	}
+	// Beim Verteilen ist jeder Anfang bis zum nächsten gewandert.
+	for( uint32_t e = m_anzahlEimer; e > 0; --e) m_eimerAnfang[e] = m_eimerAnfang[e - 1];
+	m_eimerAnfang[0] = 0;
+
+	std::sort(m_wache.begin(), m_wache.end());
+	return true;
+}
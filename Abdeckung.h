@@ -0,0 +1,120 @@
+/*
+ * Die Abdeckung.
+ *
+ * Die Einheiten laufen alle den gleichen Weg entlang, und ein Turm bewegt
+ * sich nicht mehr, wenn er einmal steht. Welche Stücke des Weges er
+ * erreichen kann, steht also schon beim Bauen fest. Trotzdem schaut er mit
+ * dem Raster (siehe Raster.h) jedes Frame in alle Zellen um sich herum, auch
+ * wenn dort gar kein Weg ist.
+ *
+ * Die Abdeckung teilt den Weg in Eimer zu 32 Pixeln Strecke. Für jeden Turm
+ * steht einmal fest, welche Eimer er erreicht: wo der Kreis seiner
+ * Reichweite einen Abschnitt schneidet, ausgerechnet mit der Mitternachtsformel.
+ * Jedes Frame werden die Einheiten nach ihrer Strecke in die Eimer sortiert.
+ * Ein Turm schaut dann nur noch in seine Eimer.
+ *
+ * Und mehr noch: jeder Eimer weiß, welche Türme ihn erreichen. Nur die Türme
+ * an vollen Eimern werden geweckt. Ein Turm, an dem gerade keiner vorbeiläuft,
+ * schläft und kostet gar nichts.
+ *
+ * Mit den Wegpunkten laufen neue Einheiten aber erst einmal von irgendwo zum
+ * ersten Wegpunkt. Die sind noch nicht auf dem Weg und kommen in keinen
+ * Eimer, sondern daneben. Jeder Turm muss sie prüfen, solange es welche gibt.
+ * Sind es zu viele (am Anfang, wenn überall Einheiten verteilt werden), gibt
+ * sortiere() false zurück und die Welt sucht in diesem Frame wie gehabt im
+ * Raster. Mit dem Flussfeld gibt es keinen festen Weg, da gibt es die
+ * Abdeckung gar nicht.
+ * */
+#ifndef ABDECKUNG_H
+#define ABDECKUNG_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Einheit.h"
+#include "EinheitenPool.h"
+#include "Turm.h"
+
+class Abdeckung {
+	public:
+		// So viele Pixel Strecke kommen in einen Eimer.
+		static const int EIMER = 32;
+
+		// Eine Einheit steht nicht genau auf dem Weg: die Position ist auf
+		// ganze Pixel gerundet, und an den Ecken schießt sie etwas über das
+		// Ziel hinaus. So viel Platz geben wir jedem Turm dazu.
+		static const int RAND = 4;
+
+		// Mehr Einheiten neben dem Weg und es lohnt sich nicht mehr.
+		static const size_t NEBEN_MAX = 64;
+
+		// Rechnet für 'punkte' als Weg und alle 'tuerme' aus, wer welche
+		// Eimer erreicht. 'mitPfad': die Einheiten laufen auf dem Pfad (siehe
+		// Pfad.h), sonst die Wegpunkte ab.
+		void baue( const WaypointList &punkte, bool mitPfad, const std::vector<Turm> &tuerme);
+
+		// Sortiert die Einheiten in die Eimer und weckt die Türme. Gibt
+		// false zurück, wenn zu viele Einheiten nicht auf dem Weg sind.
+		bool sortiere( const EinheitenPool &pool);
+
+		// Die Türme, an deren Eimern gerade jemand ist. Der Reihe nach.
+		const std::vector<uint32_t> &wache() const{
+			return m_wache;
+		}
+
+		// Die Einheiten, die noch nicht auf dem Weg sind.
+		const std::vector<uint32_t> &neben() const{
+			return m_neben;
+		}
+
+		// Ruft f(i) für jede Einheit in den Eimern von Turm n auf, und für
+		// jede neben dem Weg.
+		template<typename F>
+		void besuche( uint32_t n, F f) const{
+			for( uint32_t b = m_turmAnfang[n]; b < m_turmAnfang[n + 1]; ++b){
+				const Bereich &bereich = m_turmBereiche[b];
+				for( uint32_t k = m_eimerAnfang[bereich.von]; k < m_eimerAnfang[bereich.bis + 1]; ++k){
+					f(m_einheiten[k]);
+				}
+			}
+			for( uint32_t i:m_neben) f(i);
+		}
+
+	private:
+		// Die Eimer von 'von' bis einschließlich 'bis'.
+		struct Bereich{
+			uint32_t von;
+			uint32_t bis;
+		};
+
+		// Wo auf dem Weg steht Einheit i? -1, wenn sie nicht darauf ist.
+		double strecke( const EinheitenPool &pool, size_t i) const;
+
+		uint32_t eimer( double strecke) const;
+		static const uint32_t KEIN_EIMER = 0xFFFFFFFF;
+
+		WaypointList m_punkte;
+		std::vector<double> m_bis;		// Pro Wegpunkt: Strecke vom Anfang
+		bool m_mitPfad = false;
+		uint32_t m_anzahlEimer = 0;
+
+		// Pro Turm n: m_turmBereiche[m_turmAnfang[n] .. m_turmAnfang[n+1]]
+		std::vector<uint32_t> m_turmAnfang;
+		std::vector<Bereich> m_turmBereiche;
+
+		// Pro Eimer die Türme, die ihn erreichen. Genau so aufgeteilt.
+		std::vector<uint32_t> m_eimerTuermeAnfang;
+		std::vector<uint32_t> m_eimerTuerme;
+
+		// Jedes Frame neu: die Einheiten, nach Eimer sortiert. Die aus Eimer
+		// e stehen in m_einheiten[m_eimerAnfang[e] .. m_eimerAnfang[e+1]].
+		std::vector<uint32_t> m_eimerVon;	// Pro Einheit
+		std::vector<uint32_t> m_eimerAnfang;
+		std::vector<uint32_t> m_einheiten;
+		std::vector<uint32_t> m_neben;
+
+		std::vector<char> m_wach;		// Pro Turm
+		std::vector<uint32_t> m_wache;
+};
+
+#endif // ABDECKUNG_H
@@ -0,0 +1,39 @@
+/*
+ * Die kleinen Hilfsfunktionen für Fehler von SDL und SDL_image.
+ * Sie werden von main.cpp und vom Headless-Modus gebraucht, also bekommen sie
+ * eine eigene Datei.
+ * */
+#ifndef ANNAHME_H
+#define ANNAHME_H
+
+#include <SDL.h>
+#include <SDL_image.h>
+
+#include <stdexcept>
+#include <string>
+
+/*
+ * Das hier ist eine kleine Hilfsfunktion.
+ * An sich ist sie wohl auch als ASSERT bekannt.
+ * Man nimmt an, dass etwas stimmt. Und wenn nicht, dann ist es schlimm. In
+ * diesem Fall nutzen wir die Funktion für SDL Funktionen. Sollte jene kritisch
+ * sein und fehlschlagen, dann werfen wir eine Exception mit dem passenden
+ * Fehler.
+ * */
+inline void SDL_ANNAHME( bool stimmt){
+	if(!stimmt){
+		throw std::runtime_error(std::string() + SDL_GetError());
+	}
+}
+
+/*
+ * Eine plumpe Kopie der Zeilen oben drüber.
+ * (Vielleicht später geschickt ummodeln.)
+ * */
+inline void IMG_ANNAHME( bool stimmt){
+	if(!stimmt){
+		throw std::runtime_error(std::string() + IMG_GetError());
+	}
+}
+
+#endif // ANNAHME_H
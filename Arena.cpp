@@ -0,0 +1,37 @@
+#include "Arena.h"
+
+#include <algorithm>
+
+Arena::Arena( size_t groesse)
+	: m_block(new unsigned char[groesse])
+	, m_groesse(groesse)
+{}
+
+void *Arena::hole( size_t bytes, size_t ausrichtung){
+	// Vom Anfang des Blocks aus bis zur nächsten passenden Adresse weiter.
+	uintptr_t anfang = reinterpret_cast<uintptr_t>(m_block.get());
+	uintptr_t adresse = (anfang + m_belegt + ausrichtung - 1) & ~(uintptr_t)(ausrichtung - 1);
+	size_t ende = adresse - anfang + bytes;
+	if( ende <= m_groesse){
+		m_belegt = ende;
+		return reinterpret_cast<void*>(adresse);
+	}
+
+	// Passt nicht mehr. new[] liefert Speicher, der für jeden
+	// eingebauten Typ ausgerichtet ist. Mehr brauchen wir nicht.
+	m_ueberlauf.emplace_back(new unsigned char[std::max<size_t>(bytes, 1)]);
+	m_ueberlaufBytes += bytes + ausrichtung;
+	return m_ueberlauf.back().get();
+}
+
+void Arena::zuruecksetzen(){
+	if( !m_ueberlauf.empty()){
+		// Nächstes Mal passt alles in einen Block. Und etwas Luft, damit
+		// es nicht bei jedem bisschen mehr wieder passiert.
+		m_groesse = std::max(2 * m_groesse, m_belegt + m_ueberlaufBytes);
+		m_block.reset(new unsigned char[m_groesse]);
+		m_ueberlauf.clear();
+		m_ueberlaufBytes = 0;
+	}
+	m_belegt = 0;
+}
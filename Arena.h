@@ -0,0 +1,67 @@
+/*
+ * Die Arena.
+ *
+ * In jedem Frame braucht die Zielsuche ein bisschen Platz zum Rechnen: die
+ * Kandidaten jedes Turms, die Ziele eines besonderen Turms als Heap, ... Das
+ * alles wird am Ende des Frames nicht mehr gebraucht.
+ *
+ * Für so etwas muss man nicht jedes Mal zum Heap. Die Arena holt sich einmal
+ * einen großen Block. Wer Platz braucht, bekommt einfach das nächste Stück
+ * davon (bump allocator): ein Zeiger wird weiter geschoben, das ist alles.
+ * Einzeln zurückgegeben wird nichts. Am Ende des Frames wird der Zeiger wieder
+ * an den Anfang gesetzt, und alles ist auf einen Schlag frei.
+ *
+ * Reicht der Block nicht, gibt es für diesen Frame einen Extra-Block. Beim
+ * Zurücksetzen wird der große Block dann so groß, dass es nächstes Mal passt.
+ * Ist das Spiel eingeschwungen, wird also gar kein Speicher mehr angefordert.
+ *
+ * Da nichts zerstört wird, passen nur Typen hinein, die keinen Destruktor
+ * brauchen. Also Zahlen und einfache structs, kein std::vector.
+ * */
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+class Arena {
+	public:
+		explicit Arena( size_t groesse = 64 * 1024);
+
+		Arena( const Arena&) = delete;
+		Arena& operator=( const Arena&) = delete;
+
+		// Platz für 'anzahl' T, nicht initialisiert. Gilt bis zum nächsten
+		// zuruecksetzen().
+		template<typename T>
+		T *feld( size_t anzahl){
+			static_assert(std::is_trivially_destructible<T>::value,
+					"In der Arena wird nichts zerstört");
+			return static_cast<T*>(hole(anzahl * sizeof(T), alignof(T)));
+		}
+
+		// 'bytes' Bytes, an 'ausrichtung' ausgerichtet.
+		void *hole( size_t bytes, size_t ausrichtung);
+
+		// Alles wieder frei. War der Block zu klein, wird er jetzt größer.
+		void zuruecksetzen();
+
+		// Wie viel ist seit dem letzten zuruecksetzen() belegt?
+		size_t belegt() const{
+			return m_belegt + m_ueberlaufBytes;
+		}
+
+	private:
+		std::unique_ptr<unsigned char[]> m_block;
+		size_t m_groesse;
+		size_t m_belegt = 0;
+
+		// Was nicht mehr in den Block gepasst hat.
+		std::vector<std::unique_ptr<unsigned char[]>> m_ueberlauf;
+		size_t m_ueberlaufBytes = 0;
+};
+
+#endif // ARENA_H
@@ -0,0 +1,201 @@
+#include "Arten.h"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Eine Zahl, die zwischen 'min' und 'max' liegen muss. Sonst wird aus
+// einem negativen cooldown ein riesiger unsigned int, oder r*r läuft über.
+double zahl( const std::string &w, double min, double max){
+	const double z = std::stod(w);
+	// So herum fällt auch NaN heraus.
+	if( !(z >= min && z <= max)){
+		std::ostringstream fehler;
+		fehler.precision(10);
+		fehler << w << " liegt nicht zwischen " << min << " und " << max;
+		throw std::runtime_error(fehler.str());
+	}
+	return z;
+}
+
+// Ganze Zahlen dürfen auch mit Komma kommen, zB aus dem Stapel. Gerundet.
+long ganz( const std::string &w, long min, long max){
+	return std::lround(zahl(w, min, max));
+}
+
+// Reichweite und Splash werden quadriert, dx*dx + dy*dy muss noch in ein int
+// passen.
+const long MAX_RADIUS = 32767;
+// Mehr als eine Bildschirmbreite pro ms braucht keiner.
+const double MAX_TEMPO = 1024.0;
+// Zeiten sind Uint32 ms, der Zeitplaner schaut aber nur 2^31 ms voraus.
+const long MAX_MS = 0x7FFFFFFF;
+const long MAX_INT = 0x7FFFFFFF;
+
+// Ein Wert aus der Datei und wo er hin kommt. Einheiten-Werte haben kein
+// 'turm', Turm-Werte kein 'einheit'.
+struct Eintrag{
+	const char *name;
+	void (*einheit)( const std::string &wert, EinheitenArt &art);
+	void (*turm)( const std::string &wert, TurmArt &art);
+};
+
+// Nachladen braucht mindestens 1 ms, eine 0 hieße für den Zeitplaner "nur
+// einmal". Eine Einheit ohne Leben wäre schon beim Spawnen tot.
+const Eintrag EINTRAEGE[] = {
+	{"tempo", []( const std::string &w, EinheitenArt &a){ a.geschwindigkeit = zahl(w, 0.0, MAX_TEMPO); }, nullptr},
+	{"leben", []( const std::string &w, EinheitenArt &a){ a.leben = (int)ganz(w, 1, MAX_INT); }, nullptr},
+	{"reichweite", nullptr, []( const std::string &w, TurmArt &a){ a.setzeReichweite((int)ganz(w, 0, MAX_RADIUS)); }},
+	{"nachladen", nullptr, []( const std::string &w, TurmArt &a){ a.nachladen = (unsigned int)ganz(w, 1, MAX_MS); }},
+	{"cooldown", nullptr, []( const std::string &w, TurmArt &a){ a.coolDown = (unsigned int)ganz(w, 0, MAX_MS); }},
+	{"schaden", nullptr, []( const std::string &w, TurmArt &a){ a.schaden = (int)ganz(w, 0, MAX_INT); }},
+	{"splash", nullptr, []( const std::string &w, TurmArt &a){ a.splash = (int)ganz(w, 0, MAX_RADIUS); }},
+	{"geschosse", nullptr, []( const std::string &w, TurmArt &a){ a.geschossTempo = zahl(w, 0.0, MAX_TEMPO); }},
+	{"zielwahl", nullptr, []( const std::string &w, TurmArt &a){ a.zielwahl = zielwahlAusName(w); }},
+};
+
+const Eintrag *findeEintrag( const std::string &name){
+	for( auto &e:EINTRAEGE){
+		if( name == e.name) return &e;
+	}
+	return nullptr;
+}
+
+template<typename Namen>
+long suche( const Namen &namen, const std::string &name){
+	for( size_t n = 0; n < namen.size(); ++n){
+		if( namen[n] == name) return (long)n;
+	}
+	return -1;
+}
+
+// Mehr passen nicht in eine Nummer.
+const size_t MAX_ARTEN = 0xFFFF;
+
+}
+
+Zielwahl zielwahlAusName( const std::string &name){
+	if( name == "reihenfolge") return Zielwahl::Reihenfolge;
+	if( name == "vorderste") return Zielwahl::Vorderste;
+	if( name == "naechste") return Zielwahl::Naechste;
+	if( name == "staerkste") return Zielwahl::Staerkste;
+	if( name == "schwaechste") return Zielwahl::Schwaechste;
+	throw std::runtime_error("Unbekannte Zielwahl: " + name);
+}
+
+Arten Arten::standard(){
+	Arten arten;
+	arten.neueEinheit("gegner");
+	arten.m_einheitBilder.back() = "enemy";
+
+	arten.neuerTurm("turm");
+	arten.m_turmBilder.back() = "turret";
+
+	// Ein halber Pixel pro ms, so kann man ihnen noch zuschauen.
+	TurmArt geschuetz;
+	geschuetz.geschossTempo = 0.5;
+	arten.neuerTurm("geschuetz", geschuetz);
+	arten.m_turmBilder.back() = "turret";
+	return arten;
+}
+
+Arten::Nummer Arten::neueEinheit( const std::string &name, const EinheitenArt &art){
+	if( suche(m_einheitNamen, name) >= 0) throw std::runtime_error("Die Einheit " + name + " gibt es schon");
+	if( m_einheiten.size() >= MAX_ARTEN) throw std::runtime_error("Zu viele Arten von Einheiten");
+	m_einheiten.push_back(art);
+	m_einheitNamen.push_back(name);
+	m_einheitBilder.emplace_back();
+	return m_einheiten.size() - 1;
+}
+
+Arten::Nummer Arten::neuerTurm( const std::string &name, const TurmArt &art){
+	if( suche(m_turmNamen, name) >= 0) throw std::runtime_error("Den Turm " + name + " gibt es schon");
+	if( m_tuerme.size() >= MAX_ARTEN) throw std::runtime_error("Zu viele Arten von Türmen");
+	m_tuerme.push_back(art);
+	m_turmNamen.push_back(name);
+	m_turmBilder.emplace_back();
+	return m_tuerme.size() - 1;
+}
+
+bool Arten::gibtWert( const std::string &name){
+	return findeEintrag(name) != nullptr;
+}
+
+void Arten::setzeWert( const std::string &name, const std::string &wert, Nummer einheit, Nummer turm){
+	const Eintrag *eintrag = findeEintrag(name);
+	if( eintrag == nullptr) throw std::runtime_error("Unbekannter Wert " + name);
+	if( einheit >= m_einheiten.size() || turm >= m_tuerme.size()){
+		throw std::runtime_error("Die Art für " + name + " gibt es nicht");
+	}
+	try{
+		if( eintrag->einheit != nullptr) eintrag->einheit(wert, m_einheiten[einheit]);
+		else eintrag->turm(wert, m_tuerme[turm]);
+	}catch(std::logic_error&){
+		throw std::runtime_error("Keine Zahl: " + wert);
+	}
+}
+
+Arten::Nummer Arten::einheitNummer( const std::string &name) const{
+	long n = suche(m_einheitNamen, name);
+	if( n < 0) throw std::runtime_error("Unbekannte Einheit: " + name);
+	return (Nummer)n;
+}
+
+Arten::Nummer Arten::turmNummer( const std::string &name) const{
+	long n = suche(m_turmNamen, name);
+	if( n < 0) throw std::runtime_error("Unbekannter Turm: " + name);
+	return (Nummer)n;
+}
+
+void Arten::lade( const std::string &datei){
+	std::ifstream ein(datei);
+	if( !ein) throw std::runtime_error("Kann " + datei + " nicht lesen");
+
+	// Welche Art bekommt gerade ihre Werte? -1 = noch keine
+	long einheit = -1;
+	long turm = -1;
+	std::string zeile;
+	int nummer = 0;
+	while( std::getline(ein, zeile)){
+		++nummer;
+		auto kommentar = zeile.find('#');
+		if( kommentar != std::string::npos) zeile.erase(kommentar);
+
+		std::istringstream woerter(zeile);
+		std::string name;
+		std::string w;
+		if( !(woerter >> name)) continue;
+		const std::string wo = datei + ":" + std::to_string(nummer) + ": ";
+		if( !(woerter >> w)) throw std::runtime_error(wo + name + " ohne Wert");
+
+		try{
+			if( name == "einheit"){
+				einheit = suche(m_einheitNamen, w);
+				if( einheit < 0) einheit = neueEinheit(w);
+				turm = -1;
+			}else if( name == "turm"){
+				turm = suche(m_turmNamen, w);
+				if( turm < 0) turm = neuerTurm(w);
+				einheit = -1;
+			}else if( name == "bild"){
+				if( einheit >= 0) m_einheitBilder[einheit] = w;
+				else if( turm >= 0) m_turmBilder[turm] = w;
+				else throw std::runtime_error("bild vor der ersten Art");
+			}else{
+				const Eintrag *eintrag = findeEintrag(name);
+				if( eintrag == nullptr) throw std::runtime_error("Unbekannter Wert " + name);
+				if( einheit >= 0 && eintrag->einheit != nullptr) eintrag->einheit(w, m_einheiten[einheit]);
+				else if( turm >= 0 && eintrag->turm != nullptr) eintrag->turm(w, m_tuerme[turm]);
+				else throw std::runtime_error(name + " passt hier zu keiner Art");
+			}
+		}catch(std::logic_error&){
+			// Das werfen stoi und Co., wenn keine Zahl da steht.
+			throw std::runtime_error(wo + "Keine Zahl: " + w);
+		}catch(std::runtime_error &e){
+			throw std::runtime_error(wo + e.what());
+		}
+	}
+}
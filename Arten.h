@@ -0,0 +1,234 @@
+/*
+ * Die Arten.
+ *
+ * Bisher hatte jede Einheit und jeder Turm alle Werte selber dabei:
+ * Geschwindigkeit, Leben, Reichweite (und ihr Quadrat), Nachladen, Cool down,
+ * Schaden, Splash, Texture, ... Bei tausend Türmen steht tausendmal das
+ * Gleiche im Speicher, und jeder Turm ist so groß, dass kaum welche in eine
+ * Cache-Zeile passen. Und wer eine neue Sorte Gegner wollte, musste in
+ * main.cpp Werte setzen und neu bauen.
+ *
+ * Jetzt gibt es eine Tabelle mit allen Arten von Einheiten und Türmen. Jede
+ * Zeile ist auf eine Cache-Zeile (64 Bytes) ausgerichtet, und sie wird nur
+ * beim Einrichten gefüllt: aus Arten::standard() und einer Datei (siehe
+ * lade()). Danach teilen sich alle die Tabelle nur noch zum Lesen, die Welt
+ * hält sie als std::shared_ptr<const Arten>.
+ *
+ * Eine Einheit im EinheitenPool hat dann nur noch die Nummer ihrer Art (zwei
+ * Bytes statt acht für die Geschwindigkeit), ein Turm die Nummer und einen
+ * Zeiger auf seine Zeile. Was sich ändert (Position, Leben, Schüsse, ...),
+ * bleibt bei jedem selber.
+ *
+ * Die Datei sieht so aus:
+ *
+ *		# Kommentare mit #
+ *		einheit flitzer
+ *		tempo 1.2
+ *		leben 2
+ *		bild enemy
+ *
+ *		turm kanone
+ *		reichweite 220
+ *		splash 40
+ *		zielwahl vorderste
+ *
+ * Mit "einheit name" oder "turm name" fängt eine Art an, die Zeilen danach
+ * setzen ihre Werte. Gibt es die Art schon, werden nur die genannten Werte
+ * geändert, sonst fängt sie mit den Werten von Arten::standard() an.
+ *
+ * Was geht:
+ *		tempo		px pro ms (Einheit)
+ *		leben		(Einheit)
+ *		reichweite	in px (Turm)
+ *		nachladen	alle wie viele ms ein Schuss dazukommt (Turm)
+ *		cooldown	ms zwischen zwei Schüssen (Turm)
+ *		schaden		pro Treffer (Turm)
+ *		splash		Radius in px (Turm)
+ *		geschosse	Tempo der Geschosse in px pro ms, 0 = sofort (Turm)
+ *		zielwahl	reihenfolge, vorderste, naechste, staerkste, schwaechste (Turm)
+ *		bild		Name im Atlas, siehe Atlas.h (beide)
+ * Keine der Zahlen darf negativ sein, Leben und Nachladen nicht 0. Reichweite
+ * und Splash gehen bis 32767, Tempo bis 1024. Sonst gibt es einen Fehler mit
+ * Datei und Zeile.
+ * */
+#ifndef ARTEN_H
+#define ARTEN_H
+
+#include <SDL.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "SpriteBatch.h"
+
+// Auf welche der Einheiten in Reichweite schießt der Turm?
+// → Reihenfolge: die mit der kleinsten Nummer im Pool, so wie schon immer
+// → Vorderste: die, die am weitesten gelaufen ist, also dem Ausgang am nächsten
+// → Naechste: die dem Turm am nächsten ist
+// → Staerkste, Schwaechste: die mit dem meisten oder wenigsten Leben
+enum class Zielwahl{
+	Reihenfolge,
+	Vorderste,
+	Naechste,
+	Staerkste,
+	Schwaechste
+};
+
+// "reihenfolge", "vorderste", ... Wirft bei allem anderen.
+Zielwahl zielwahlAusName( const std::string &name);
+
+// Alles, was Einheiten der gleichen Art gemeinsam haben.
+struct alignas(64) EinheitenArt{
+	double geschwindigkeit = (1280.0 /2.0)/1000.0;	// in px pro ms
+	int leben = 5;
+	int breite = 32;
+	int hoehe = 32;
+	SDL_Texture *texture = nullptr;
+	SDL_Rect quelle{0,0,0,0};	// Welcher Teil der Texture? Bei w == 0 die ganze.
+};
+
+// Alles, was Türme der gleichen Art gemeinsam haben. Was die Zielsuche
+// braucht, steht vorne, in der ersten Cache-Zeile.
+struct alignas(64) TurmArt{
+	// Ein Feld ist jetzt mal 32px breit. Die Reichweite ist 5 Felder.
+	int reichweite = 32*5;
+	int reichweite2 = reichweite*reichweite; // das quadrat davon
+	unsigned int coolDown = 250;
+	int splash = 0;
+	Zielwahl zielwahl = Zielwahl::Reihenfolge;
+	int schaden = 1;
+	double geschossTempo = 0.0;
+	unsigned int nachladen = 250; // alle wie viele ms gibt es einen Schuss dazu
+	int breite = 32;
+	int hoehe = 32;
+	SDL_Texture *texture = nullptr;
+	SDL_Rect quelle{0,0,0,0};
+
+	void setzeReichweite( int r){
+		reichweite = r;
+		reichweite2 = r * r;
+	}
+
+	// Schießt die Art anders als einfach der Reihe nach? Siehe
+	// Welt::zielsucheBesondere.
+	bool istBesonders() const{
+		return zielwahl != Zielwahl::Reihenfolge || splash > 0;
+	}
+};
+
+// std::allocator richtet in C++11 nur so aus wie die eingebauten Typen (meist
+// 16 Bytes), alignas(64) hilft im std::vector also nichts. Dieser holt etwas
+// mehr und rückt den Anfang selber zurecht. Der echte Zeiger steht direkt
+// davor, für deallocate.
+template<typename T>
+struct AusgerichteterAllocator{
+	typedef T value_type;
+
+	AusgerichteterAllocator() = default;
+	template<typename U>
+	AusgerichteterAllocator( const AusgerichteterAllocator<U>&){}
+
+	T *allocate( size_t anzahl){
+		const uintptr_t a = alignof(T);
+		auto roh = static_cast<unsigned char*>(::operator new(anzahl * sizeof(T) + a + sizeof(void*)));
+		uintptr_t anfang = (reinterpret_cast<uintptr_t>(roh) + sizeof(void*) + a - 1) & ~(a - 1);
+		reinterpret_cast<void**>(anfang)[-1] = roh;
+		return reinterpret_cast<T*>(anfang);
+	}
+
+	void deallocate( T *p, size_t){
+		::operator delete(reinterpret_cast<void**>(p)[-1]);
+	}
+};
+
+template<typename T, typename U>
+bool operator==( const AusgerichteterAllocator<T>&, const AusgerichteterAllocator<U>&){ return true; }
+template<typename T, typename U>
+bool operator!=( const AusgerichteterAllocator<T>&, const AusgerichteterAllocator<U>&){ return false; }
+
+class Arten {
+	public:
+		typedef uint16_t Nummer;
+
+		// Eine Einheit "gegner" und zwei Türme: "turm" schießt sofort (so
+		// wie bisher ohne Fenster), "geschuetz" mit Geschossen (so wie im
+		// Spiel, siehe richteSpielEin).
+		static Arten standard();
+
+		// Liest die Datei und ergänzt oder ändert die Arten darin. Wirft
+		// std::runtime_error mit Datei und Zeile, wenn etwas nicht passt.
+		void lade( const std::string &datei);
+
+		// Neue Arten hinten anhängen. Wirft, wenn es den Namen schon gibt.
+		Nummer neueEinheit( const std::string &name, const EinheitenArt &art = EinheitenArt());
+		Nummer neuerTurm( const std::string &name, const TurmArt &art = TurmArt());
+
+		size_t anzahlEinheiten() const{ return m_einheiten.size(); }
+		size_t anzahlTuerme() const{ return m_tuerme.size(); }
+
+		// Ohne Prüfung, für die heißen Schleifen. Die Nummer muss passen.
+		const EinheitenArt &einheit( Nummer n) const{ return m_einheiten[n]; }
+		const TurmArt &turm( Nummer n) const{ return m_tuerme[n]; }
+		const EinheitenArt *einheiten() const{ return m_einheiten.data(); }
+
+		// Zum Ändern, nur solange die Tabelle noch keiner teilt.
+		EinheitenArt &einheit( Nummer n){ return m_einheiten[n]; }
+		TurmArt &turm( Nummer n){ return m_tuerme[n]; }
+
+		// Die Werte aus der Datei gibt es auch einzeln, zB für den Stapel
+		// (siehe Stapel.h). Ein Wert einer Einheit kommt in die Einheit
+		// 'einheit', einer eines Turms in den Turm 'turm'. "bild" gibt es
+		// hier nicht. Wirft, wenn es den Wert nicht gibt oder er nicht passt.
+		static bool gibtWert( const std::string &name);
+		void setzeWert( const std::string &name, const std::string &wert, Nummer einheit, Nummer turm);
+
+		// Die Nummer zum Namen. Wirft, wenn es die Art nicht gibt.
+		Nummer einheitNummer( const std::string &name) const;
+		Nummer turmNummer( const std::string &name) const;
+
+		const std::string &einheitName( Nummer n) const{ return m_einheitNamen[n]; }
+		const std::string &turmName( Nummer n) const{ return m_turmNamen[n]; }
+
+		// Holt für jede Art mit einem Bild Texture, Ausschnitt und Größe.
+		// 'sprite' bekommt den Namen, zB [&]( const std::string &name){
+		// return atlas.sprite(name); }.
+		template<typename F>
+		void setzeBilder( F sprite){
+			for( size_t n = 0; n < m_einheiten.size(); ++n){
+				if( m_einheitBilder[n].empty()) continue;
+				Sprite s = sprite(m_einheitBilder[n]);
+				setzeBild(m_einheiten[n], s);
+			}
+			for( size_t n = 0; n < m_tuerme.size(); ++n){
+				if( m_turmBilder[n].empty()) continue;
+				Sprite s = sprite(m_turmBilder[n]);
+				setzeBild(m_tuerme[n], s);
+			}
+		}
+
+	private:
+		template<typename A>
+		static void setzeBild( A &art, const Sprite &s){
+			art.texture = s.texture;
+			art.quelle = s.quelle;
+			art.breite = s.quelle.w;
+			art.hoehe = s.quelle.h;
+		}
+
+		// Die Zeilen, die beim Spielen gelesen werden.
+		std::vector<EinheitenArt, AusgerichteterAllocator<EinheitenArt>> m_einheiten;
+		std::vector<TurmArt, AusgerichteterAllocator<TurmArt>> m_tuerme;
+
+		// Was nur beim Einrichten gebraucht wird, liegt extra.
+		std::vector<std::string> m_einheitNamen;
+		std::vector<std::string> m_einheitBilder;
+		std::vector<std::string> m_turmNamen;
+		std::vector<std::string> m_turmBilder;
+};
+
+static_assert(sizeof(EinheitenArt) == 64, "Eine EinheitenArt soll genau eine Cache-Zeile sein");
+
+#endif // ARTEN_H
@@ -0,0 +1,182 @@
+#include "Atlas.h"
+#include "Annahme.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+#ifdef __unix__
+#include <dirent.h>
+#endif
+
+namespace {
+
+const int RAND = 1;
+
+int naechsteZweierpotenz( int n){
+	int p = 1;
+	while( p < n) p *= 2;
+	return p;
+}
+
+// "images/enemy.png" → "enemy"
+std::string nameVon( const std::string &datei){
+	auto anfang = datei.find_last_of("/\\");
+	anfang = anfang == std::string::npos ? 0 : anfang + 1;
+	auto ende = datei.rfind('.');
+	if( ende == std::string::npos || ende < anfang) ende = datei.size();
+	return datei.substr(anfang, ende - anfang);
+}
+
+bool endetAuf( const std::string &text, const std::string &ende){
+	return text.size() >= ende.size() && text.compare(text.size() - ende.size(), ende.size(), ende) == 0;
+}
+
+// Alle PNGs im Ordner, außer dem Atlas selber. Sortiert, damit jeder Start
+// gleich packt.
+std::vector<std::string> allePngs( const std::string &ordner){
+	std::vector<std::string> dateien;
+#ifdef __unix__
+	DIR *dir = opendir(ordner.c_str());
+	if( dir == nullptr) throw std::runtime_error("Kann Ordner " + ordner + " nicht lesen");
+	while( dirent *eintrag = readdir(dir)){
+		std::string name = eintrag->d_name;
+		if( endetAuf(name, ".png") && name != "atlas.png") dateien.push_back(ordner + "/" + name);
+	}
+	closedir(dir);
+#else
+	throw std::runtime_error("Kein " + ordner + "/atlas.txt gefunden");
+#endif
+	std::sort(dateien.begin(), dateien.end());
+	return dateien;
+}
+
+}
+
+Atlas::~Atlas(){
+	SDL_DestroyTexture(m_texture);
+}
+
+void Atlas::lade( SDL_Renderer *renderer, const std::string &ordner){
+	// Schon geladen?
+	if( m_texture != nullptr && ordner == m_ordner) return;
+
+	Plaetze plaetze;
+	SDL_Surface *bild = nullptr;
+
+	std::ifstream liste(ordner + "/atlas.txt");
+	if( liste){
+		// Schon beim Bauen gepackt.
+		std::string name;
+		SDL_Rect platz;
+		while( liste >> name >> platz.x >> platz.y >> platz.w >> platz.h){
+			plaetze[name] = platz;
+		}
+		bild = IMG_Load((ordner + "/atlas.png").c_str());
+		IMG_ANNAHME(bild != nullptr);
+	}else{
+		bild = packe(allePngs(ordner), plaetze);
+	}
+
+	SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, bild);
+	SDL_FreeSurface(bild);
+	SDL_ANNAHME(texture != nullptr);
+
+	SDL_DestroyTexture(m_texture);
+	m_texture = texture;
+	m_plaetze.swap(plaetze);
+	m_ordner = ordner;
+}
+
+Sprite Atlas::sprite( const std::string &name) const{
+	auto platz = m_plaetze.find(name);
+	if( platz == m_plaetze.end()){
+		throw std::runtime_error("Kein Bild " + name + " im Atlas");
+	}
+	return {m_texture, platz->second};
+}
+
+SDL_Surface *Atlas::packe( const std::vector<std::string> &dateien, Plaetze &plaetze){
+	struct Bild{
+		std::string name;
+		SDL_Surface *flaeche;
+	};
+	std::vector<Bild> bilder;
+
+	// Alle laden und in das gleiche Format bringen.
+	// Geht etwas schief, dürfen die schon geladenen nicht liegen bleiben.
+	auto aufraeumen = [&bilder]{
+		for( auto &b:bilder) SDL_FreeSurface(b.flaeche);
+	};
+	try{
+		for( auto &datei:dateien){
+			SDL_Surface *geladen = IMG_Load(datei.c_str());
+			IMG_ANNAHME(geladen != nullptr);
+			SDL_Surface *rgba = SDL_ConvertSurfaceFormat(geladen, SDL_PIXELFORMAT_RGBA32, 0);
+			SDL_FreeSurface(geladen);
+			SDL_ANNAHME(rgba != nullptr);
+			bilder.push_back({nameVon(datei), rgba});
+		}
+	}catch(...){
+		aufraeumen();
+		throw;
+	}
+
+	// Die höchsten zuerst, dann sind die Regale gut gefüllt.
+	std::sort(bilder.begin(), bilder.end(), []( const Bild &a, const Bild &b){
+			if( a.flaeche->h != b.flaeche->h) return a.flaeche->h > b.flaeche->h;
+			return a.name < b.name;
+		});
+
+	// So breit, dass es ungefähr quadratisch wird, aber jedes Bild passt.
+	int flaeche = 0;
+	int breitestes = 0;
+	for( auto &b:bilder){
+		flaeche += (b.flaeche->w + RAND) * (b.flaeche->h + RAND);
+		breitestes = std::max(breitestes, b.flaeche->w + 2*RAND);
+	}
+	int breite = 1;
+	while( breite * breite < flaeche) breite *= 2;
+	breite = naechsteZweierpotenz(std::max(breite, breitestes));
+
+	// Die Regale einräumen.
+	int x = RAND, y = RAND, regalHoehe = 0;
+	plaetze.clear();
+	for( auto &b:bilder){
+		if( x + b.flaeche->w + RAND > breite){
+			y += regalHoehe + RAND;
+			x = RAND;
+			regalHoehe = 0;
+		}
+		plaetze[b.name] = SDL_Rect{x, y, b.flaeche->w, b.flaeche->h};
+		x += b.flaeche->w + RAND;
+		regalHoehe = std::max(regalHoehe, b.flaeche->h);
+	}
+	int hoehe = naechsteZweierpotenz(y + regalHoehe + RAND);
+
+	SDL_Surface *atlas = SDL_CreateRGBSurfaceWithFormat(0, breite, hoehe, 32, SDL_PIXELFORMAT_RGBA32);
+	if( atlas == nullptr){
+		aufraeumen();
+		SDL_ANNAHME(false);
+	}
+	for( auto &b:bilder){
+		// Die Pixel 1:1 übernehmen, auch die durchsichtigen. Sonst würde
+		// SDL sie mit dem (leeren) Atlas mischen.
+		SDL_SetSurfaceBlendMode(b.flaeche, SDL_BLENDMODE_NONE);
+		SDL_Rect ziel = plaetze[b.name];
+		SDL_BlitSurface(b.flaeche, nullptr, atlas, &ziel);
+	}
+	aufraeumen();
+	return atlas;
+}
+
+void Atlas::speichere( SDL_Surface *atlas, const Plaetze &plaetze, const std::string &ordner){
+	IMG_ANNAHME(IMG_SavePNG(atlas, (ordner + "/atlas.png").c_str()) == 0);
+
+	std::ofstream liste(ordner + "/atlas.txt");
+	if( !liste) throw std::runtime_error("Kann " + ordner + "/atlas.txt nicht schreiben");
+	for( auto &p:plaetze){
+		liste << p.first << " " << p.second.x << " " << p.second.y
+			<< " " << p.second.w << " " << p.second.h << "\n";
+	}
+}
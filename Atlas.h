@@ -0,0 +1,70 @@
+/*
+ * Der Atlas.
+ *
+ * Bisher hat main() jedes Bild einzeln mit IMG_Load geladen und daraus eine
+ * eigene Texture gemacht. Mit jedem neuen Bild wird das mehr: mehr Dateien
+ * zu dekodieren, und beim Zeichnen muss der Renderer zwischen den Texturen
+ * wechseln. Der SpriteBatch braucht für jede Texture einen eigenen Aufruf.
+ *
+ * Der Atlas packt darum alle Bilder nebeneinander in ein einziges großes Bild.
+ * Jedes Bild bekommt darin seinen Platz (ein Rechteck), und man fragt nach
+ * ihm über seinen Namen: "enemy" für images/enemy.png.
+ *
+ * Das Packen passiert schon beim Bauen (siehe images/CMakeLists.txt und
+ * AtlasPacker.cpp). Dabei entstehen atlas.png und atlas.txt mit den Plätzen.
+ * Beim Start wird dann nur noch das eine Bild geladen. Fehlen die beiden
+ * Dateien (zB beim Start direkt aus dem Quellordner), wird beim Start
+ * gepackt.
+ *
+ * Gepackt wird in Regalen (shelf packing): die Bilder der Höhe nach
+ * sortiert, dann von links nach rechts in eine Reihe. Ist die Reihe voll, fängt
+ * darunter eine neue an. Zwischen den Bildern bleibt ein Pixel frei, damit beim
+ * Skalieren nichts vom Nachbarn herüber blutet.
+ * */
+#ifndef ATLAS_H
+#define ATLAS_H
+
+#include <SDL.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "SpriteBatch.h"
+
+class Atlas {
+	public:
+		typedef std::map<std::string, SDL_Rect> Plaetze;
+
+		Atlas() = default;
+		~Atlas();
+
+		Atlas( const Atlas&) = delete;
+		Atlas& operator=( const Atlas&) = delete;
+
+		// Lädt den Atlas aus 'ordner'. Ein zweiter Aufruf mit dem gleichen
+		// Ordner lädt nichts neu. Wirft, wenn etwas nicht klappt.
+		void lade( SDL_Renderer *renderer, const std::string &ordner);
+
+		// Das Bild mit dem Namen (Dateiname ohne .png). Wirft, wenn es das
+		// nicht gibt.
+		Sprite sprite( const std::string &name) const;
+
+		size_t size() const{
+			return m_plaetze.size();
+		}
+
+		// Packt die Bilder in eine neue Fläche. Die Plätze kommen nach
+		// 'plaetze'. Für den Build-Schritt und für lade().
+		static SDL_Surface *packe( const std::vector<std::string> &dateien, Plaetze &plaetze);
+
+		// Schreibt atlas.png und atlas.txt nach 'ordner'.
+		static void speichere( SDL_Surface *atlas, const Plaetze &plaetze, const std::string &ordner);
+
+	private:
+		SDL_Texture *m_texture = nullptr;
+		Plaetze m_plaetze;
+		std::string m_ordner;
+};
+
+#endif // ATLAS_H
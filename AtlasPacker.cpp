@@ -0,0 +1,38 @@
+/*
+ * Packt beim Bauen alle Bilder in den Atlas.
+ *
+ *   TD_AtlasPacker ausgabeOrdner bild1.png bild2.png ...
+ *
+ * Schreibt ausgabeOrdner/atlas.png und ausgabeOrdner/atlas.txt. Siehe Atlas.h.
+ * */
+#include "Atlas.h"
+#include "Annahme.h"
+
+#include <iostream>
+
+int main( int argc, char **argv){
+	if( argc < 3){
+		std::cerr << "Aufruf: " << argv[0] << " ausgabeOrdner bild.png..." << std::endl;
+		return 1;
+	}
+
+	try{
+		IMG_ANNAHME( (IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) != 0);
+
+		std::vector<std::string> dateien(argv + 2, argv + argc);
+		Atlas::Plaetze plaetze;
+		SDL_Surface *atlas = Atlas::packe(dateien, plaetze);
+		std::cout << "Atlas " << atlas->w << "x" << atlas->h << " mit "
+			<< plaetze.size() << " Bildern" << std::endl;
+
+		Atlas::speichere(atlas, plaetze, argv[1]);
+		SDL_FreeSurface(atlas);
+
+	}catch(std::exception &e){
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	IMG_Quit();
+	return 0;
+}
@@ -0,0 +1,111 @@
+#include "Aufzeichnung.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+const char KENNUNG[4] = {'T', 'D', 'E', 'L'};
+const uint8_t VERSION = 1;
+
+// Negative Zahlen (Klicks links vom Fenster, rückwärts laufende Uhr) würden
+// als varint 5 Bytes brauchen. Zickzack macht aus 0,-1,1,-2,2... die Zahlen
+// 0,1,2,3,4...
+uint32_t zickzack( int32_t n){
+	return ((uint32_t)n << 1) ^ (uint32_t)(n >> 31);
+}
+
+int32_t zackzick( uint32_t n){
+	return (int32_t)(n >> 1) ^ -(int32_t)(n & 1);
+}
+
+}
+
+EingabeAufnahme::EingabeAufnahme( const std::string &pfad)
+	: m_datei(pfad, std::ios::binary)
+{
+	if( !m_datei) throw std::runtime_error("Kann " + pfad + " nicht schreiben");
+	m_datei.write(KENNUNG, sizeof(KENNUNG));
+	m_datei.put(VERSION);
+}
+
+void EingabeAufnahme::klick( uint32_t tick, int x, int y){
+	schreibe({Eingabe::Art::Klick, tick, x, y});
+}
+
+void EingabeAufnahme::frame( uint32_t tick, int frameZeit, uint32_t jetzt){
+	schreibe({Eingabe::Art::Frame, tick, frameZeit, (int32_t)(jetzt - m_letzteZeit)});
+	m_letzteZeit = jetzt;
+
+	// Stürzt das Spiel ab, soll die Aufnahme bis hier trotzdem da sein.
+	m_datei.flush();
+}
+
+void EingabeAufnahme::schreibe( const Eingabe &e){
+	m_datei.put((char)e.art);
+	schreibeZahl(e.tick - m_letzterTick);
+	schreibeZahl(zickzack(e.a));
+	schreibeZahl(zickzack(e.b));
+	m_letzterTick = e.tick;
+}
+
+void EingabeAufnahme::schreibeZahl( uint32_t zahl){
+	while( zahl >= 0x80){
+		m_datei.put((char)(0x80 | (zahl & 0x7F)));
+		zahl >>= 7;
+	}
+	m_datei.put((char)zahl);
+}
+
+EingabeWiedergabe::EingabeWiedergabe( const std::string &pfad)
+	: m_datei(pfad, std::ios::binary)
+{
+	if( !m_datei) throw std::runtime_error("Kann " + pfad + " nicht lesen");
+
+	char kennung[sizeof(KENNUNG)];
+	m_datei.read(kennung, sizeof(kennung));
+	int version = m_datei.get();
+	if( !m_datei || !std::equal(kennung, kennung + sizeof(kennung), KENNUNG)){
+		throw std::runtime_error(pfad + " ist kein Eingabe-Log");
+	}
+	if( version != VERSION){
+		throw std::runtime_error(pfad + " hat die falsche Version");
+	}
+}
+
+bool EingabeWiedergabe::naechste( Eingabe &e){
+	int art = m_datei.get();
+	if( art == std::char_traits<char>::eof()) return false;
+
+	e.art = (Eingabe::Art)art;
+	e.tick = m_letzterTick + leseZahl();
+	e.a = zackzick(leseZahl());
+	e.b = zackzick(leseZahl());
+	m_letzterTick = e.tick;
+
+	switch(e.art){
+		case Eingabe::Art::Frame:
+			// Im Log steht nur der Abstand zur letzten Uhrzeit.
+			m_letzteZeit += (uint32_t)e.b;
+			e.b = (int32_t)m_letzteZeit;
+			break;
+		case Eingabe::Art::Klick:
+			break;
+		default:
+			throw std::runtime_error("Unbekannte Eingabe im Log");
+	}
+	return true;
+}
+
+uint32_t EingabeWiedergabe::leseZahl(){
+	uint32_t zahl = 0;
+	for( int verschiebung = 0; verschiebung < 35; verschiebung += 7){
+		int byte = m_datei.get();
+		if( byte == std::char_traits<char>::eof()){
+			throw std::runtime_error("Eingabe-Log hört mitten in einer Eingabe auf");
+		}
+		zahl |= (uint32_t)(byte & 0x7F) << verschiebung;
+		if( (byte & 0x80) == 0) return zahl;
+	}
+	throw std::runtime_error("Kaputte Zahl im Eingabe-Log");
+}
@@ -0,0 +1,77 @@
+/*
+ * Aufnehmen und Abspielen der Eingaben.
+ *
+ * Von außen kommt in unser Spiel nicht viel hinein:
+ * → wie lange ein Frame gedauert hat und wie spät es ist (die Uhr)
+ * → Mausklicks, aus denen neue Türme werden
+ * Alles andere rechnet die Welt daraus selber aus. Schreiben wir genau das
+ * mit, können wir ein Spiel später ohne Fenster und so schnell wie möglich
+ * noch einmal ablaufen lassen. Kommt dabei etwas anderes heraus, hat sich am
+ * Code etwas geändert.
+ *
+ * Die Datei ist binär und klein:
+ *   "TDEL" Version
+ *   dann pro Eingabe: Art, Tick (Abstand zum vorherigen), a, b
+ * Die Zahlen stehen als varint darin: 7 Bit pro Byte, das höchste Bit sagt
+ * "es kommt noch eins". Kleine Zahlen brauchen so nur ein Byte.
+ * Bei einem Frame ist a die Frame-Zeit und b die Uhrzeit, als Abstand zur
+ * letzten. Seit die Welt in festen Schritten rechnet, ist ein "Frame" hier
+ * ein Schritt, und a ist immer gleich. Bei einem Klick sind a und b die
+ * Koordinaten.
+ *
+ * Innerhalb eines Ticks kommen zuerst die Klicks, der Frame schließt den Tick
+ * ab. Genau wie in der Hauptschleife.
+ * */
+#ifndef AUFZEICHNUNG_H
+#define AUFZEICHNUNG_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+struct Eingabe{
+	enum class Art : uint8_t{
+		Frame = 1,
+		Klick = 2
+	};
+
+	Art art;
+	uint32_t tick;
+	int32_t a;
+	int32_t b;
+};
+
+class EingabeAufnahme {
+	public:
+		// Wirft, wenn die Datei nicht geschrieben werden kann.
+		explicit EingabeAufnahme( const std::string &pfad);
+
+		void klick( uint32_t tick, int x, int y);
+		void frame( uint32_t tick, int frameZeit, uint32_t jetzt);
+
+	private:
+		void schreibe( const Eingabe &e);
+		void schreibeZahl( uint32_t zahl);
+
+		std::ofstream m_datei;
+		uint32_t m_letzterTick = 0;
+		uint32_t m_letzteZeit = 0;
+};
+
+class EingabeWiedergabe {
+	public:
+		// Wirft, wenn die Datei fehlt oder kein Eingabe-Log ist.
+		explicit EingabeWiedergabe( const std::string &pfad);
+
+		// Liest die nächste Eingabe. false am Ende der Datei.
+		bool naechste( Eingabe &e);
+
+	private:
+		uint32_t leseZahl();
+
+		std::ifstream m_datei;
+		uint32_t m_letzterTick = 0;
+		uint32_t m_letzteZeit = 0;
+};
+
+#endif // AUFZEICHNUNG_H
@@ -0,0 +1,324 @@
+#include "Bewegung.h"
+#include "Flussfeld.h"
+#include "Pfad.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+// SSE2 und AVX2 gibt es nur auf x86. Die target-Attribute, mit denen wir
+// einzelne Funktionen für AVX2 übersetzen, kennen GCC und Clang.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TD_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define TD_X86_SIMD 0
+#endif
+
+namespace {
+
+// Wie schnell ist Einheit i? Die Tabelle der Arten ist klein und liegt nach
+// der ersten Einheit im Cache.
+inline double tempo( const BewegungsFelder &f, size_t i){
+	return f.arten[f.art[i]].geschwindigkeit;
+}
+
+// Ist die Einheit an ihrem Wegpunkt angekommen, geht es zum nächsten.
+inline void naechsterWegpunkt( const BewegungsFelder &f, size_t i, const WaypointList *wegpunkte){
+	if( wegpunkte != nullptr && f.wegpunktID[i] < wegpunkte->size()){
+		const Point &p = (*wegpunkte)[f.wegpunktID[i]];
+		f.zielX[i] = p[0];
+		f.zielY[i] = p[1];
+		++f.wegpunktID[i];
+	}
+}
+
+// Eine einzelne Einheit. Zeile für Zeile wie Einheit::update.
+inline void bewegeEine( const BewegungsFelder &f, size_t i, int frameZeit, const WaypointList *wegpunkte){
+	double wegX = f.zielX[i] - f.x[i];
+	double wegY = f.zielY[i] - f.y[i];
+
+	auto wegLaenge = std::sqrt( wegX*wegX + wegY*wegY);
+
+	auto derWeg = tempo(f, i) * frameZeit;
+	if( wegLaenge > derWeg){
+		auto scale = derWeg/wegLaenge;
+		wegX *= scale;
+		wegY *= scale;
+	}else{
+		naechsterWegpunkt(f, i, wegpunkte);
+	}
+
+	int iwegX = (int)std::floor(wegX);
+	int iwegY = (int)std::floor(wegY);
+	f.restX[i] += (wegX - iwegX);
+	f.restY[i] += (wegY - iwegY);
+
+	int restX = (int)std::floor(f.restX[i]);
+	int restY = (int)std::floor(f.restY[i]);
+	iwegX += restX;
+	iwegY += restY;
+	f.restX[i] -= restX;
+	f.restY[i] -= restY;
+
+	f.x[i] += iwegX;
+	f.y[i] += iwegY;
+}
+
+void bewegeSkalar( const BewegungsFelder &f, int frameZeit, const WaypointList *wegpunkte){
+	for( size_t i = 0; i < f.anzahl; ++i){
+		bewegeEine(f, i, frameZeit, wegpunkte);
+	}
+}
+
+#if TD_X86_SIMD
+
+/*
+ * Ein paar Kleinigkeiten, auf die wir achten müssen, damit das Gleiche wie
+ * in bewegeEine heraus kommt:
+ *
+ * → wegX ist dort (zielX - x) als int gerechnet und dann nach double
+ *   gewandelt. Bei ganzen Zahlen ist die Subtraktion in double aber exakt.
+ * → Statt dem if rechnen wir beide Fälle aus und nehmen pro Spur den
+ *   passenden. Wird nicht gekürzt, ist scale 1.0, und wegX*1.0 ist genau wegX.
+ * → (int)std::floor(v) und zurück nach double machen wir mit "abschneiden
+ *   und eins abziehen, wenn es zu groß war". Das gibt auch bei -0.0 genau die
+ *   +0.0, die beim Umweg über int entsteht.
+ * → Wer angekommen ist, bekommt seinen nächsten Wegpunkt danach einzeln. Das
+ *   ist selten, und die Bewegung in diesem Frame hängt ja noch am alten.
+ * */
+
+__attribute__((target("sse2")))
+inline __m128d floorSSE2( __m128d v){
+	__m128d t = _mm_cvtepi32_pd(_mm_cvttpd_epi32(v));
+	__m128d zuGross = _mm_cmpgt_pd(t, v);
+	return _mm_sub_pd(t, _mm_and_pd(zuGross, _mm_set1_pd(1.0)));
+}
+
+__attribute__((target("sse2")))
+inline __m128d ladeIntSSE2( const int *p){
+	return _mm_cvtepi32_pd(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+__attribute__((target("sse2")))
+void bewegeSSE2( const BewegungsFelder &f, int frameZeit, const WaypointList *wegpunkte){
+	const __m128d zeit = _mm_set1_pd(frameZeit);
+	const __m128d eins = _mm_set1_pd(1.0);
+
+	size_t i = 0;
+	for( ; i + 2 <= f.anzahl; i += 2){
+		__m128d x = ladeIntSSE2(f.x + i);
+		__m128d y = ladeIntSSE2(f.y + i);
+		__m128d wegX = _mm_sub_pd(ladeIntSSE2(f.zielX + i), x);
+		__m128d wegY = _mm_sub_pd(ladeIntSSE2(f.zielY + i), y);
+
+		__m128d wegLaenge = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(wegX, wegX), _mm_mul_pd(wegY, wegY)));
+		__m128d derWeg = _mm_mul_pd(_mm_set_pd(tempo(f, i + 1), tempo(f, i)), zeit);
+
+		__m128d kuerzen = _mm_cmpgt_pd(wegLaenge, derWeg);
+		__m128d scale = _mm_or_pd(
+				_mm_and_pd(kuerzen, _mm_div_pd(derWeg, wegLaenge)),
+				_mm_andnot_pd(kuerzen, eins));
+		wegX = _mm_mul_pd(wegX, scale);
+		wegY = _mm_mul_pd(wegY, scale);
+
+		__m128d iwegX = floorSSE2(wegX);
+		__m128d iwegY = floorSSE2(wegY);
+		__m128d restX = _mm_add_pd(_mm_loadu_pd(f.restX + i), _mm_sub_pd(wegX, iwegX));
+		__m128d restY = _mm_add_pd(_mm_loadu_pd(f.restY + i), _mm_sub_pd(wegY, iwegY));
+
+		__m128d ganzX = floorSSE2(restX);
+		__m128d ganzY = floorSSE2(restY);
+		_mm_storeu_pd(f.restX + i, _mm_sub_pd(restX, ganzX));
+		_mm_storeu_pd(f.restY + i, _mm_sub_pd(restY, ganzY));
+
+		x = _mm_add_pd(x, _mm_add_pd(iwegX, ganzX));
+		y = _mm_add_pd(y, _mm_add_pd(iwegY, ganzY));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(f.x + i), _mm_cvttpd_epi32(x));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(f.y + i), _mm_cvttpd_epi32(y));
+
+		int angekommen = ~_mm_movemask_pd(kuerzen) & 0x3;
+		for( int spur = 0; angekommen != 0; ++spur, angekommen >>= 1){
+			if( angekommen & 1) naechsterWegpunkt(f, i + spur, wegpunkte);
+		}
+	}
+
+	// Der Rest, der nicht mehr für ein ganzes Paar reicht.
+	for( ; i < f.anzahl; ++i){
+		bewegeEine(f, i, frameZeit, wegpunkte);
+	}
+}
+
+__attribute__((target("avx2")))
+inline __m256d floorAVX2( __m256d v){
+	__m256d t = _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(v));
+	__m256d zuGross = _mm256_cmp_pd(t, v, _CMP_GT_OQ);
+	return _mm256_sub_pd(t, _mm256_and_pd(zuGross, _mm256_set1_pd(1.0)));
+}
+
+__attribute__((target("avx2")))
+inline __m256d ladeIntAVX2( const int *p){
+	return _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+__attribute__((target("avx2")))
+void bewegeAVX2( const BewegungsFelder &f, int frameZeit, const WaypointList *wegpunkte){
+	const __m256d zeit = _mm256_set1_pd(frameZeit);
+	const __m256d eins = _mm256_set1_pd(1.0);
+
+	size_t i = 0;
+	for( ; i + 4 <= f.anzahl; i += 4){
+		__m256d x = ladeIntAVX2(f.x + i);
+		__m256d y = ladeIntAVX2(f.y + i);
+		__m256d wegX = _mm256_sub_pd(ladeIntAVX2(f.zielX + i), x);
+		__m256d wegY = _mm256_sub_pd(ladeIntAVX2(f.zielY + i), y);
+
+		__m256d wegLaenge = _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(wegX, wegX), _mm256_mul_pd(wegY, wegY)));
+		__m256d derWeg = _mm256_mul_pd(_mm256_set_pd(tempo(f, i + 3), tempo(f, i + 2),
+					tempo(f, i + 1), tempo(f, i)), zeit);
+
+		__m256d kuerzen = _mm256_cmp_pd(wegLaenge, derWeg, _CMP_GT_OQ);
+		__m256d scale = _mm256_blendv_pd(eins, _mm256_div_pd(derWeg, wegLaenge), kuerzen);
+		wegX = _mm256_mul_pd(wegX, scale);
+		wegY = _mm256_mul_pd(wegY, scale);
+
+		__m256d iwegX = floorAVX2(wegX);
+		__m256d iwegY = floorAVX2(wegY);
+		__m256d restX = _mm256_add_pd(_mm256_loadu_pd(f.restX + i), _mm256_sub_pd(wegX, iwegX));
+		__m256d restY = _mm256_add_pd(_mm256_loadu_pd(f.restY + i), _mm256_sub_pd(wegY, iwegY));
+
+		__m256d ganzX = floorAVX2(restX);
+		__m256d ganzY = floorAVX2(restY);
+		_mm256_storeu_pd(f.restX + i, _mm256_sub_pd(restX, ganzX));
+		_mm256_storeu_pd(f.restY + i, _mm256_sub_pd(restY, ganzY));
+
+		x = _mm256_add_pd(x, _mm256_add_pd(iwegX, ganzX));
+		y = _mm256_add_pd(y, _mm256_add_pd(iwegY, ganzY));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(f.x + i), _mm256_cvttpd_epi32(x));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(f.y + i), _mm256_cvttpd_epi32(y));
+
+		int angekommen = ~_mm256_movemask_pd(kuerzen) & 0xF;
+		for( int spur = 0; angekommen != 0; ++spur, angekommen >>= 1){
+			if( angekommen & 1) naechsterWegpunkt(f, i + spur, wegpunkte);
+		}
+	}
+
+	for( ; i < f.anzahl; ++i){
+		bewegeEine(f, i, frameZeit, wegpunkte);
+	}
+}
+
+#endif // TD_X86_SIMD
+
+}
+
+bool verfuegbar( Kern kern){
+	switch(kern){
+		case Kern::Skalar:
+			return true;
+#if TD_X86_SIMD
+		case Kern::SSE2:
+			return __builtin_cpu_supports("sse2");
+		case Kern::AVX2:
+			return __builtin_cpu_supports("avx2");
+#else
+		case Kern::SSE2:
+		case Kern::AVX2:
+			return false;
+#endif
+	}
+	return false;
+}
+
+Kern besterKern(){
+	if( verfuegbar(Kern::AVX2)) return Kern::AVX2;
+	if( verfuegbar(Kern::SSE2)) return Kern::SSE2;
+	return Kern::Skalar;
+}
+
+BewegungsKern kernFuer( Kern kern){
+	if( !verfuegbar(kern)){
+		throw std::runtime_error(std::string("Der Prozessor kann ") + name(kern) + " nicht");
+	}
+	switch(kern){
+#if TD_X86_SIMD
+		case Kern::SSE2:
+			return bewegeSSE2;
+		case Kern::AVX2:
+			return bewegeAVX2;
+#endif
+		default:
+			return bewegeSkalar;
+	}
+}
+
+const char *name( Kern kern){
+	switch(kern){
+		case Kern::Skalar: return "skalar";
+		case Kern::SSE2: return "sse2";
+		case Kern::AVX2: return "avx2";
+	}
+	return "?";
+}
+
+Kern kernAusName( const std::string &name){
+	if( name == "skalar") return Kern::Skalar;
+	if( name == "sse2") return Kern::SSE2;
+	if( name == "avx2") return Kern::AVX2;
+	throw std::runtime_error("Unbekannter Bewegungs-Kern: " + name);
+}
+
+void bewegeFluss( const BewegungsFelder &f, int frameZeit, const Flussfeld &feld){
+	for( size_t i = 0; i < f.anzahl; ++i){
+		// Die Strecke für diesen Frame. Was hinter dem Komma steht, kommt
+		// wieder in die restliche Bewegung, wie gehabt. Es geht ja immer nur
+		// waagerecht oder senkrecht, also reicht eine Zahl.
+		double weg = tempo(f, i) * frameZeit + f.restX[i];
+		int schritte = (int)std::floor(weg);
+		f.restX[i] = weg - schritte;
+
+		// Von Zelle zu Zelle, bis die Schritte aufgebraucht sind. Erst
+		// waagerecht, dann senkrecht. Liegt die Einheit genau auf dem Raster,
+		// ist eins davon immer 0.
+		while( schritte > 0){
+			if( f.x[i] == f.zielX[i] && f.y[i] == f.zielY[i]){
+				Point p = feld.naechstes(f.x[i], f.y[i]);
+				if( p[0] == f.x[i] && p[1] == f.y[i]){
+					// Am Ziel, oder es gibt keinen Weg. Stehen bleiben.
+					f.restX[i] = 0;
+					break;
+				}
+				f.zielX[i] = p[0];
+				f.zielY[i] = p[1];
+			}
+
+			int dx = f.zielX[i] - f.x[i];
+			int sx = std::min(std::abs(dx), schritte);
+			f.x[i] += dx < 0 ? -sx : sx;
+			schritte -= sx;
+
+			int dy = f.zielY[i] - f.y[i];
+			int sy = std::min(std::abs(dy), schritte);
+			f.y[i] += dy < 0 ? -sy : sy;
+			schritte -= sy;
+		}
+	}
+}
+
+void bewegePfad( const BewegungsFelder &f, double *strecke, int frameZeit, const Pfad &pfad){
+	// Erst nur die Strecke: eine Multiplikation und eine Addition pro
+	// Einheit. Am Ende des Pfades bleibt man stehen.
+	const double ende = pfad.laenge();
+	for( size_t i = 0; i < f.anzahl; ++i){
+		strecke[i] = std::min(ende, strecke[i] + tempo(f, i) * frameZeit);
+	}
+
+	// Dann, wo das auf dem Bildschirm ist. Für Raster und Türme brauchen wir
+	// die Pixel ja trotzdem.
+	for( size_t i = 0; i < f.anzahl; ++i){
+		Point p = pfad.punkt(strecke[i], f.wegpunktID[i]);
+		f.x[i] = p[0];
+		f.y[i] = p[1];
+	}
+}
@@ -0,0 +1,79 @@
+/*
+ * Die Bewegung der Einheiten.
+ *
+ * Das ist die Rechnung aus Einheit::update, aber für viele Einheiten auf
+ * einmal. Die Werte liegen so, wie sie der EinheitenPool hat: ein Array pro
+ * Eigenschaft.
+ *
+ * Es gibt sie in drei Ausführungen:
+ * → Skalar: eine Einheit nach der anderen, läuft überall
+ * → SSE2: zwei Einheiten auf einmal (jeder 64bit x86 Prozessor kann das)
+ * → AVX2: vier Einheiten auf einmal (neuere Prozessoren)
+ * Welche der Prozessor kann, wird beim Start gefragt.
+ *
+ * Alle drei rechnen mit den gleichen double-Operationen in der gleichen
+ * Reihenfolge. Wurzel, Division, Multiplikation und Addition sind in IEEE 754
+ * exakt gerundet, also kommt auf den Pixel (und sogar auf das letzte Bit der
+ * Restbewegung) das Gleiche heraus. Dafür darf der Kompiler aber kein a*b+c zu
+ * einem FMA zusammenziehen, siehe -ffp-contract=off in CMakeLists.txt.
+ * */
+#ifndef BEWEGUNG_H
+#define BEWEGUNG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Einheit.h"
+#include "Arten.h"
+
+// Zeiger auf die Arrays des Pools. Alle sind 'anzahl' lang, nur 'arten' ist
+// die Tabelle, in die 'art' zeigt. Von dort kommt die Geschwindigkeit.
+struct BewegungsFelder{
+	int *x;
+	int *y;
+	double *restX;
+	double *restY;
+	const Arten::Nummer *art;
+	const EinheitenArt *arten;
+	int *zielX;
+	int *zielY;
+	uint32_t *wegpunktID;
+	size_t anzahl;
+};
+
+enum class Kern{
+	Skalar,
+	SSE2,
+	AVX2
+};
+
+typedef void (*BewegungsKern)( const BewegungsFelder &felder, int frameZeit, const WaypointList *wegpunkte);
+
+// Kann dieser Prozessor den Kern ausführen?
+bool verfuegbar( Kern kern);
+
+// Der schnellste Kern, den dieser Prozessor kann.
+Kern besterKern();
+
+BewegungsKern kernFuer( Kern kern);
+
+const char *name( Kern kern);
+
+// "skalar", "sse2" oder "avx2". Wirft bei allem anderen.
+Kern kernAusName( const std::string &name);
+
+class Flussfeld;
+class Pfad;
+
+// Bewegt die Einheiten über das Flussfeld statt über die Wegpunkte (siehe
+// Flussfeld.h). Ohne Wurzel: es geht immer nur waagerecht oder senkrecht zur
+// nächsten Zelle. Darum gibt es davon auch nur die eine Ausführung.
+void bewegeFluss( const BewegungsFelder &felder, int frameZeit, const Flussfeld &feld);
+
+// Bewegt die Einheiten auf dem Pfad (siehe Pfad.h). 'strecke' ist pro Einheit
+// die schon gelaufene Strecke, wegpunktID der gemerkte Abschnitt. Restbewegung
+// und Ziel werden nicht gebraucht.
+void bewegePfad( const BewegungsFelder &felder, double *strecke, int frameZeit, const Pfad &pfad);
+
+#endif // BEWEGUNG_H
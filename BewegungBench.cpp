@@ -0,0 +1,207 @@
+/*
+ * Ein kleines Programm nur für die Bewegungs-Kerne.
+ *
+ * Zuerst wird geprüft, ob alle Kerne, die der Prozessor kann, genau das
+ * Gleiche ausrechnen wie Einheit::update. Stimmt auch nur ein Pixel nicht,
+ * endet das Programm mit 1.
+ * Danach wird jeder Kern für sich gemessen, und zum Vergleich die Bewegung
+ * auf dem Pfad (siehe Pfad.h).
+ *
+ *   TD_Bench_Bewegung [einheiten] [frames]
+ * */
+#include "Bewegung.h"
+#include "EinheitenPool.h"
+#include "Pfad.h"
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <vector>
+#include <chrono>
+#include <random>
+
+namespace {
+
+const Kern alleKerne[] = {Kern::Skalar, Kern::SSE2, Kern::AVX2};
+
+// Der gleiche Weg wie im Spiel, siehe erstelleWegpunkte in Welt.cpp.
+WaypointListZeiger wegpunkteAnlegen(){
+	return std::make_shared<WaypointList>(WaypointList{
+			{{0, 0}}, {{1024-32, 0}}, {{0, 768-32}}, {{1024-32, 768-32}}, {{0, 0}}});
+}
+
+// Verschiedene Frame-Zeiten, auch 0 und sehr lange Frames.
+const int frameZeiten[] = {0, 1, 1, 2, 5, 16, 33, 100, 250, 1000};
+
+// Alle Arrays, die ein Kern braucht, zum selber Befüllen. Die
+// Geschwindigkeiten kommen aus ein paar Arten, siehe Arten.h.
+struct Felder{
+	std::vector<int> x, y, zielX, zielY;
+	std::vector<double> restX, restY;
+	std::vector<Arten::Nummer> art;
+	std::vector<uint32_t> wegpunktID;
+	Arten arten;
+
+	BewegungsFelder zeiger(){
+		return {x.data(), y.data(), restX.data(), restY.data(), art.data(), arten.einheiten(),
+			zielX.data(), zielY.data(), wegpunktID.data(), x.size()};
+	}
+
+	bool operator==( const Felder &f) const{
+		// Bitgenau, auch die Restbewegung.
+		return x == f.x && y == f.y && zielX == f.zielX && zielY == f.zielY
+			&& wegpunktID == f.wegpunktID
+			&& std::memcmp(restX.data(), f.restX.data(), restX.size() * sizeof(double)) == 0
+			&& std::memcmp(restY.data(), f.restY.data(), restY.size() * sizeof(double)) == 0;
+	}
+};
+
+Felder zufaelligeFelder( size_t anzahl, const WaypointList &wegpunkte, std::minstd_rand &zufall){
+	std::uniform_int_distribution<int> pos(-200, 1200);
+	std::uniform_real_distribution<double> rest(0.0, 1.0);
+	std::uniform_real_distribution<double> tempo(0.01, 5.0);
+	Felder f;
+	for( int n = 0; n < 64; ++n){
+		EinheitenArt a;
+		a.geschwindigkeit = tempo(zufall);
+		f.arten.neueEinheit(std::to_string(n), a);
+	}
+	for( size_t i = 0; i < anzahl; ++i){
+		f.x.push_back(pos(zufall));
+		f.y.push_back(pos(zufall));
+		f.restX.push_back(rest(zufall));
+		f.restY.push_back(rest(zufall));
+		f.art.push_back(zufall() % f.arten.anzahlEinheiten());
+		uint32_t id = zufall() % (wegpunkte.size() + 1);
+		const Point &ziel = wegpunkte[id == 0 ? 0 : id - 1];
+		f.zielX.push_back(ziel[0]);
+		f.zielY.push_back(ziel[1]);
+		f.wegpunktID.push_back(id);
+	}
+	return f;
+}
+
+// Einheit::update gegen den EinheitenPool mit jedem Kern.
+// Ungerade Anzahl, damit auch der Rest hinter den vollen SIMD-Blöcken dran
+// kommt.
+bool pruefeGegenEinheit( Kern kern){
+	auto wegpunkte = wegpunkteAnlegen();
+	std::minstd_rand zufall(42);
+
+	Einheit vorlage;
+	vorlage.init(nullptr, {0,0,32,32});
+	vorlage.setzeWegpunkte(wegpunkte);
+
+	// Die Vorlage hat die Werte der Art "gegner".
+	const Arten arten = Arten::standard();
+	std::vector<Einheit> einheiten;
+	EinheitenPool pool;
+	pool.setzeArten(&arten);
+	pool.setzeKern(kern);
+	for( int n = 0; n < 1003; ++n){
+		Einheit e{vorlage};
+		e.init(nullptr, {(int)(zufall() % 1400) - 200, (int)(zufall() % 1100) - 200, 32, 32});
+		einheiten.push_back(e);
+		pool.fuegeHinzu(e);
+	}
+
+	for( int frame = 0; frame < 5000; ++frame){
+		int frameZeit = frameZeiten[zufall() % (sizeof(frameZeiten) / sizeof(int))];
+		for( auto &e:einheiten) e.update(frameZeit);
+		pool.bewege(frameZeit);
+
+		for( size_t i = 0; i < einheiten.size(); ++i){
+			if( einheiten[i].getPosition() != pool.getPosition(i)){
+				std::cerr << "[" << name(kern) << "] Frame " << frame << ", Einheit " << i
+					<< ": " << pool.getPosition(i)[0] << "," << pool.getPosition(i)[1]
+					<< " statt " << einheiten[i].getPosition()[0] << "," << einheiten[i].getPosition()[1]
+					<< std::endl;
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Der Kern gegen den skalaren Kern, mit zufälligen Geschwindigkeiten.
+bool pruefeGegenSkalar( Kern kern){
+	auto wegpunkte = wegpunkteAnlegen();
+	std::minstd_rand zufall(7);
+
+	Felder referenz = zufaelligeFelder(1001, *wegpunkte, zufall);
+	Felder felder = referenz;
+
+	auto skalar = kernFuer(Kern::Skalar);
+	auto kandidat = kernFuer(kern);
+	for( int frame = 0; frame < 5000; ++frame){
+		int frameZeit = frameZeiten[zufall() % (sizeof(frameZeiten) / sizeof(int))];
+		skalar(referenz.zeiger(), frameZeit, wegpunkte.get());
+		kandidat(felder.zeiger(), frameZeit, wegpunkte.get());
+		if( !(felder == referenz)){
+			std::cerr << "[" << name(kern) << "] weicht in Frame " << frame
+				<< " vom skalaren Kern ab" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+}
+
+int main( int argc, char **argv){
+	size_t anzahl = argc > 1 ? std::stoul(argv[1]) : 100000;
+	int frames = argc > 2 ? std::stoi(argv[2]) : 1000;
+
+	bool allesGleich = true;
+	for( auto kern:alleKerne){
+		if( !verfuegbar(kern)){
+			std::cout << "[BENCH] " << name(kern) << ": nicht verfügbar" << std::endl;
+			continue;
+		}
+		bool gleich = pruefeGegenEinheit(kern) && pruefeGegenSkalar(kern);
+		std::cout << "[BENCH] " << name(kern) << ": "
+			<< (gleich ? "gleich wie Einheit::update" : "FALSCH") << std::endl;
+		allesGleich = allesGleich && gleich;
+	}
+	if( !allesGleich) return 1;
+
+	// Jeder Kern bekommt die gleichen Startwerte.
+	auto wegpunkte = wegpunkteAnlegen();
+	std::minstd_rand zufall(42);
+	const Felder start = zufaelligeFelder(anzahl, *wegpunkte, zufall);
+
+	std::cout << "[BENCH] " << anzahl << " Einheiten, " << frames << " Frames" << std::endl;
+	for( auto kern:alleKerne){
+		if( !verfuegbar(kern)) continue;
+		Felder felder = start;
+		auto bewege = kernFuer(kern);
+
+		auto vorher = std::chrono::steady_clock::now();
+		for( int frame = 0; frame < frames; ++frame){
+			bewege(felder.zeiger(), 1, wegpunkte.get());
+		}
+		auto dauer = std::chrono::steady_clock::now() - vorher;
+
+		std::cout << "[BENCH] " << name(kern) << ": "
+			<< std::chrono::duration<double, std::nano>(dauer).count() / (double(anzahl) * frames)
+			<< " ns pro Einheit" << std::endl;
+	}
+
+	// Auf dem Pfad merkt sich jede Einheit nur noch ihre Strecke.
+	Pfad pfad(*wegpunkte);
+	Felder felder = start;
+	std::uniform_real_distribution<double> irgendwo(0.0, pfad.laenge());
+	std::vector<double> strecke;
+	for( size_t i = 0; i < anzahl; ++i) strecke.push_back(irgendwo(zufall));
+
+	auto vorher = std::chrono::steady_clock::now();
+	for( int frame = 0; frame < frames; ++frame){
+		bewegePfad(felder.zeiger(), strecke.data(), 1, pfad);
+	}
+	auto dauer = std::chrono::steady_clock::now() - vorher;
+	std::cout << "[BENCH] pfad: "
+		<< std::chrono::duration<double, std::nano>(dauer).count() / (double(anzahl) * frames)
+		<< " ns pro Einheit" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,139 @@
+#include "Bildfang.h"
+#include "Logbuch.h"
+
+#include <SDL_image.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+Bildfang::Bildfang( const std::string &verzeichnis, Bildformat format, int breite, int hoehe,
+		bool warten, size_t puffer)
+	: m_verzeichnis(verzeichnis)
+	, m_format(format)
+	, m_breite(breite)
+	, m_hoehe(hoehe)
+	, m_warten(warten)
+{
+	if( puffer == 0) throw std::runtime_error("Der Bildfang braucht mindestens einen Puffer");
+	if( format == Bildformat::Png && (IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG) == 0){
+		throw std::runtime_error(std::string("Kann kein PNG schreiben: ") + IMG_GetError());
+	}
+
+	// Der ganze Speicher jetzt, beim Fangen wird keiner mehr geholt.
+	m_puffer.resize(puffer);
+	for( auto &p:m_puffer) p.pixel.resize((size_t)breite * hoehe * 4);
+
+	m_thread = std::thread(&Bildfang::arbeite, this);
+}
+
+Bildfang::~Bildfang(){
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_aufhoeren = true;
+	}
+	m_neu.notify_one();
+	m_thread.join();
+}
+
+bool Bildfang::fange( SDL_Renderer *renderer, long nummer){
+	auto vorher = std::chrono::steady_clock::now();
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if( m_zumFuellen - m_zumSchreiben == m_puffer.size()){
+			if( !m_warten){
+				++m_verworfen;
+				return false;
+			}
+			m_frei.wait(lock, [this]{ return m_zumFuellen - m_zumSchreiben < m_puffer.size(); });
+		}
+	}
+
+	// Diesen Puffer fasst der Thread erst an, wenn m_zumFuellen weiter ist.
+	// Es gibt nur einen, der fängt, also brauchen wir hier keinen Mutex.
+	Puffer &p = m_puffer[m_zumFuellen % m_puffer.size()];
+	p.nummer = nummer;
+	if( SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_RGBA32, p.pixel.data(), m_breite * 4) != 0){
+		throw std::runtime_error(std::string("Kann das Bild nicht lesen: ") + SDL_GetError());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_zumFuellen;
+		++m_gefangen;
+		m_mikrosekunden += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - vorher).count();
+	}
+	m_neu.notify_one();
+	return true;
+}
+
+void Bildfang::warte(){
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_frei.wait(lock, [this]{ return m_zumSchreiben == m_zumFuellen; });
+}
+
+uint64_t Bildfang::geschrieben() const{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_geschrieben;
+}
+
+uint64_t Bildfang::verworfen() const{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_verworfen;
+}
+
+double Bildfang::mikrosekundenProBild() const{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_gefangen > 0 ? m_mikrosekunden / m_gefangen : 0.0;
+}
+
+void Bildfang::arbeite(){
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for( ;;){
+		m_neu.wait(lock, [this]{ return m_aufhoeren || m_zumSchreiben < m_zumFuellen; });
+		if( m_zumSchreiben == m_zumFuellen) return;	// Alles geschrieben, und Schluss
+
+		// Geschrieben wird ohne Mutex, so lange kann fange() weiter
+		// fangen.
+		const Puffer &p = m_puffer[m_zumSchreiben % m_puffer.size()];
+		lock.unlock();
+		schreibe(p);
+		lock.lock();
+
+		++m_zumSchreiben;
+		++m_geschrieben;
+		m_frei.notify_all();
+	}
+}
+
+void Bildfang::schreibe( const Puffer &p){
+	char name[32];
+	std::snprintf(name, sizeof(name), "/bild_%06ld.%s", p.nummer, m_format == Bildformat::Png ? "png" : "ppm");
+	const std::string datei = m_verzeichnis + name;
+
+	if( m_format == Bildformat::Png){
+		SDL_Surface *bild = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint8_t*>(p.pixel.data()),
+				m_breite, m_hoehe, 32, m_breite * 4, SDL_PIXELFORMAT_RGBA32);
+		if( bild == nullptr || IMG_SavePNG(bild, datei.c_str()) != 0){
+			TD_LOG(LogBereich::Spiel, LogStufe::Fehler, 1, "Kann Bild {} nicht als PNG schreiben", p.nummer);
+		}
+		SDL_FreeSurface(bild);
+		return;
+	}
+
+	// PPM: "P6", Breite, Höhe, größter Wert, dann RGB ohne Alpha.
+	std::ofstream aus(datei, std::ios::binary);
+	aus << "P6\n" << m_breite << " " << m_hoehe << "\n255\n";
+	std::vector<char> zeile((size_t)m_breite * 3);
+	for( int y = 0; y < m_hoehe; ++y){
+		const uint8_t *rgba = p.pixel.data() + (size_t)y * m_breite * 4;
+		for( int x = 0; x < m_breite; ++x){
+			zeile[x*3 + 0] = (char)rgba[x*4 + 0];
+			zeile[x*3 + 1] = (char)rgba[x*4 + 1];
+			zeile[x*3 + 2] = (char)rgba[x*4 + 2];
+		}
+		aus.write(zeile.data(), zeile.size());
+	}
+	if( !aus) TD_LOG(LogBereich::Spiel, LogStufe::Fehler, 1, "Kann Bild {} nicht als PPM schreiben", p.nummer);
+}
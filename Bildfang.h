@@ -0,0 +1,97 @@
+/*
+ * Der Bildfang.
+ *
+ * Ohne Fenster zeichnet Headless mit --zeichnen in ein Bild im Speicher
+ * (siehe Leinwand in Headless.cpp). Gesehen hat das bisher keiner. Für
+ * Vergleichsbilder (sieht Frame 500 noch genau so aus wie gestern?) und um
+ * zu messen, wie viele Bilder pro Sekunde wir schaffen, sollen die Bilder
+ * auch in Dateien landen.
+ *
+ * Eine PNG-Datei zu schreiben dauert aber viel länger als ein Frame. Also
+ * kopiert fange() das fertige Bild nur in einen von ein paar Puffern, die
+ * schon beim Anlegen geholt werden, und kehrt sofort zurück. Ein eigener
+ * Thread nimmt sich die Puffer der Reihe nach und schreibt sie als PNG oder
+ * als PPM (ein kurzer Kopf, dann die Pixel roh) in das Verzeichnis.
+ *
+ * Sind alle Puffer voll, weil das Schreiben nicht hinterherkommt, wird das
+ * Bild verworfen und gezählt, die Simulation wartet nicht. Für
+ * Vergleichsbilder darf aber keines fehlen. Mit 'warten' wartet fange()
+ * dann doch, bis ein Puffer frei ist.
+ * */
+#ifndef BILDFANG_H
+#define BILDFANG_H
+
+#include <SDL.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class Bildformat{
+	Png,
+	Ppm
+};
+
+class Bildfang {
+	public:
+		// Die Bilder kommen als bild_000042.png (oder .ppm) nach
+		// 'verzeichnis', das es schon geben muss.
+		Bildfang( const std::string &verzeichnis, Bildformat format, int breite, int hoehe,
+				bool warten = false, size_t puffer = 8);
+
+		// Schreibt noch alles, was schon gefangen wurde.
+		~Bildfang();
+
+		Bildfang( const Bildfang&) = delete;
+		Bildfang& operator=( const Bildfang&) = delete;
+
+		// Kopiert das Bild von 'renderer' in einen freien Puffer. Gibt false
+		// zurück, wenn es verworfen wurde.
+		bool fange( SDL_Renderer *renderer, long nummer);
+
+		// Wartet, bis alle gefangenen Bilder geschrieben sind.
+		void warte();
+
+		uint64_t geschrieben() const;
+		uint64_t verworfen() const;
+
+		// Wie lange fange() im Schnitt gebraucht hat.
+		double mikrosekundenProBild() const;
+
+	private:
+		struct Puffer{
+			std::vector<uint8_t> pixel;
+			long nummer;
+		};
+
+		void arbeite();
+		void schreibe( const Puffer &p);
+
+		const std::string m_verzeichnis;
+		const Bildformat m_format;
+		const int m_breite;
+		const int m_hoehe;
+		const bool m_warten;
+
+		// Ein Ring: fange() füllt m_puffer[m_zumFuellen % n], der Thread
+		// schreibt m_puffer[m_zumSchreiben % n]. Dazwischen liegen die vollen.
+		std::vector<Puffer> m_puffer;
+		uint64_t m_zumSchreiben = 0;
+		uint64_t m_zumFuellen = 0;
+
+		uint64_t m_geschrieben = 0;
+		uint64_t m_verworfen = 0;
+		uint64_t m_gefangen = 0;
+		double m_mikrosekunden = 0;
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_neu;		// Für den Thread
+		std::condition_variable m_frei;		// Für fange() und warte()
+		bool m_aufhoeren = false;
+		std::thread m_thread;
+};
+
+#endif // BILDFANG_H
@@ -0,0 +1,419 @@
+/*
+ * Die Einheit wohnt jetzt in ihrer eigenen Datei.
+ * So können sowohl das Spiel mit Fenster (main.cpp) als auch der Headless-Modus
+ * (Headless.cpp) die gleiche Einheit nutzen.
+ * */
+#ifndef EINHEIT_H
+#define EINHEIT_H
+
+#include <SDL.h>
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Für ein paar Mathefunktionen
+#include <cmath>
+
+#include "SpriteBatch.h"
+#include "Schnappschuss.h"
+#include "Arten.h"
+
+/*
+ * Was wollen wir...
+ * → Einheiten bewegen
+ * Dazu brauchen wir:
+ * → eine Bewegung pro Frame
+ * → eine "Einheit"
+ * → ein Weg
+ *
+ * Egal wie viele Frames man pro Sekunde hat, soll sich eine Einheit gleich
+ * bewegen. Die Bewegung muss also Abhängig von den Frames je Sekunde sein.
+ * Je mehr FPS, desto kleinere Schritte.
+ *
+ * Jetzt basteln wir uns eine Einheit.
+ * Das wird eine eigene Klasse.
+ * → Update soll jeden Frame aufgerufen werden und die Position neu berechnen
+ * → Draw soll die Einheit zeichnen
+ * Beide müssen public sein, damit sie von außen aufgerufen werden können.
+ *
+ * Erstmal haben wir einen ziemlich einfachen Weg. Er geht nur von 0,0 nach
+ * 1024,768.
+ * Es wäre aber praktisch, wenn wir einen beliebigen Weg laufen könnten. Immer
+ * in Teilabschnitte - versteht sich.
+ * Waypoints machen sich da nicht schlecht.
+ * Wir brauchen also eine Liste von Wegpunkten.
+ * Und dann laufen wir diese ab.
+ * Viele Einheiten sollen später auf dem gleichen Weg laufen. Also ist es
+ * besser, wie auch bei der Texture, dass die Einheiten sich die Wegpunkte
+ * teilen. 
+ * Die Einheit muss also nur wissen:
+ * → Wo ist die Liste mit Wegpunkten
+ * → Wo ist mein nächster Punkt
+ * 
+ * Gut. Das wäre das.
+ * */
+
+/*
+ * Faulheit!
+ * Wir erstellen ein paar Synonyme.
+ * Es ist kürzer einfach 'Point' als Type zu verwenden, als dieses std::array...
+ * Auch der Zeiger würde ausgeschrieben um einiges länger sein, und ggf. etwas
+ * unverständlich. So kann man dem Typ auch eine kleine Bedeutung anhängen.
+ * */
+typedef std::array<int, 2> Point;
+typedef std::vector<Point> WaypointList;
+typedef std::shared_ptr<WaypointList> WaypointListZeiger;
+
+// Der shared_ptr ist ein Konstrukt, der im Prinzip ein * Zeiger ist.
+// Er sorgt aber dafür, dass, sobald keiner mehr den Zeiger verwendet, dieser
+// gelöscht wird. Man muss also nicht acht geben, wann man wohlmöglich ein
+// 'delete' setzen müsste. 
+
+class Einheit {
+	public:
+        // Hier sind wir richtig.
+		// Es gibt ein paar kleine Methoden für eine Klasse, die an speziellen
+		// Orten aufgerufen werden. 
+		// Man kenn sie als Konstruktoren
+		// Es gibt ein paar davon.
+		// Gerade interessieren wir uns für den Copy-Constructor
+		// Mit diesem sehen wir, dass wir unten in die Liste nicht das Objekt
+		// selber, sondern eine Kopie davon reinstecken.
+		//
+		// C++ baut automatisch diese Konstruktoren, wenn er es kann.
+		// Da wir nichts "seltsames" nutzen, hat uns C++ die Konstruktoren
+		// passend eingesetzt.
+		// Jetzt bauen wir uns einen eigenen.
+		// 
+		// Kopierkonstruktor
+		// Wir erstellen also eine Kopie. Von einem Objekt, dass vom gleichen
+		// Typ ist.
+		//
+		// Früher stand hier ein eigener, der einfach jeden Wert übernommen
+		// hat. Genau das macht der von C++ auch. Aber: sobald es einen
+		// eigenen Kopierkonstruktor gibt, baut C++ keinen Move-Konstruktor
+		// mehr. Wächst dann ein std::vector<Einheit>, wird jede Einheit
+		// kopiert statt verschoben. Beim shared_ptr auf die Wegpunkte heißt
+		// das jedes Mal: Zähler hoch (atomar, also teuer), und für die alte
+		// Einheit wieder runter.
+		//
+		// Also sagen wir C++ ausdrücklich, dass es alle selber bauen soll.
+		// Ein Move-Konstruktor "klaut" die Werte der anderen Einheit. Der
+		// shared_ptr wird dabei nur umgehängt, gezählt wird nichts.
+		// (Die Einheit, aus der verschoben wurde, darf man danach nur noch
+		// zerstören oder neu zuweisen.)
+		Einheit( const Einheit &einheit) = default;
+		Einheit( Einheit &&einheit) = default;
+		Einheit &operator=( const Einheit &einheit) = default;
+		Einheit &operator=( Einheit &&einheit) = default;
+
+		// Das hier ist der ganz normale Konstruktor.
+		// Er wird aufgerufen bei zB: 
+		//		Einheit e;
+		Einheit(){
+			//std::clog << "[Einheit] Konstruktor" << std::endl;
+		};
+
+		// Wir geben nichts zurück.
+		// Aber wir brauchen die Information, wie viel Zeit für den Frame
+		// verstrichen ist. Je größer die Zeit, desto weiter müssen wir uns
+		// bewegen. Heißt aber auch, dass nur wenig FPS da sein werden.
+		// Sind viele FPS da, wird die Zeit pro Frame kleiner, und wir bewegen
+		// uns in kleineren Schritten.
+		void update( int frameZeit){
+
+			// In m_rect steckt x und y, welche wir nutzen können um zu sagen,
+			// an welcher Position wir sind und die Texture zeichnen wollen
+			//
+			// Wir sind an x,y und wollen zum Ziel.
+			// Nehmen wir Vektoren.
+			// Ziel - Anfang == Weg
+			//
+			// Wir brauche double für die weiteren Berechnungen. 
+
+			double wegX = m_naechsterWegpunkt[0] - m_rect.x;
+			double wegY = m_naechsterWegpunkt[1] - m_rect.y;
+
+            // Wir sollen insgesamt eine Stecke ablaufen von ?
+			// Das dürfte der Betrag des Insgesamtweg Vektors sein
+			// also von 0,0 nach 1024,768
+			// Vektorrechnung!
+			// Die Wurzel aus a² + b²
+			//auto gesamtWeg = std::sqrt( 1024*1024 + 768*768);
+
+			// Den Weg in 3 Sekunden, also 3000ms
+			// das sind dann also 
+			// 4.2666667
+			//auto pixelProSekunde = gesamtWeg / (m_speed * 1000);
+
+
+            // Unser restlicher Weg ist mit wegX,Y gegeben.
+			// Wie lang ist dieser?
+			auto wegLaenge = std::sqrt( wegX*wegX + wegY*wegY);
+			
+
+			// Ist der Weg größer, als das, was wir innerhalb der Zeit schaffen
+			// würden, dann dürfen wir nicht soweit gehen.
+			// Pro MS dürfen wir maximal 4 Pixel gehen. Das legen wir jetzt
+			// einfach so fest. 
+			// Wir werden pro Frame nicht immer genau eine Millisekunde Zeit
+			// haben. Also können wir auch nicht immer nur maximal 4 Schritte
+			// gehen. Haben wir mehr Zeit gebraucht, gehen wir weiter. Wir
+			// müssen also die 4 mit der Zeit für einen Frame multiplizieren.
+			// Speed ist zur Zeit die angabe, wie lange die Einheit für einen
+			// "Streckenabschnitt" benötigen darf. 1 heißt 1Sekunde, 5 sind 5
+			// Sekunden.
+			// Besser ist eine Geschwindigkeit in Pixel pro Millisekunde.
+			//  s = v*t --- weg ist geschwindigkeit * zeit
+			// Je kleiner die Geschwindigkeit desto kürzer der Weg in gleicher
+			// Zeit.
+			//
+			auto derWeg = m_geschwindigkeit * frameZeit;
+			if( wegLaenge > derWeg){
+				// Ist der Weg zu lang, dann kürzen wir ihn soweit, dass es
+				// genau 4 Pixel werden.
+				auto scale = derWeg/wegLaenge;
+				wegX *= scale;
+				wegY *= scale;
+			}else{
+				// Wir schaffen des letzten Rest in einem Zug!
+				// Wir können also uns danach auf den nächsten Wegpunkt stürzen
+				// Vorher müssen wir aber feststellen, ob es noch einen nächsten
+				// Wegpunkt gibt oder ob wir schon am Ziel sind.
+				if( m_naechsterWegpunktID < m_alleWegpunkte->size()){
+					m_naechsterWegpunkt = m_alleWegpunkte->at( m_naechsterWegpunktID);
+					++m_naechsterWegpunktID;
+				}
+			}
+
+			// Was hinter dem Komma kommt, das schmeißen wir mit in die
+			// restliche Bewegung rein.
+			int iwegX = (int)std::floor(wegX);
+			int iwegY = (int)std::floor(wegY);
+			m_restBewegung[0] += (wegX - iwegX);
+			m_restBewegung[1] += (wegY - iwegY);
+
+
+			// Ist die restliche Bewegung größer gleich einem Pixel auf einer
+			// Achse, dann nehmen wir den Pixel und packen ihn zu der Bewegung
+			// mit hinzu.
+			int restX = (int)std::floor(m_restBewegung[0]);
+			int restY = (int)std::floor(m_restBewegung[1]);
+			iwegX += restX;
+			iwegY += restY;
+			m_restBewegung[0] -= restX;
+			m_restBewegung[1] -= restY;
+
+
+
+			// pro Millisekunde also 4.266 Pixel
+			// Schwierig. Es gibt selten Pixel, die kleiner 1 sind ;-)
+			//
+			// Die Pixel, die wir gehen dürfen, bewegen wir uns jetzt weiter.
+			//
+
+			m_rect.x += iwegX;
+			m_rect.y += iwegY;
+		
+		}
+
+		// Wir geben auch hier nichts zurück.
+		// Aber wir müssen wissen, wo wir die Einheit hinmalen sollen, auf
+		// welchen renderer. Deswegen übergeben wir diesen.
+		// In der Main-Funktion liegt der renderer schon in einem Zeiger, also
+		// nutzen wir das und verlangen hier auch einfach einen Zeiger.
+		//
+		// Wir kopieren die Texture an die passende Stelle auf die
+		// Render-Fläche. Das haben wir ja schon weiter unten im Code gemacht.
+		void draw(SDL_Renderer *renderer){
+			SDL_RenderCopy(renderer, m_texture, quelle(), &m_rect);
+		}
+
+		// Irgendwoher müssen wir ja unsere Texture bekommen. In dem Fall
+		// übergeben und setzen wir sie hier.
+		// Diese Methode muss dann aber auch vor dem ersten draw aufgerufen
+		// werden!
+		// In der  Texture steckt die Größe nicht drin, also müssen wir die auch
+		// noch erfahren.
+		void init( SDL_Texture *texture, SDL_Rect rect){
+			m_texture = texture;
+			m_rect.x = rect.x;
+			m_rect.y = rect.y;
+			m_rect.w = rect.w;
+			m_rect.h = rect.h;
+		}
+
+		// Oder als Einheit einer Art (siehe Arten.h). Von dort kommen Bild,
+		// Größe, Geschwindigkeit und Leben. Im EinheitenPool bleibt davon
+		// nur die Nummer der Art.
+		void init( const Arten &arten, Arten::Nummer art, int x, int y){
+			if( art >= arten.anzahlEinheiten()){
+				throw std::runtime_error("Die Einheit mit Nummer " + std::to_string(art) + " gibt es nicht");
+			}
+			const EinheitenArt &a = arten.einheit(art);
+			m_art = art;
+			m_texture = a.texture;
+			m_quelle = a.quelle;
+			m_rect = {x, y, a.breite, a.hoehe};
+			m_geschwindigkeit = a.geschwindigkeit;
+			m_leben = a.leben;
+		}
+
+
+		// wir setzen die Liste der Wegpunkte
+		void setzeWegpunkte( WaypointListZeiger wegpunkte){
+			m_alleWegpunkte = wegpunkte;
+
+			// Wir haben die Liste.
+			// Also setzten wir doch gleich das erste Ziel
+			m_naechsterWegpunkt = m_alleWegpunkte->at(0);
+			m_naechsterWegpunktID = 1;
+		}
+
+
+		// An sich könnten wir so neue Wegpunkte in die Liste einfügen. Aber
+		// hier brauchen wir das nicht.
+		//void hinzufuegenWegpunkte( WaypointListZeiger wegpunkte){
+			//m_alleWegpunkte->insert(m_alleWegpunkte->end(), wegpunkte->begin(), wegpunkte->end());
+		//}
+		
+        Point getPosition() const{
+			return {{m_rect.x, m_rect.y}};
+		}
+
+		const WaypointListZeiger &getWegpunkte() const{
+			return m_alleWegpunkte;
+		}
+
+		Arten::Nummer getArt() const{ return m_art; }
+
+		int getBreite() const{ return m_rect.w; }
+		int getHoehe() const{ return m_rect.h; }
+
+
+		// Wir wurden getoffen!
+		// Unser Leben sinkt...
+		// Sind wir tot, leben <= 0, dann ist es vorbei
+		bool gotHit(int damage){
+			m_leben -= damage;
+			return m_leben <= 0;
+		}
+
+		// Alles außer Texture und Wegpunkten, siehe Schnappschuss.h.
+		// Alle Felder von Zustand sind benannt, mit {} also alle 0. Gleiche
+		// Einheiten ergeben so auch die gleichen Bytes.
+		void speichere( Schnappschuss::Schreiber &s) const{
+			static_assert(sizeof(Zustand) == 88, "Im Zustand einer Einheit sollen keine Lücken sein");
+			Zustand z{};
+			z.rect = m_rect;
+			z.quelle = m_quelle;
+			z.zielPosition = m_zielPosition;
+			z.restBewegung = m_restBewegung;
+			z.geschwindigkeit = m_geschwindigkeit;
+			z.naechsterWegpunktID = m_naechsterWegpunktID;
+			z.naechsterWegpunkt = m_naechsterWegpunkt;
+			z.leben = m_leben;
+			z.art = m_art;
+			s.wert(z);
+		}
+
+		// Die Texture bleibt, wie sie ist. Die Wegpunkte kommen von außen,
+		// damit sich alle Einheiten wieder die gleiche Liste teilen.
+		void lade( Schnappschuss::Leser &l, WaypointListZeiger wegpunkte){
+			Zustand z = l.wert<Zustand>();
+			m_rect = z.rect;
+			m_quelle = z.quelle;
+			m_zielPosition = z.zielPosition;
+			m_restBewegung = z.restBewegung;
+			m_geschwindigkeit = z.geschwindigkeit;
+			m_naechsterWegpunktID = z.naechsterWegpunktID;
+			m_naechsterWegpunkt = z.naechsterWegpunkt;
+			m_leben = z.leben;
+			m_art = z.art;
+			m_alleWegpunkte = wegpunkte;
+		}
+	private:
+		struct Zustand{
+			SDL_Rect rect;
+			SDL_Rect quelle;
+			std::array<int,2> zielPosition;
+			std::array<double,2> restBewegung;
+			double geschwindigkeit;
+			uint32_t naechsterWegpunktID;
+			Point naechsterWegpunkt;
+			int leben;
+			Arten::Nummer art;
+			uint16_t frei[3];	// Keine Lücke am Ende, siehe speichere()
+		};
+
+		// Der EinheitenPool darf die Werte direkt lesen. Er legt daraus
+		// seine Kopien der Einheit an.
+		friend class EinheitenPool;
+
+		// Private heißt, dass nur *ich*, also die Klasse selber zugriff auf die
+		// Variable oder Methode hat. Keiner kann diese von außen verändern oder
+		// lesen. Nicht einmal abgeleitete Klassen.
+		// 
+		// Um während des draw etwas zeichnen zu können, müssen wir auch etwas
+		// zeichenbares haben. Also am besten eine Texture.
+		// Wir könnten nun eine eigene Texture für jede Einheit nehmen. Aber da
+		// die Einheiten meist gleich sind, dürfen sie sich auch eine Texture
+		// teilen. Das spart Speicherplatz.
+		SDL_Texture *m_texture = nullptr;
+		SDL_Rect m_rect{0,0,0,0};
+
+		// Welcher Teil der Texture? Bei w == 0 die ganze.
+		SDL_Rect m_quelle{0,0,0,0};
+		const SDL_Rect *quelle() const{
+			return m_quelle.w > 0 ? &m_quelle : nullptr;
+		}
+
+		// Wir kennen ja noch die Größe des Fensters. Laufen wir also einfach
+		// mal schräg rüber (sofern wir bei 0,0 starten sollten).
+		// TODO natürlich müssen wir das nacher noch ordentlich machen.
+		// FIXME Ich weiß, dass die Texture 32x32 groß ist. Die Größe ziehe ich
+		// von der ZielPosition ab, damit ich unten rechts die Einheit auch noch
+		// sehe.
+		// 
+		std::array<int,2> m_zielPosition{{1024-32,768-32}};
+
+		// Wir bewegen uns ja immer in Pixeln. Die Berechnungen sind aber teis
+		// Komma-Werte. Also müssen wir irgendwo das absichern, was wir
+		// "abschneiden". Ist das abgeschnittene groß genug, hängen wir es an
+		// die Bewegung dran.
+		std::array<double,2> m_restBewegung{{0,0}};
+
+		// Probieren wir mal in 3 Sekunden es über den Bildschirm zu schaffen.
+		// Irgendwie war 4 viel zu schnell.
+		// Mit 1 geht es besser. Stimmt aber jetzt nicht mehr als "Sekunden"
+		//
+		// So passt das. Die Gesamtstrecke ist ja gerade noch 1280 px. Die will
+		// ich in 2 Sekunden bestreiten. Also 640 px pro Sekunde.
+		// Die 2 kann ich jetzt einfach durch andere Sekunden erstetzen. Mehr
+		// ist langsamer, weniger ist schneller.
+		double m_geschwindigkeit = (1280.0 /2.0)/1000.0; // 0.320; // in px / ms
+
+
+		uint32_t m_naechsterWegpunktID = 0;
+		Point m_naechsterWegpunkt{{0,0}};
+		WaypointListZeiger m_alleWegpunkte = nullptr;
+
+
+		int m_leben = 5;
+
+		// Geschwindigkeit und Leben stehen oben noch einmal, damit update()
+		// und gotHit() auch ohne die Tabelle gehen.
+		Arten::Nummer m_art = 0;
+};
+
+// Nur wenn das Verschieben nichts werfen kann, verschiebt std::vector beim
+// Wachsen. Sonst kopiert er lieber, um nichts kaputt zu machen.
+static_assert(std::is_nothrow_move_constructible<Einheit>::value,
+		"Einheit muss sich ohne Exception verschieben lassen");
+
+#endif // EINHEIT_H
@@ -0,0 +1,338 @@
+#include "EinheitenPool.h"
+#include "Pfad.h"
+#include "Flussfeld.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+const uint32_t EinheitenPool::KEIN_INDEX;
+
+void EinheitenPool::reserve( size_t anzahl){
+	m_x.reserve(anzahl);
+	m_y.reserve(anzahl);
+	m_altX.reserve(anzahl);
+	m_altY.reserve(anzahl);
+	m_restX.reserve(anzahl);
+	m_restY.reserve(anzahl);
+	m_art.reserve(anzahl);
+	m_zielX.reserve(anzahl);
+	m_zielY.reserve(anzahl);
+	m_wegpunktID.reserve(anzahl);
+	m_strecke.reserve(anzahl);
+	m_leben.reserve(anzahl);
+	m_tot.reserve(anzahl);
+	m_platz.reserve(anzahl);
+	m_index.reserve(anzahl);
+	m_generation.reserve(anzahl);
+	reserviereListen();
+}
+
+void EinheitenPool::reserviereListen(){
+	m_freiePlaetze.reserve(m_index.capacity());
+	m_verloren.reserve(m_platz.capacity());
+}
+
+void EinheitenPool::fuegeHinzu( const Einheit &vorlage, size_t anzahl){
+	if( anzahl == 0) return;
+	if( m_arten == nullptr || vorlage.m_art >= m_arten->anzahlEinheiten()){
+		throw std::runtime_error("Die Art der Einheit kennt der Pool nicht");
+	}
+	const EinheitenArt &art = m_arten->einheit(vorlage.m_art);
+
+	if( empty() && m_wegpunkte == nullptr){
+		m_w = art.breite;
+		m_h = art.hoehe;
+		m_wegpunkte = vorlage.m_alleWegpunkte;
+	}else if( vorlage.m_alleWegpunkte != m_wegpunkte){
+		throw std::runtime_error("Alle Einheiten im Pool brauchen die gleichen Wegpunkte");
+	}else if( art.breite != m_w || art.hoehe != m_h){
+		// Raster und Geschosse rechnen mit einer Größe für alle.
+		throw std::runtime_error("Alle Einheiten im Pool müssen gleich groß sein");
+	}
+
+	// Auf dem Pfad fängt die Einheit am nächsten Punkt des Pfades an.
+	Point start = vorlage.getPosition();
+	double strecke = 0.0;
+	uint32_t abschnitt = vorlage.m_naechsterWegpunktID;
+	if( m_pfad != nullptr){
+		strecke = m_pfad->strecke(start);
+		abschnitt = m_pfad->abschnitt(strecke);
+		start = m_pfad->punkt(strecke, abschnitt);
+	}
+
+	m_x.insert(m_x.end(), anzahl, start[0]);
+	m_y.insert(m_y.end(), anzahl, start[1]);
+	m_altX.insert(m_altX.end(), anzahl, start[0]);
+	m_altY.insert(m_altY.end(), anzahl, start[1]);
+	m_restX.insert(m_restX.end(), anzahl, vorlage.m_restBewegung[0]);
+	m_restY.insert(m_restY.end(), anzahl, vorlage.m_restBewegung[1]);
+	m_art.insert(m_art.end(), anzahl, vorlage.m_art);
+	// Mit dem Flussfeld ist das Ziel erst einmal die eigene Position. Beim
+	// ersten Bewegen schaut die Einheit dann nach, wo es hin geht.
+	if( m_flussfeld != nullptr){
+		m_zielX.insert(m_zielX.end(), anzahl, vorlage.m_rect.x);
+		m_zielY.insert(m_zielY.end(), anzahl, vorlage.m_rect.y);
+	}else{
+		m_zielX.insert(m_zielX.end(), anzahl, vorlage.m_naechsterWegpunkt[0]);
+		m_zielY.insert(m_zielY.end(), anzahl, vorlage.m_naechsterWegpunkt[1]);
+	}
+	m_wegpunktID.insert(m_wegpunktID.end(), anzahl, abschnitt);
+	m_strecke.insert(m_strecke.end(), anzahl, strecke);
+	m_leben.insert(m_leben.end(), anzahl, art.leben);
+	m_tot.insert(m_tot.end(), anzahl, 0);
+
+	// Jede neue Einheit bekommt einen Platz in der Handle-Tabelle.
+	// Zuerst die, die wieder frei geworden sind.
+	for( size_t n = 0; n < anzahl; ++n){
+		uint32_t platz;
+		if( !m_freiePlaetze.empty()){
+			platz = m_freiePlaetze.back();
+			m_freiePlaetze.pop_back();
+		}else{
+			platz = m_index.size();
+			m_index.push_back(KEIN_INDEX);
+			m_generation.push_back(0);
+		}
+		m_index[platz] = m_platz.size();
+		m_platz.push_back(platz);
+	}
+	reserviereListen();
+}
+
+void EinheitenPool::bewege( int frameZeit){
+	// Die eigentliche Rechnung steht in Bewegung.cpp.
+	bewege(frameZeit, 0, size());
+}
+
+void EinheitenPool::bewege( int frameZeit, size_t von, size_t bis){
+	// Wo waren wir vorher? Zum Zeichnen zwischen zwei Schritten.
+	std::copy(m_x.begin() + von, m_x.begin() + bis, m_altX.begin() + von);
+	std::copy(m_y.begin() + von, m_y.begin() + bis, m_altY.begin() + von);
+
+	if( m_flussfeld != nullptr){
+		bewegeFluss(felder(von, bis), frameZeit, *m_flussfeld);
+	}else if( m_pfad != nullptr){
+		bewegePfad(felder(von, bis), m_strecke.data() + von, frameZeit, *m_pfad);
+	}else{
+		m_bewegungsKern(felder(von, bis), frameZeit, m_wegpunkte.get());
+	}
+}
+
+void EinheitenPool::setzeKern( Kern kern){
+	m_bewegungsKern = kernFuer(kern);
+	m_kern = kern;
+}
+
+void EinheitenPool::setzeArten( const Arten *arten){
+	m_arten = arten;
+}
+
+void EinheitenPool::setzeFlussfeld( const Flussfeld *feld){
+	m_flussfeld = feld;
+	if( feld != nullptr){
+		m_pfad = nullptr;
+		m_zielX = m_x;
+		m_zielY = m_y;
+	}
+}
+
+void EinheitenPool::setzePfad( const Pfad *pfad){
+	m_pfad = pfad;
+	if( pfad == nullptr) return;
+	m_flussfeld = nullptr;
+	for( size_t i = 0; i < size(); ++i){
+		m_strecke[i] = pfad->strecke({{m_x[i], m_y[i]}});
+		m_wegpunktID[i] = pfad->abschnitt(m_strecke[i]);
+		Point p = pfad->punkt(m_strecke[i], m_wegpunktID[i]);
+		m_x[i] = m_altX[i] = p[0];
+		m_y[i] = m_altY[i] = p[1];
+	}
+}
+
+BewegungsFelder EinheitenPool::felder( size_t von, size_t bis){
+	return {m_x.data() + von, m_y.data() + von, m_restX.data() + von, m_restY.data() + von,
+		m_art.data() + von, m_arten != nullptr ? m_arten->einheiten() : nullptr,
+		m_zielX.data() + von, m_zielY.data() + von, m_wegpunktID.data() + von, bis - von};
+}
+
+double EinheitenPool::fortschritt( size_t i) const{
+	if( m_pfad != nullptr) return m_strecke[i];
+	if( m_flussfeld != nullptr) return -(double)m_flussfeld->abstand(m_x[i], m_y[i]);
+
+	// Mit den Wegpunkten: erst zählt, wie viele schon geschafft sind, dann
+	// wie weit es noch bis zum nächsten ist. Kein Abschnitt ist auch nur
+	// annähernd 2^22 Pixel lang.
+	double wegX = m_zielX[i] - m_x[i];
+	double wegY = m_zielY[i] - m_y[i];
+	return m_wegpunktID[i] * 4194304.0 - std::sqrt(wegX*wegX + wegY*wegY);
+}
+
+void EinheitenPool::draw( SpriteBatch &batch, double anteil) const{
+	SDL_Rect rect{0, 0, m_w, m_h};
+	const size_t n = size();
+	for( size_t i = 0; i < n; ++i){
+		rect.x = m_altX[i] + (int)std::lround((m_x[i] - m_altX[i]) * anteil);
+		rect.y = m_altY[i] + (int)std::lround((m_y[i] - m_altY[i]) * anteil);
+		const EinheitenArt &art = m_arten->einheit(m_art[i]);
+		batch.zeichne(art.texture, art.quelle.w > 0 ? &art.quelle : nullptr, rect);
+	}
+}
+
+bool EinheitenPool::gotHit( size_t i, int damage){
+	// Wer schon tot ist, kann nicht nochmal sterben.
+	if( m_tot[i]) return false;
+
+	m_leben[i] -= damage;
+	if( m_leben[i] > 0) return false;
+
+	m_tot[i] = 1;
+	m_verloren.push_back(i);
+	return true;
+}
+
+bool EinheitenPool::amAusgang( size_t i) const{
+	if( m_flussfeld != nullptr) return m_flussfeld->abstand(m_x[i], m_y[i]) == 0;
+	if( m_pfad != nullptr) return m_strecke[i] >= m_pfad->laenge();
+	return m_wegpunkte != nullptr && m_wegpunktID[i] >= m_wegpunkte->size()
+		&& m_x[i] == m_zielX[i] && m_y[i] == m_zielY[i];
+}
+
+void EinheitenPool::entkommt( size_t i){
+	if( m_tot[i]) return;
+	m_tot[i] = 1;
+	m_verloren.push_back(i);
+}
+
+void EinheitenPool::raeumeAuf(){
+	// Von hinten nach vorne. Dann ist die letzte Einheit, die nachrückt,
+	// immer eine lebende (oder die tote selber). Alle toten dahinter sind ja
+	// schon weg.
+	std::sort(m_verloren.begin(), m_verloren.end(), std::greater<uint32_t>());
+	for( auto i:m_verloren){
+		entferne(i);
+	}
+	m_verloren.clear();
+}
+
+void EinheitenPool::entferne( size_t i){
+	const size_t letzte = size() - 1;
+
+	// Das Handle der toten Einheit wird ungültig, der Platz ist wieder frei.
+	auto platz = m_platz[i];
+	m_index[platz] = KEIN_INDEX;
+	++m_generation[platz];
+	m_freiePlaetze.push_back(platz);
+
+	if( i != letzte){
+		m_x[i] = m_x[letzte];
+		m_y[i] = m_y[letzte];
+		m_altX[i] = m_altX[letzte];
+		m_altY[i] = m_altY[letzte];
+		m_restX[i] = m_restX[letzte];
+		m_restY[i] = m_restY[letzte];
+		m_art[i] = m_art[letzte];
+		m_zielX[i] = m_zielX[letzte];
+		m_zielY[i] = m_zielY[letzte];
+		m_wegpunktID[i] = m_wegpunktID[letzte];
+		m_strecke[i] = m_strecke[letzte];
+		m_leben[i] = m_leben[letzte];
+		m_tot[i] = m_tot[letzte];
+		m_platz[i] = m_platz[letzte];
+
+		// Die nachgerückte Einheit wohnt jetzt an Stelle i.
+		m_index[m_platz[i]] = i;
+	}
+
+	m_x.pop_back();
+	m_y.pop_back();
+	m_altX.pop_back();
+	m_altY.pop_back();
+	m_restX.pop_back();
+	m_restY.pop_back();
+	m_art.pop_back();
+	m_zielX.pop_back();
+	m_zielY.pop_back();
+	m_wegpunktID.pop_back();
+	m_strecke.pop_back();
+	m_leben.pop_back();
+	m_tot.pop_back();
+	m_platz.pop_back();
+}
+
+void EinheitenPool::speichere( Schnappschuss::Schreiber &s) const{
+	s.wert(m_w);
+	s.wert(m_h);
+	s.wert<char>(m_wegpunkte != nullptr);
+	// Worauf wird gelaufen? 0 Wegpunkte, 1 Flussfeld, 2 Pfad
+	s.wert<char>(m_flussfeld != nullptr ? 1 : (m_pfad != nullptr ? 2 : 0));
+
+	s.feld(m_x);
+	s.feld(m_y);
+	s.feld(m_altX);
+	s.feld(m_altY);
+	s.feld(m_restX);
+	s.feld(m_restY);
+	s.feld(m_art);
+	s.feld(m_zielX);
+	s.feld(m_zielY);
+	s.feld(m_wegpunktID);
+	s.feld(m_strecke);
+	s.feld(m_leben);
+	s.feld(m_tot);
+	s.feld(m_platz);
+
+	s.feld(m_index);
+	s.feld(m_generation);
+	s.feld(m_freiePlaetze);
+	s.feld(m_verloren);
+}
+
+void EinheitenPool::lade( Schnappschuss::Leser &l, const Einheit &vorlage, const Flussfeld *feld, const Pfad *pfad){
+	m_w = l.wert<int>();
+	m_h = l.wert<int>();
+	const bool mitWegpunkten = l.wert<char>() != 0;
+	const char weg = l.wert<char>();
+
+	// Die Zeiger von damals gibt es nicht mehr.
+	m_wegpunkte = mitWegpunkten ? vorlage.m_alleWegpunkte : nullptr;
+	m_flussfeld = weg == 1 ? feld : nullptr;
+	m_pfad = weg == 2 ? pfad : nullptr;
+
+	l.feld(m_x);
+	l.feld(m_y);
+	l.feld(m_altX);
+	l.feld(m_altY);
+	l.feld(m_restX);
+	l.feld(m_restY);
+	l.feld(m_art);
+	l.feld(m_zielX);
+	l.feld(m_zielY);
+	l.feld(m_wegpunktID);
+	l.feld(m_strecke);
+	l.feld(m_leben);
+	l.feld(m_tot);
+	l.feld(m_platz);
+
+	l.feld(m_index);
+	l.feld(m_generation);
+	l.feld(m_freiePlaetze);
+	l.feld(m_verloren);
+
+	const size_t n = m_x.size();
+	for( size_t groesse:{m_y.size(), m_altX.size(), m_altY.size(), m_restX.size(), m_restY.size(),
+			m_art.size(), m_zielX.size(), m_zielY.size(), m_wegpunktID.size(),
+			m_strecke.size(), m_leben.size(), m_tot.size(), m_platz.size()}){
+		if( groesse != n) throw std::runtime_error("Der EinheitenPool im Schnappschuss ist kaputt");
+	}
+	if( m_index.size() != m_generation.size()){
+		throw std::runtime_error("Die Handles im Schnappschuss sind kaputt");
+	}
+	reserviereListen();
+	for( auto art:m_art){
+		if( m_arten == nullptr || art >= m_arten->anzahlEinheiten()){
+			throw std::runtime_error("Eine Art im Schnappschuss gibt es hier nicht");
+		}
+	}
+}
@@ -0,0 +1,252 @@
+/*
+ * Der EinheitenPool.
+ *
+ * Bisher lag jede Einheit als ganzes Objekt in einem std::vector<Einheit>.
+ * Jede davon schleppt ihre eigene Texture, ein SDL_Rect, einen shared_ptr auf
+ * die Wegpunkte und noch ein paar Sachen mit sich herum. Beim Bewegen brauchen
+ * wir davon aber nur ein paar Zahlen. Der Rest wird trotzdem mit in den Cache
+ * geladen.
+ *
+ * Also drehen wir das um: statt einem Array von Einheiten (Array of
+ * Structures) haben wir jetzt ein Array pro Eigenschaft (Structure of Arrays).
+ * Alle x hintereinander, alle y hintereinander, usw. Was alle Einheiten
+ * gemeinsam haben (Größe, Wegpunkte), liegt nur einmal im Pool. Was alle
+ * einer Art gemeinsam haben (Geschwindigkeit, Bild), steht in der Tabelle der
+ * Arten (siehe Arten.h), pro Einheit nur die Nummer ihrer Art.
+ *
+ * Tote Einheiten werden während des Frames nur markiert. Am Ende des Frames
+ * räumen wir einmal auf: die letzte Einheit kommt an die Stelle der toten, und
+ * das Array wird um eins kürzer (swap and pop). Das kostet pro Tote O(1),
+ * statt alles dahinter zu verschieben wie bei erase.
+ *
+ * Dadurch ändert sich aber die Stelle (der Index) einer Einheit. Wer sich eine
+ * Einheit länger als einen Frame merken will, nimmt darum ein Handle. Das
+ * bleibt gültig, bis die Einheit stirbt, und lässt sich danach als ungültig
+ * erkennen.
+ * */
+#ifndef EINHEITENPOOL_H
+#define EINHEITENPOOL_H
+
+#include <SDL.h>
+
+#include <vector>
+#include <cstdint>
+
+#include "Einheit.h"
+#include "Bewegung.h"
+#include "SpriteBatch.h"
+#include "Schnappschuss.h"
+
+class EinheitenPool {
+	public:
+		// Ein Handle zeigt auf einen Platz in der Handle-Tabelle. Wird der
+		// Platz neu vergeben, erhöht sich die Generation. Alte Handles passen
+		// dann nicht mehr.
+		struct Handle{
+			uint32_t platz;
+			uint32_t generation;
+		};
+
+		// Wie viele Einheiten sind gerade da?
+		size_t size() const{
+			return m_x.size();
+		}
+
+		bool empty() const{
+			return m_x.empty();
+		}
+
+		void reserve( size_t anzahl);
+
+		size_t capacity() const{
+			return m_x.capacity();
+		}
+
+		// Fügt 'anzahl' Kopien der Vorlage hinten an.
+		// Größe und Wegpunkte übernimmt der Pool von der ersten Einheit.
+		// Alle weiteren müssen die gleichen Wegpunkte haben und gleich groß
+		// sein. Das Leben kommt von der Art der Vorlage.
+		void fuegeHinzu( const Einheit &vorlage, size_t anzahl = 1);
+
+		// Die Tabelle mit den Arten der Einheiten, siehe Arten.h. Muss so
+		// lange leben wie der Pool, und jede Art, die schon im Pool ist,
+		// muss es darin geben.
+		void setzeArten( const Arten *arten);
+
+		// Bewegt alle Einheiten. Das Gleiche wie Einheit::update, nur für
+		// alle auf einmal.
+		void bewege( int frameZeit);
+
+		// Bewegt nur die Einheiten von 'von' bis (ohne) 'bis'.
+		// Verschiedene Bereiche können gleichzeitig bewegt werden.
+		void bewege( int frameZeit, size_t von, size_t bis);
+
+		// Mit welchem Kern wird bewegt? Standard ist der schnellste, den der
+		// Prozessor kann. Wirft, wenn er den gewünschten nicht kann.
+		void setzeKern( Kern kern);
+		Kern kern() const{
+			return m_kern;
+		}
+
+		// Statt den Wegpunkten nach dem Flussfeld laufen (siehe Flussfeld.h).
+		// Das Feld muss so lange leben wie der Pool. Wer schon da ist, sucht
+		// sich beim nächsten Bewegen seinen Weg darüber.
+		void setzeFlussfeld( const Flussfeld *feld);
+
+		// Oder auf dem Pfad (siehe Pfad.h). Wer schon da ist, kommt auf den
+		// nächsten Punkt des Pfades. Auch das Feld muss so lange leben wie der
+		// Pool.
+		void setzePfad( const Pfad *pfad);
+		bool nutztPfad() const{
+			return m_pfad != nullptr;
+		}
+
+		// Gibt alle Einheiten zum Zeichnen an den SpriteBatch.
+		// 'anteil' sagt, wie weit es vom letzten Bewegen bis zum nächsten
+		// schon ist: bei 0 wird dort gezeichnet, wo die Einheit vor dem
+		// letzten bewege() stand, bei 1 dort, wo sie jetzt ist.
+		void draw( SpriteBatch &batch, double anteil = 1.0) const;
+
+		Point getPosition( size_t i) const{
+			return {{m_x[i], m_y[i]}};
+		}
+
+		// Die Mitte des Bildes der Einheit an Stelle i.
+		Point getMitte( size_t i) const{
+			return {{m_x[i] + m_w/2, m_y[i] + m_h/2}};
+		}
+
+		// Wie weit ist die Einheit an Stelle i auf dem Pfad schon gelaufen?
+		// Nur, wenn auf dem Pfad gelaufen wird, sonst 0.
+		double strecke( size_t i) const{
+			return m_strecke[i];
+		}
+
+		// Auf welchem Abschnitt der Wegpunkte läuft die Einheit an Stelle i?
+		// k heißt: von Wegpunkt k-1 nach k. 0, solange sie noch zum ersten
+		// Wegpunkt unterwegs ist. Nur mit den Wegpunkten.
+		uint32_t wegAbschnitt( size_t i) const{
+			return m_wegpunktID[i] > 0 ? m_wegpunktID[i] - 1 : 0;
+		}
+
+		// Wie weit ist die Einheit schon? Je größer, desto näher am Ausgang.
+		// Auf dem Pfad die Strecke, mit dem Flussfeld die Schritte bis zum
+		// Ziel (negativ), sonst die Wegpunkte, die schon hinter ihr liegen.
+		double fortschritt( size_t i) const;
+
+		int leben( size_t i) const{
+			return m_leben[i];
+		}
+
+		Arten::Nummer art( size_t i) const{
+			return m_art[i];
+		}
+
+		// Die Größe der Bilder, die ist bei allen gleich.
+		int breite() const{ return m_w; }
+		int hoehe() const{ return m_h; }
+
+		const int *x() const{ return m_x.data(); }
+		const int *y() const{ return m_y.data(); }
+
+		// Die Einheit an Stelle i wurde getroffen.
+		// Gibt true zurück, wenn sie daran gestorben ist. Sie wird dann als
+		// tot markiert, bleibt aber bis raeumeAuf() an ihrer Stelle.
+		bool gotHit( size_t i, int damage);
+
+		bool istTot( size_t i) const{
+			return m_tot[i] != 0;
+		}
+
+		// Ist die Einheit an Stelle i am Ende ihres Weges angekommen? Am
+		// letzten Wegpunkt, am Ende des Pfades oder in der Zielzelle des
+		// Flussfeldes.
+		bool amAusgang( size_t i) const;
+
+		// Die Einheit an Stelle i verschwindet, ohne getroffen worden zu
+		// sein. Wie bei gotHit bleibt sie bis raeumeAuf() an ihrer Stelle.
+		void entkommt( size_t i);
+
+		// Entfernt alle als tot markierten Einheiten.
+		// Danach können sich die Stellen der übrigen verändert haben.
+		void raeumeAuf();
+
+		// Handles
+		Handle handle( size_t i) const{
+			return {m_platz[i], m_generation[m_platz[i]]};
+		}
+		bool gueltig( Handle h) const{
+			return h.platz < m_generation.size() && m_generation[h.platz] == h.generation
+				&& m_index[h.platz] != KEIN_INDEX;
+		}
+		size_t index( Handle h) const{
+			return m_index[h.platz];
+		}
+
+		// Alle Arrays und die Handle-Tabelle, siehe Schnappschuss.h. Die
+		// Handles von vorher gelten danach wieder.
+		void speichere( Schnappschuss::Schreiber &s) const;
+
+		// Die Wegpunkte kommen von 'vorlage'. Lief der Pool vorher auf dem
+		// Flussfeld oder dem Pfad, dann jetzt auf 'feld' oder 'pfad'. Der
+		// Kern und die Arten bleiben, wie sie sind. Wirft, wenn es eine Art
+		// darin nicht gibt.
+		void lade( Schnappschuss::Leser &l, const Einheit &vorlage, const Flussfeld *feld, const Pfad *pfad);
+
+		// Die Wegpunkte, die sich alle Einheiten teilen. nullptr, solange
+		// noch keine da war.
+		const WaypointListZeiger &wegpunkte() const{
+			return m_wegpunkte;
+		}
+
+	private:
+		// Entfernt die Einheit an Stelle i. Die letzte Einheit rückt nach.
+		void entferne( size_t i);
+
+		BewegungsFelder felder( size_t von, size_t bis);
+
+		static const uint32_t KEIN_INDEX = 0xFFFFFFFFu;
+
+		// Was alle gemeinsam haben
+		const Arten *m_arten = nullptr;
+		int m_w = 0;
+		int m_h = 0;
+		WaypointListZeiger m_wegpunkte = nullptr;
+
+		Kern m_kern = besterKern();
+		BewegungsKern m_bewegungsKern = kernFuer(m_kern);
+		const Flussfeld *m_flussfeld = nullptr;
+		const Pfad *m_pfad = nullptr;
+
+		// Pro Einheit, jeweils an der gleichen Stelle
+		std::vector<int> m_x;
+		std::vector<int> m_y;
+		std::vector<int> m_altX;		// vor dem letzten bewege(), nur zum Zeichnen
+		std::vector<int> m_altY;
+		std::vector<double> m_restX;
+		std::vector<double> m_restY;
+		std::vector<Arten::Nummer> m_art;
+		std::vector<int> m_zielX;
+		std::vector<int> m_zielY;
+		std::vector<uint32_t> m_wegpunktID;	// auf dem Pfad: der gemerkte Abschnitt
+		std::vector<double> m_strecke;
+		std::vector<int> m_leben;
+		std::vector<char> m_tot;
+		std::vector<uint32_t> m_platz;		// Stelle → Platz in der Handle-Tabelle
+
+		// Die Handle-Tabelle
+		std::vector<uint32_t> m_index;		// Platz → Stelle (oder KEIN_INDEX)
+		std::vector<uint32_t> m_generation;
+		std::vector<uint32_t> m_freiePlaetze;
+
+		// Die Stellen der in diesem Frame gestorbenen Einheiten
+		std::vector<uint32_t> m_verloren;
+
+		// Es können nie mehr Plätze frei werden als es gibt, und nie mehr
+		// Einheiten auf einmal sterben, als im Pool sind. Danach holen
+		// gotHit() und entferne() keinen Speicher mehr, erst wenn der Pool
+		// selber wächst.
+		void reserviereListen();
+};
+
+#endif // EINHEITENPOOL_H
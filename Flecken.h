@@ -0,0 +1,84 @@
+/*
+ * Die Flecken.
+ *
+ * Welche Stellen des Bildschirms wurden in diesem Frame bemalt? Der
+ * Bildschirm wird dazu in Kacheln von 32x32 Pixeln eingeteilt, und jede
+ * Kachel, die ein Bild oder eine Linie berührt, wird markiert. Mit einem
+ * Eintrag pro Kachel ist das Markieren billig, egal wie viele Einheiten
+ * übereinander liegen.
+ *
+ * Im nächsten Frame muss nur dort der Hintergrund wiederhergestellt werden,
+ * siehe Hintergrund.h. Nebeneinanderliegende Kacheln einer Reihe werden
+ * dafür zu einem Streifen zusammengefasst.
+ * */
+#ifndef FLECKEN_H
+#define FLECKEN_H
+
+#include <SDL.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class Flecken {
+	public:
+		static const int KACHEL = 32;
+
+		// Leert dabei alles.
+		void setzeGroesse( int breite, int hoehe){
+			m_breite = breite;
+			m_hoehe = hoehe;
+			m_spalten = (breite + KACHEL - 1) / KACHEL;
+			m_zeilen = (hoehe + KACHEL - 1) / KACHEL;
+			m_kacheln.assign((size_t)m_spalten * m_zeilen, 0);
+		}
+
+		// Das Rechteck von x1,y1 bis ausschließlich x2,y2 wurde bemalt.
+		void markiere( int x1, int y1, int x2, int y2){
+			x1 = std::max(x1, 0);
+			y1 = std::max(y1, 0);
+			x2 = std::min(x2, m_breite);
+			y2 = std::min(y2, m_hoehe);
+			if( x1 >= x2 || y1 >= y2) return;
+			for( int ky = y1 / KACHEL; ky <= (y2 - 1) / KACHEL; ++ky){
+				uint8_t *reihe = &m_kacheln[(size_t)ky * m_spalten];
+				for( int kx = x1 / KACHEL; kx <= (x2 - 1) / KACHEL; ++kx) reihe[kx] = 1;
+			}
+		}
+
+		void markiere( const SDL_Rect &r){
+			markiere(r.x, r.y, r.x + r.w, r.y + r.h);
+		}
+
+		// Ruft f(SDL_Rect) für jeden Streifen markierter Kacheln auf und
+		// leert sie dabei.
+		template<typename F>
+		void fuerJedenStreifen( F f){
+			for( int ky = 0; ky < m_zeilen; ++ky){
+				uint8_t *reihe = &m_kacheln[(size_t)ky * m_spalten];
+				for( int kx = 0; kx < m_spalten; ++kx){
+					if( !reihe[kx]) continue;
+					int ende = kx;
+					while( ende < m_spalten && reihe[ende]) reihe[ende++] = 0;
+					SDL_Rect r{kx * KACHEL, ky * KACHEL, 0, 0};
+					r.w = std::min(ende * KACHEL, m_breite) - r.x;
+					r.h = std::min((ky + 1) * KACHEL, m_hoehe) - r.y;
+					f(r);
+					kx = ende;
+				}
+			}
+		}
+
+		void leere(){
+			std::fill(m_kacheln.begin(), m_kacheln.end(), 0);
+		}
+
+	private:
+		int m_breite = 0;
+		int m_hoehe = 0;
+		int m_spalten = 0;
+		int m_zeilen = 0;
+		std::vector<uint8_t> m_kacheln;
+};
+
+#endif // FLECKEN_H
@@ -0,0 +1,199 @@
+#include "Flussfeld.h"
+
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+const int Flussfeld::ZELLE;
+const uint32_t Flussfeld::UNERREICHBAR;
+
+Flussfeld::Flussfeld( int breite, int hoehe)
+	: m_spalten(std::max(1, (breite + ZELLE - 1) / ZELLE))
+	, m_zeilen(std::max(1, (hoehe + ZELLE - 1) / ZELLE))
+	, m_gesperrt(m_spalten * m_zeilen, 0)
+	, m_abstand(m_spalten * m_zeilen, UNERREICHBAR)
+	, m_naechste(m_spalten * m_zeilen, 0)
+{
+	berechneNeu();
+}
+
+void Flussfeld::setzeZiel( int x, int y){
+	m_ziel = zelle(x, y);
+	berechneNeu();
+}
+
+int Flussfeld::nachbarn( int z, int (&nachbarn)[4]) const{
+	const int zx = z % m_spalten;
+	const int zy = z / m_spalten;
+	int n = 0;
+	if( zy > 0) nachbarn[n++] = z - m_spalten;				// oben
+	if( zx > 0) nachbarn[n++] = z - 1;						// links
+	if( zx + 1 < m_spalten) nachbarn[n++] = z + 1;			// rechts
+	if( zy + 1 < m_zeilen) nachbarn[n++] = z + m_spalten;	// unten
+	return n;
+}
+
+int Flussfeld::richtung( int z) const{
+	if( z == m_ziel) return z;
+
+	// In gesperrte Zellen läuft keiner hinein. Heraus geht es aber, sonst
+	// bleibt eine Einheit stehen, auf deren Zelle gerade ein Turm gebaut
+	// wurde.
+	int nb[4];
+	const int n = nachbarn(z, nb);
+	int beste = z;
+	uint32_t besterAbstand = UNERREICHBAR;
+	for( int k = 0; k < n; ++k){
+		if( m_gesperrt[nb[k]]) continue;
+		if( m_abstand[nb[k]] < besterAbstand){
+			besterAbstand = m_abstand[nb[k]];
+			beste = nb[k];
+		}
+	}
+	return beste;
+}
+
+void Flussfeld::berechneNeu(){
+	std::fill(m_abstand.begin(), m_abstand.end(), UNERREICHBAR);
+
+	// Breitensuche vom Ziel aus. Jeder Schritt kostet gleich viel, also
+	// kommt jede Zelle das erste Mal schon mit ihrem kürzesten Abstand dran.
+	if( !m_gesperrt[m_ziel]){
+		std::queue<int> offen;
+		m_abstand[m_ziel] = 0;
+		offen.push(m_ziel);
+		while( !offen.empty()){
+			int z = offen.front();
+			offen.pop();
+			int nb[4];
+			const int n = nachbarn(z, nb);
+			for( int k = 0; k < n; ++k){
+				if( m_gesperrt[nb[k]] || m_abstand[nb[k]] != UNERREICHBAR) continue;
+				m_abstand[nb[k]] = m_abstand[z] + 1;
+				offen.push(nb[k]);
+			}
+		}
+	}
+
+	for( size_t z = 0; z < m_naechste.size(); ++z){
+		m_naechste[z] = richtung(z);
+	}
+}
+
+bool Flussfeld::blockiere( const SDL_Rect &rect, const std::function<bool()> &pruefe){
+	// Alle Zellen, die das Rechteck berührt. Die rechte und untere Kante
+	// gehören nicht mehr dazu.
+	auto spalte = [this]( int x){ return std::max(0, std::min(m_spalten - 1, x / ZELLE)); };
+	auto zeile = [this]( int y){ return std::max(0, std::min(m_zeilen - 1, y / ZELLE)); };
+	const int zx0 = spalte(rect.x), zx1 = spalte(rect.x + rect.w - 1);
+	const int zy0 = zeile(rect.y), zy1 = zeile(rect.y + rect.h - 1);
+
+	// Für den Fall, dass 'pruefe' nein sagt. Das Feld ist klein, eine Kopie
+	// kostet fast nichts.
+	auto gesperrtVorher = m_gesperrt;
+	auto abstandVorher = m_abstand;
+	auto naechsteVorher = m_naechste;
+
+	m_ungueltig.clear();
+	for( int zy = zy0; zy <= zy1; ++zy){
+		for( int zx = zx0; zx <= zx1; ++zx){
+			int z = zy * m_spalten + zx;
+			if( m_gesperrt[z]) continue;
+			m_gesperrt[z] = 1;
+			m_abstand[z] = UNERREICHBAR;
+			m_ungueltig.push_back(z);
+		}
+	}
+	if( m_ungueltig.empty()) return true;
+
+	// Wer bisher über eine der neuen Sperren gelaufen ist, hat keinen
+	// gültigen Abstand mehr. Das sind alle, deren nächste Zelle ungültig ist,
+	// und von denen wieder alle, usw. Die Liste wächst, während wir sie
+	// ablaufen.
+	int nb[4];
+	for( size_t k = 0; k < m_ungueltig.size(); ++k){
+		const int z = m_ungueltig[k];
+		const int n = nachbarn(z, nb);
+		for( int j = 0; j < n; ++j){
+			if( m_gesperrt[nb[j]] || m_abstand[nb[j]] == UNERREICHBAR) continue;
+			if( m_naechste[nb[j]] != z) continue;
+			m_abstand[nb[j]] = UNERREICHBAR;
+			m_ungueltig.push_back(nb[j]);
+		}
+	}
+
+	// Alle anderen Abstände stimmen noch: durch eine Sperre wird kein Weg
+	// kürzer. Von den gültigen Rändern aus suchen wir jetzt neu. Die Ränder
+	// haben verschiedene Abstände, also nicht mehr Breitensuche, sondern
+	// Dijkstra: immer die Zelle mit dem kleinsten Abstand zuerst.
+	typedef std::pair<uint32_t, int> Eintrag;
+	std::priority_queue<Eintrag, std::vector<Eintrag>, std::greater<Eintrag>> offen;
+	for( int z:m_ungueltig){
+		const int n = nachbarn(z, nb);
+		for( int j = 0; j < n; ++j){
+			if( m_gesperrt[nb[j]] || m_abstand[nb[j]] == UNERREICHBAR) continue;
+			offen.push({m_abstand[nb[j]], nb[j]});
+		}
+	}
+	while( !offen.empty()){
+		Eintrag e = offen.top();
+		offen.pop();
+		if( e.first != m_abstand[e.second]) continue;	// schon kürzer gefunden
+		const int n = nachbarn(e.second, nb);
+		for( int j = 0; j < n; ++j){
+			if( m_gesperrt[nb[j]] || m_abstand[nb[j]] <= e.first + 1) continue;
+			m_abstand[nb[j]] = e.first + 1;
+			offen.push({e.first + 1, nb[j]});
+		}
+	}
+
+	// Die Richtung hat sich nur dort geändert, wo sich ein Abstand geändert
+	// hat, oder bei einem der Nachbarn.
+	for( int z:m_ungueltig){
+		m_naechste[z] = richtung(z);
+		const int n = nachbarn(z, nb);
+		for( int j = 0; j < n; ++j){
+			m_naechste[nb[j]] = richtung(nb[j]);
+		}
+	}
+
+	if( pruefe && !pruefe()){
+		m_gesperrt.swap(gesperrtVorher);
+		m_abstand.swap(abstandVorher);
+		m_naechste.swap(naechsteVorher);
+		return false;
+	}
+	return true;
+}
+
+bool Flussfeld::erreichbar( int x, int y) const{
+	int z = zelle(x, y);
+	if( m_abstand[z] != UNERREICHBAR) return true;
+	// Aus einer gesperrten Zelle geht es noch heraus, wenn ein Nachbar
+	// erreichbar ist.
+	return m_gesperrt[z] && m_naechste[z] != z;
+}
+
+void Flussfeld::speichere( Schnappschuss::Schreiber &s) const{
+	s.wert(m_spalten);
+	s.wert(m_zeilen);
+	s.wert(m_ziel);
+	s.feld(m_gesperrt);
+	s.feld(m_abstand);
+	s.feld(m_naechste);
+}
+
+void Flussfeld::lade( Schnappschuss::Leser &l){
+	m_spalten = l.wert<int>();
+	m_zeilen = l.wert<int>();
+	m_ziel = l.wert<int>();
+	l.feld(m_gesperrt);
+	l.feld(m_abstand);
+	l.feld(m_naechste);
+	const size_t zellen = (size_t)m_spalten * m_zeilen;
+	if( m_gesperrt.size() != zellen || m_abstand.size() != zellen || m_naechste.size() != zellen){
+		throw std::runtime_error("Das Flussfeld im Schnappschuss ist kaputt");
+	}
+	m_ungueltig.clear();
+}
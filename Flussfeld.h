@@ -0,0 +1,121 @@
+/*
+ * Das Flussfeld.
+ *
+ * Mit den Wegpunkten läuft jede Einheit eine feste Liste von Punkten ab. Für
+ * jeden Schritt rechnet sie mit einer Wurzel aus, in welche Richtung es geht.
+ * Und den Weg versperren kann man auch nicht: die Einheiten laufen einfach
+ * durch die Türme hindurch.
+ *
+ * Jetzt teilen wir das Spielfeld in Zellen auf, so groß wie eine Einheit
+ * (32x32, wie im Raster). Eine Zelle ist entweder frei oder gesperrt, zB weil
+ * dort ein Turm steht. Vom Ziel aus rechnen wir mit einer Breitensuche für
+ * jede freie Zelle aus, wie viele Schritte es noch bis zum Ziel sind. Daraus
+ * ergibt sich für jede Zelle die nächste Zelle auf dem Weg: der Nachbar, der
+ * dem Ziel am nächsten ist.
+ *
+ * Das wird nur gerechnet, wenn sich das Spielfeld ändert. Eine Einheit muss
+ * dann nur noch in ihrer Zelle nachschauen, wohin es weiter geht. Egal ob es
+ * eine oder 100000 Einheiten sind, der Weg wird nur einmal gesucht.
+ *
+ * Kommt ein Turm dazu, wird nicht alles neu gerechnet. Nur die Zellen, deren
+ * Weg durch die neue Sperre geführt hat, werden ungültig. Für die sucht eine
+ * zweite Suche (Dijkstra, ausgehend von den gültigen Nachbarn) den neuen Weg.
+ * Heraus kommt genau das Gleiche wie beim Neuberechnen.
+ *
+ * Würde ein Turm den Weg ganz versperren, wird er abgelehnt.
+ * */
+#ifndef FLUSSFELD_H
+#define FLUSSFELD_H
+
+#include <SDL.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Einheit.h"
+#include "Schnappschuss.h"
+
+class Flussfeld {
+	public:
+		static const int ZELLE = 32;
+
+		// Bis hierhin kommt man nicht (mehr).
+		static const uint32_t UNERREICHBAR = 0xFFFFFFFFu;
+
+		Flussfeld( int breite = 1024, int hoehe = 768);
+
+		// Das Ziel: die Einheiten laufen dorthin, bis ihre linke obere Ecke
+		// auf x,y steht. Rechnet das ganze Feld neu.
+		void setzeZiel( int x, int y);
+
+		// Sperrt alle Zellen, die das Rechteck berührt, und bessert das Feld
+		// aus. Danach wird 'pruefe' gefragt, ob das so in Ordnung ist. Ist
+		// es das nicht, bleibt alles wie vorher und es gibt false.
+		bool blockiere( const SDL_Rect &rect, const std::function<bool()> &pruefe = nullptr);
+
+		// Kommt eine Einheit mit der linken oberen Ecke auf x,y von dort
+		// zum Ziel? Aus einer gesperrten Zelle darf sie noch heraus laufen.
+		bool erreichbar( int x, int y) const;
+
+		// Wohin als nächstes? Die linke obere Ecke der nächsten Zelle auf
+		// dem Weg. Am Ziel, oder wenn es keinen Weg gibt, die eigene Zelle.
+		Point naechstes( int x, int y) const{
+			int n = m_naechste[zelle(x, y)];
+			return {{(n % m_spalten) * ZELLE, (n / m_spalten) * ZELLE}};
+		}
+
+		// Schritte bis zum Ziel, von der Zelle von x,y aus.
+		uint32_t abstand( int x, int y) const{
+			return m_abstand[zelle(x, y)];
+		}
+
+		// Die linke obere Ecke der Zelle, in der x,y liegt.
+		Point zellenEcke( int x, int y) const{
+			int z = zelle(x, y);
+			return {{(z % m_spalten) * ZELLE, (z / m_spalten) * ZELLE}};
+		}
+
+		// Alles noch einmal von vorne. Das Gleiche, was blockiere()
+		// Stück für Stück macht.
+		void berechneNeu();
+
+		// Sperren, Ziel und Abstände. Nach dem Laden muss nichts neu
+		// gerechnet werden.
+		void speichere( Schnappschuss::Schreiber &s) const;
+		void lade( Schnappschuss::Leser &l);
+
+	private:
+		// Die Zelle unter der Mitte einer Einheit, die so groß ist wie eine
+		// Zelle. Außerhalb des Feldes die Randzelle, wie im Raster.
+		int zelle( int x, int y) const{
+			int zx = (x + ZELLE/2) / ZELLE;
+			int zy = (y + ZELLE/2) / ZELLE;
+			zx = zx < 0 ? 0 : (zx >= m_spalten ? m_spalten - 1 : zx);
+			zy = zy < 0 ? 0 : (zy >= m_zeilen ? m_zeilen - 1 : zy);
+			return zy * m_spalten + zx;
+		}
+
+		// Schreibt die bis zu vier Nachbarn von z nach 'nachbarn' und gibt
+		// zurück, wie viele es sind. Immer in der gleichen Reihenfolge.
+		int nachbarn( int z, int (&nachbarn)[4]) const;
+
+		// Der Nachbar, der dem Ziel am nächsten ist. Bei Gleichstand der
+		// erste. Hängt nur von den Abständen ab, darum kommt beim
+		// Ausbessern das Gleiche heraus wie beim Neuberechnen.
+		int richtung( int z) const;
+
+		int m_spalten;
+		int m_zeilen;
+		int m_ziel = 0;
+
+		// Pro Zelle
+		std::vector<char> m_gesperrt;
+		std::vector<uint32_t> m_abstand;
+		std::vector<int> m_naechste;
+
+		// Zum Ausbessern, damit nicht jedes Mal neuer Speicher her muss.
+		std::vector<int> m_ungueltig;
+};
+
+#endif // FLUSSFELD_H
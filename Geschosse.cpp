@@ -0,0 +1,214 @@
+#include "Geschosse.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+const uint32_t GeschossPool::KEIN_TREFFER;
+
+GeschossPool::GeschossPool( size_t kapazitaet)
+	: m_kapazitaet(kapazitaet)
+	, m_x(kapazitaet, 0.0)
+	, m_y(kapazitaet, 0.0)
+	, m_altX(kapazitaet, 0.0)
+	, m_altY(kapazitaet, 0.0)
+	, m_richtungX(kapazitaet, 0.0)
+	, m_richtungY(kapazitaet, 0.0)
+	, m_tempo(kapazitaet, 0.0)
+	, m_ziel(kapazitaet, EinheitenPool::Handle{0, 0})
+	, m_restweg(kapazitaet, 0.0)
+	, m_schaden(kapazitaet, 0)
+	, m_splash(kapazitaet, 0)
+	, m_schuetze(kapazitaet, 0)
+	, m_treffer(kapazitaet, KEIN_TREFFER)
+	, m_aktiv(kapazitaet, 0)
+{
+	m_frei.reserve(kapazitaet);
+	for( size_t i = kapazitaet; i > 0; --i){
+		m_frei.push_back(i - 1);
+	}
+}
+
+bool GeschossPool::feuere( double x, double y, EinheitenPool::Handle ziel, double zielX, double zielY,
+		double tempo, double weite, int schaden, int splash, uint32_t schuetze){
+	if( m_frei.empty()) return false;
+
+	double wegX = zielX - x;
+	double wegY = zielY - y;
+	double laenge = std::sqrt(wegX*wegX + wegY*wegY);
+	// Steht das Ziel genau auf dem Turm, fliegt es eben nach rechts. Es
+	// trifft ja sowieso sofort.
+	if( laenge <= 0.0){
+		wegX = 1.0;
+		wegY = 0.0;
+		laenge = 1.0;
+	}
+
+	uint32_t i = m_frei.back();
+	m_frei.pop_back();
+	m_x[i] = m_altX[i] = x;
+	m_y[i] = m_altY[i] = y;
+	m_richtungX[i] = wegX / laenge;
+	m_richtungY[i] = wegY / laenge;
+	m_tempo[i] = tempo;
+	m_ziel[i] = ziel;
+	m_restweg[i] = weite;
+	m_schaden[i] = schaden;
+	m_splash[i] = splash;
+	m_schuetze[i] = schuetze;
+	m_treffer[i] = KEIN_TREFFER;
+	m_aktiv[i] = 1;
+	m_spannweite = std::max(m_spannweite, (size_t)i + 1);
+	return true;
+}
+
+void GeschossPool::bewege( int frameZeit, size_t von, size_t bis,
+		const EinheitenRaster &raster, const EinheitenPool &einheiten, int radius){
+	// Das Raster kennt die linken oberen Ecken der Einheiten. Wir rechnen
+	// aber mit ihrer Mitte.
+	const int halbB = einheiten.breite() / 2;
+	const int halbH = einheiten.hoehe() / 2;
+	const double r2 = (double)radius * radius;
+
+	for( size_t i = von; i < bis; ++i){
+		if( !m_aktiv[i]) continue;
+
+		const double ax = m_x[i], ay = m_y[i];
+		m_altX[i] = ax;
+		m_altY[i] = ay;
+
+		// Lebt das Ziel noch, nehmen wir Kurs auf seine Mitte.
+		if( einheiten.gueltig(m_ziel[i])){
+			size_t j = einheiten.index(m_ziel[i]);
+			if( !einheiten.istTot(j)){
+				Point mitte = einheiten.getMitte(j);
+				double wegX = mitte[0] - ax;
+				double wegY = mitte[1] - ay;
+				double laenge = std::sqrt(wegX*wegX + wegY*wegY);
+				if( laenge > 0.0){
+					m_richtungX[i] = wegX / laenge;
+					m_richtungY[i] = wegY / laenge;
+				}
+			}
+		}
+
+		double schritt = std::min(m_tempo[i] * frameZeit, m_restweg[i]);
+		const double dx = m_richtungX[i] * schritt;
+		const double dy = m_richtungY[i] * schritt;
+
+		// Alle Einheiten, deren Mitte höchstens 'radius' von der Strecke
+		// weg ist, kommen in Frage. Von denen nehmen wir die, die das
+		// Geschoss als erstes berührt.
+		const int x0 = (int)std::floor(std::min(ax, ax + dx)) - radius - halbB;
+		const int y0 = (int)std::floor(std::min(ay, ay + dy)) - radius - halbH;
+		const int x1 = (int)std::ceil(std::max(ax, ax + dx)) + radius - halbB;
+		const int y1 = (int)std::ceil(std::max(ay, ay + dy)) + radius - halbH;
+
+		double erstes = 2.0;
+		uint32_t getroffen = KEIN_TREFFER;
+		const double a = dx*dx + dy*dy;
+		raster.besuche(x0, y0, x1, y1, [&]( unsigned int j, int ex, int ey){
+				if( einheiten.istTot(j)) return;
+				// Wann ist der Abstand von A + t*D zur Mitte M genau radius?
+				// |A - M + t*D|² = r²  →  a*t² + b*t + c = 0
+				const double mx = ax - (ex + halbB);
+				const double my = ay - (ey + halbH);
+				const double c = mx*mx + my*my - r2;
+				double t;
+				if( c <= 0.0){
+					t = 0.0;	// Schon am Anfang drin.
+				}else{
+					if( a <= 0.0) return;
+					const double b = 2.0 * (mx*dx + my*dy);
+					const double diskriminante = b*b - 4.0*a*c;
+					if( diskriminante < 0.0) return;
+					t = (-b - std::sqrt(diskriminante)) / (2.0*a);
+					if( t < 0.0 || t > 1.0) return;
+				}
+				if( t < erstes || (t == erstes && j < getroffen)){
+					erstes = t;
+					getroffen = j;
+				}
+			});
+
+		if( getroffen != KEIN_TREFFER){
+			m_x[i] = ax + dx * erstes;
+			m_y[i] = ay + dy * erstes;
+		}else{
+			m_x[i] = ax + dx;
+			m_y[i] = ay + dy;
+		}
+		m_restweg[i] -= schritt;
+		m_treffer[i] = getroffen;
+	}
+}
+
+void GeschossPool::entferne( size_t i){
+	if( !m_aktiv[i]) return;
+	m_aktiv[i] = 0;
+	m_treffer[i] = KEIN_TREFFER;
+	// Der zuletzt frei gewordene Platz wird als erster wieder vergeben.
+	// Der liegt meistens noch im Cache.
+	m_frei.push_back(i);
+
+	while( m_spannweite > 0 && !m_aktiv[m_spannweite - 1]) --m_spannweite;
+}
+
+void GeschossPool::speichere( Schnappschuss::Schreiber &s) const{
+	s.wert<uint64_t>(m_kapazitaet);
+	s.wert<uint64_t>(m_spannweite);
+	const size_t n = m_spannweite;
+	s.feld(m_x.data(), n);
+	s.feld(m_y.data(), n);
+	s.feld(m_altX.data(), n);
+	s.feld(m_altY.data(), n);
+	s.feld(m_richtungX.data(), n);
+	s.feld(m_richtungY.data(), n);
+	s.feld(m_tempo.data(), n);
+	s.feld(m_ziel.data(), n);
+	s.feld(m_restweg.data(), n);
+	s.feld(m_schaden.data(), n);
+	s.feld(m_splash.data(), n);
+	s.feld(m_schuetze.data(), n);
+	s.feld(m_treffer.data(), n);
+	s.feld(m_aktiv.data(), n);
+	s.feld(m_frei);
+}
+
+void GeschossPool::lade( Schnappschuss::Leser &l){
+	const uint64_t kapazitaet = l.wert<uint64_t>();
+	const uint64_t n = l.wert<uint64_t>();
+	if( n > kapazitaet) throw std::runtime_error("Die Geschosse im Schnappschuss sind kaputt");
+
+	// Hinter der Spannweite ist alles frei, also wie frisch angelegt.
+	*this = GeschossPool(kapazitaet);
+	m_spannweite = n;
+	l.feld(m_x.data(), n);
+	l.feld(m_y.data(), n);
+	l.feld(m_altX.data(), n);
+	l.feld(m_altY.data(), n);
+	l.feld(m_richtungX.data(), n);
+	l.feld(m_richtungY.data(), n);
+	l.feld(m_tempo.data(), n);
+	l.feld(m_ziel.data(), n);
+	l.feld(m_restweg.data(), n);
+	l.feld(m_schaden.data(), n);
+	l.feld(m_splash.data(), n);
+	l.feld(m_schuetze.data(), n);
+	l.feld(m_treffer.data(), n);
+	l.feld(m_aktiv.data(), n);
+	l.feld(m_frei);
+
+	// Jeder Platz ist entweder belegt oder genau einmal frei. Sonst vergibt
+	// feuere() einen Platz doppelt oder einen, den es gar nicht gibt.
+	std::vector<char> frei(kapazitaet, 0);
+	for( uint32_t i:m_frei){
+		if( i >= kapazitaet || frei[i] || (i < n && m_aktiv[i])){
+			throw std::runtime_error("Die freien Plätze im Schnappschuss sind kaputt");
+		}
+		frei[i] = 1;
+	}
+	if( m_frei.size() + std::count_if(m_aktiv.begin(), m_aktiv.begin() + n, []( char a){ return a != 0; }) != kapazitaet){
+		throw std::runtime_error("Die freien Plätze im Schnappschuss sind kaputt");
+	}
+}
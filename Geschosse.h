@@ -0,0 +1,119 @@
+/*
+ * Die Geschosse.
+ *
+ * Bisher trifft ein Schuss sofort: der Turm schießt, die Einheit verliert
+ * Leben, und für einen Frame wird eine rote Linie gezeichnet. Jetzt können
+ * Türme auch echte Geschosse abfeuern. Die fliegen mit einer festen
+ * Geschwindigkeit auf ihr Ziel zu und folgen ihm dabei (über sein Handle,
+ * siehe EinheitenPool.h). Ist das Ziel schon tot, fliegen sie geradeaus
+ * weiter. Getroffen wird, wer ihnen als erstes in den Weg kommt.
+ *
+ * Wie bei den Einheiten liegt jede Eigenschaft in ihrem eigenen Array (siehe
+ * EinheitenPool.h). Die Arrays sind aber von Anfang an so groß, wie sie je
+ * werden dürfen. Ein Geschoss bekommt einen freien Platz aus der Liste der
+ * freien Plätze und gibt ihn nach dem Treffer wieder zurück. Auch bei
+ * Dauerfeuer wird so kein Speicher angefordert. Sind alle Plätze belegt,
+ * geht der Schuss eben daneben.
+ *
+ * Ein schnelles Geschoss kommt in einem langen Frame ein gutes Stück voran.
+ * Würde man nur schauen, wo es am Ende des Frames ist, könnte es glatt durch
+ * eine Einheit hindurch fliegen. Also prüfen wir die ganze Strecke dieses
+ * Frames: das Geschoss ist ein Kreis, der sich entlang der Strecke schiebt
+ * (swept circle). Welche Einheiten dafür in Frage kommen, sagt das Raster.
+ * */
+#ifndef GESCHOSSE_H
+#define GESCHOSSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Raster.h"
+#include "EinheitenPool.h"
+
+class GeschossPool {
+	public:
+		static const uint32_t KEIN_TREFFER = 0xFFFFFFFFu;
+
+		explicit GeschossPool( size_t kapazitaet = 16384);
+
+		// Ein neues Geschoss von x,y auf die Einheit 'ziel', deren Mitte
+		// gerade auf zielX,zielY ist. 'tempo' in px pro ms. Es fliegt
+		// höchstens 'weite' Pixel weit.
+		// 'schuetze' ist die Nummer des Turms, der geschossen hat.
+		// Gibt false zurück, wenn kein Platz mehr frei war.
+		bool feuere( double x, double y, EinheitenPool::Handle ziel, double zielX, double zielY,
+				double tempo, double weite, int schaden, int splash, uint32_t schuetze);
+
+		// Bewegt die Geschosse auf den Plätzen von 'von' bis (ohne) 'bis' und
+		// schaut, ob sie dabei eine lebende Einheit berühren. Die Einheiten
+		// werden nicht verändert, der Treffer steht danach in treffer().
+		// Verschiedene Bereiche können gleichzeitig bewegt werden.
+		// 'radius' ist der Abstand zur Mitte einer Einheit, ab dem es trifft.
+		void bewege( int frameZeit, size_t von, size_t bis,
+				const EinheitenRaster &raster, const EinheitenPool &einheiten, int radius);
+
+		// Alle Plätze bis hierhin können belegt sein. Dahinter ist alles frei.
+		size_t spannweite() const{
+			return m_spannweite;
+		}
+
+		// Wie viele fliegen gerade?
+		size_t anzahl() const{
+			return m_kapazitaet - m_frei.size();
+		}
+
+		bool aktiv( size_t i) const{ return m_aktiv[i] != 0; }
+
+		// Die getroffene Einheit (Stelle im EinheitenPool) oder KEIN_TREFFER.
+		uint32_t treffer( size_t i) const{ return m_treffer[i]; }
+
+		// Ist es weit genug geflogen und verschwindet?
+		bool amEnde( size_t i) const{ return m_restweg[i] <= 0.0; }
+
+		int schaden( size_t i) const{ return m_schaden[i]; }
+		int splash( size_t i) const{ return m_splash[i]; }
+		uint32_t schuetze( size_t i) const{ return m_schuetze[i]; }
+		double x( size_t i) const{ return m_x[i]; }
+		double y( size_t i) const{ return m_y[i]; }
+		// Wo es vor dem letzten bewege() war, zum Zeichnen.
+		double altX( size_t i) const{ return m_altX[i]; }
+		double altY( size_t i) const{ return m_altY[i]; }
+		double richtungX( size_t i) const{ return m_richtungX[i]; }
+		double richtungY( size_t i) const{ return m_richtungY[i]; }
+
+		// Der Platz wird wieder frei.
+		void entferne( size_t i);
+
+		// Nur die Plätze bis spannweite(), dahinter ist alles frei. Die
+		// Liste der freien Plätze kommt mit, damit neue Geschosse wieder die
+		// gleichen Plätze bekommen. Siehe Schnappschuss.h.
+		void speichere( Schnappschuss::Schreiber &s) const;
+		void lade( Schnappschuss::Leser &l);
+
+	private:
+		size_t m_kapazitaet;
+		size_t m_spannweite = 0;
+
+		// Pro Platz
+		std::vector<double> m_x;
+		std::vector<double> m_y;
+		std::vector<double> m_altX;
+		std::vector<double> m_altY;
+		std::vector<double> m_richtungX;	// Länge 1
+		std::vector<double> m_richtungY;
+		std::vector<double> m_tempo;
+		std::vector<EinheitenPool::Handle> m_ziel;
+		std::vector<double> m_restweg;
+		std::vector<int> m_schaden;
+		std::vector<int> m_splash;
+		std::vector<uint32_t> m_schuetze;
+		std::vector<uint32_t> m_treffer;
+		std::vector<char> m_aktiv;
+
+		// Die freien Plätze. Am Anfang liegen die kleinsten hinten und kommen
+		// zuerst dran, so bleiben die belegten Plätze vorne beisammen.
+		std::vector<uint32_t> m_frei;
+};
+
+#endif // GESCHOSSE_H
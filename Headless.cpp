@@ -0,0 +1,707 @@
+#include "Headless.h"
+
+#include "Welt.h"
+#include "Aufzeichnung.h"
+#include "Speicher.h"
+#include "Logbuch.h"
+#include "Bildfang.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <memory>
+
+// Für die Zeitmessung nehmen wir die Uhr aus der Standardbibliothek.
+// SDL_GetTicks kann nur ganze Millisekunden, das ist hier viel zu grob.
+#include <chrono>
+
+// Für die zufälligen Startpositionen der Einheiten.
+// Immer mit dem gleichen Startwert, damit jeder Lauf gleich ist.
+#include <random>
+
+#include <thread>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+struct HeadlessOptionen{
+	long ticks = 10000;			// Wie viele Frames simulieren wir?
+	int dt = 1;					// Simulierte Zeit pro Tick in ms
+	int einheiten = 0;			// Einheiten, die schon zu Beginn da sind
+	int tuerme = 0;				// Türme, die schon zu Beginn stehen
+	int spawnIntervall = 1000;	// Alle wie viele ms kommt eine neue Einheit (0 = nie)
+	Zielsuche zielsuche = Zielsuche::Raster;
+	bool vergleich = false;		// Naiv gegen Raster bei 1k/10k/100k Einheiten
+	Kern kern = besterKern();	// Womit werden die Einheiten bewegt?
+	unsigned int threads = 1;	// 0 = so viele wie Kerne
+	bool skalierung = false;	// 1, 2, 4, ... Threads nacheinander messen
+	bool selbsttest = false;	// Ein paar kleine Szenen nachprüfen
+	bool zeichnen = false;		// Jeden Tick mit dem Software-Renderer zeichnen
+	bool hintergrund = true;	// Die Türme im Hintergrund, siehe Hintergrund.h
+
+	// Die gezeichneten Bilder in Dateien, siehe Bildfang.h
+	std::string bilder;			// In dieses Verzeichnis
+	long bilderAlle = 1;		// Jedes wievielte Bild
+	Bildformat bildformat = Bildformat::Png;
+	bool bilderWarten = false;	// Lieber warten als ein Bild verwerfen
+	bool profil = false;		// Die Abschnitte jedes Ticks messen, siehe Profiler.h
+	std::string traceDatei;		// Die Messungen als Chrome trace_event JSON
+	std::string weg = "wegpunkte";	// wegpunkte, pfad oder fluss
+
+	// Die Arten der Einheiten und Türme, siehe Arten.h
+	std::string arten;			// Zusätzlich aus dieser Datei
+	std::string einheitArt = "gegner";
+	std::string turmArt;		// Leer: "turm", beim Abspielen "geschuetz" wie im Fenster
+
+	// Wie die Türme schießen, siehe Arten.h. Ändert nur die Art 'turmArt',
+	// und nur wenn es angegeben ist.
+	bool mitZielwahl = false;
+	Zielwahl zielwahl = Zielwahl::Reihenfolge;
+	int schaden = -1;			// -1 = wie in der Art
+	int splash = -1;
+	double geschossTempo = -1.0;	// 0 = Treffer sofort, sonst px pro ms
+
+	// Zusätzliche Wellen: anzahl, intervall, start (alles in ms)
+	std::vector<std::array<Uint32,3>> wellen;
+
+	// Abspielen einer Aufnahme, siehe Aufzeichnung.h
+	std::string replay;			// Das Eingabe-Log
+	std::string hashDatei;		// Hierhin kommt die Prüfsumme jedes Ticks
+	std::string gegenDatei;		// Mit den Prüfsummen aus dieser Datei vergleichen
+
+	// Schnappschüsse, siehe Schnappschuss.h
+	std::string schnappschuss;	// Am Ende hierhin speichern (und messen)
+	std::string von;			// Statt neu einzurichten hier weitermachen
+};
+
+// Was bei einem Lauf heraus kommt.
+struct Messung{
+	long ticks = 0;
+	Uint32 simulierteZeit = 0;
+	double sekunden = 0;
+	double nsProEntity = 0;
+	size_t einheitenAmEnde = 0;
+	size_t tuermeAmEnde = 0;
+	uint64_t pruefsumme = 0;	// Welt::pruefsumme am Ende
+
+	// Wie oft wurde während der Ticks Speicher angefordert? Insgesamt und
+	// in der zweiten Hälfte, wenn das Spiel eingeschwungen ist.
+	// Siehe Speicher.h.
+	uint64_t anforderungen = 0;
+	uint64_t anforderungenEingeschwungen = 0;
+
+	// Nur mit --zeichnen: pro Frame im Schnitt
+	double zeichenAufrufe = 0;
+	double absendenUs = 0;
+	double zeichnenUs = 0;		// Das ganze Welt::draw
+	double hintergrundPixel = 0;	// So viel wurde gelöscht oder wiederhergestellt
+
+	// Nur mit --bilder
+	uint64_t bilderGeschrieben = 0;
+	uint64_t bilderVerworfen = 0;
+	double fangenUs = 0;		// Pro Bild, im Frame
+	double nachlaufSekunden = 0;	// Nach dem letzten Tick noch geschrieben
+
+	// Nur mit --schnappschuss
+	size_t schnappschussBytes = 0;
+	double speichernUs = 0;		// Mit Schreiben der Datei
+	double ladenUs = 0;			// Mit Lesen der Datei
+	size_t deltaBytes = 0;		// Zum Schnappschuss einen Tick später
+};
+
+// Ein Software-Renderer, der in ein Bild im Speicher zeichnet. Wie auf den
+// Servern ohne Grafikkarte. Die Texturen sind einfach weiße 32x32 Quadrate.
+struct Leinwand{
+	SDL_Surface *bild = nullptr;
+	SDL_Renderer *renderer = nullptr;
+	SDL_Texture *textureEinheit = nullptr;
+	SDL_Texture *textureTurm = nullptr;
+
+	Leinwand(){
+		bild = SDL_CreateRGBSurfaceWithFormat(0, 1024, 768, 32, SDL_PIXELFORMAT_RGBA32);
+		if( bild == nullptr) throw std::runtime_error(SDL_GetError());
+		renderer = SDL_CreateSoftwareRenderer(bild);
+		if( renderer == nullptr) throw std::runtime_error(SDL_GetError());
+
+		SDL_Surface *quadrat = SDL_CreateRGBSurfaceWithFormat(0, 32, 32, 32, SDL_PIXELFORMAT_RGBA32);
+		if( quadrat == nullptr) throw std::runtime_error(SDL_GetError());
+		SDL_FillRect(quadrat, nullptr, 0xFFFFFFFF);
+		textureEinheit = SDL_CreateTextureFromSurface(renderer, quadrat);
+		textureTurm = SDL_CreateTextureFromSurface(renderer, quadrat);
+		SDL_FreeSurface(quadrat);
+	}
+
+	~Leinwand(){
+		SDL_DestroyTexture(textureTurm);
+		SDL_DestroyTexture(textureEinheit);
+		SDL_DestroyRenderer(renderer);
+		SDL_FreeSurface(bild);
+	}
+};
+
+// Die Arten für einen Lauf: Arten::standard(), dazu die Datei aus --arten.
+// --zielwahl, --schaden, --splash und --geschosse ändern die Art des Turms.
+// Mit Leinwand bekommen alle Arten ihre weißen Quadrate als Bild.
+std::shared_ptr<const Arten> erstelleArten( const HeadlessOptionen &o, const Leinwand *leinwand,
+		const std::string &turmArt){
+	Arten arten = Arten::standard();
+	if( !o.arten.empty()) arten.lade(o.arten);
+
+	TurmArt &t = arten.turm(arten.turmNummer(turmArt));
+	if( o.mitZielwahl) t.zielwahl = o.zielwahl;
+	if( o.schaden >= 0) t.schaden = o.schaden;
+	if( o.splash >= 0) t.splash = o.splash;
+	if( o.geschossTempo >= 0.0) t.geschossTempo = o.geschossTempo;
+
+	if( leinwand){
+		for( size_t n = 0; n < arten.anzahlEinheiten(); ++n){
+			arten.einheit(n).texture = leinwand->textureEinheit;
+		}
+		for( size_t n = 0; n < arten.anzahlTuerme(); ++n){
+			arten.turm(n).texture = leinwand->textureTurm;
+		}
+	}
+	return std::make_shared<const Arten>(std::move(arten));
+}
+
+// Holt den Wert hinter einem Argument, zB die 100 bei "--ticks 100".
+// stoi/stol hören bei der ersten Nicht-Ziffer auf. "1ms" wird also zu 1.
+const char *wert( int &i, int argc, char **argv){
+	if( i + 1 >= argc){
+		throw std::runtime_error(std::string("Wert fehlt nach ") + argv[i]);
+	}
+	return argv[++i];
+}
+
+HeadlessOptionen leseOptionen( int argc, char **argv){
+	HeadlessOptionen o;
+	for( int i = 1; i < argc; ++i){
+		std::string arg = argv[i];
+		if( arg == "--headless") continue;
+		else if( arg == "--ticks") o.ticks = std::stol(wert(i, argc, argv));
+		else if( arg == "--dt") o.dt = std::stoi(wert(i, argc, argv));
+		else if( arg == "--einheiten") o.einheiten = std::stoi(wert(i, argc, argv));
+		else if( arg == "--tuerme") o.tuerme = std::stoi(wert(i, argc, argv));
+		else if( arg == "--spawn") o.spawnIntervall = std::stoi(wert(i, argc, argv));
+		else if( arg == "--zielsuche"){
+			std::string art = wert(i, argc, argv);
+			if( art == "naiv") o.zielsuche = Zielsuche::Naiv;
+			else if( art == "raster") o.zielsuche = Zielsuche::Raster;
+			else if( art == "strecke") o.zielsuche = Zielsuche::Strecke;
+			else throw std::runtime_error("Unbekannte Zielsuche: " + art);
+		}
+		else if( arg == "--weg"){
+			o.weg = wert(i, argc, argv);
+			if( o.weg != "wegpunkte" && o.weg != "pfad" && o.weg != "fluss"){
+				throw std::runtime_error("Unbekannter Weg: " + o.weg);
+			}
+		}
+		else if( arg == "--zielwahl"){
+			o.zielwahl = zielwahlAusName(wert(i, argc, argv));
+			o.mitZielwahl = true;
+		}
+		else if( arg == "--arten") o.arten = wert(i, argc, argv);
+		else if( arg == "--einheit-art") o.einheitArt = wert(i, argc, argv);
+		else if( arg == "--turm-art") o.turmArt = wert(i, argc, argv);
+		else if( arg == "--schaden") o.schaden = std::stoi(wert(i, argc, argv));
+		else if( arg == "--splash") o.splash = std::stoi(wert(i, argc, argv));
+		else if( arg == "--geschosse") o.geschossTempo = std::stod(wert(i, argc, argv));
+		else if( arg == "--vergleich") o.vergleich = true;
+		else if( arg == "--kern") o.kern = kernAusName(wert(i, argc, argv));
+		else if( arg == "--threads") o.threads = std::stoul(wert(i, argc, argv));
+		else if( arg == "--skalierung") o.skalierung = true;
+		else if( arg == "--selbsttest") o.selbsttest = true;
+		else if( arg == "--zeichnen") o.zeichnen = true;
+		else if( arg == "--ohne-hintergrund") o.hintergrund = false;
+		else if( arg == "--bilder"){
+			o.bilder = wert(i, argc, argv);
+			o.zeichnen = true;
+		}
+		else if( arg == "--bilder-alle") o.bilderAlle = std::stol(wert(i, argc, argv));
+		else if( arg == "--bildformat"){
+			std::string art = wert(i, argc, argv);
+			if( art == "png") o.bildformat = Bildformat::Png;
+			else if( art == "ppm") o.bildformat = Bildformat::Ppm;
+			else throw std::runtime_error("Unbekanntes Bildformat: " + art);
+		}
+		else if( arg == "--bilder-warten") o.bilderWarten = true;
+		else if( arg == "--profil") o.profil = true;
+		else if( arg == "--trace") o.traceDatei = wert(i, argc, argv);
+		else if( arg == "--replay") o.replay = wert(i, argc, argv);
+		else if( arg == "--hashes") o.hashDatei = wert(i, argc, argv);
+		else if( arg == "--gegen") o.gegenDatei = wert(i, argc, argv);
+		else if( arg == "--schnappschuss") o.schnappschuss = wert(i, argc, argv);
+		else if( arg == "--von") o.von = wert(i, argc, argv);
+		else if( arg == "--welle"){
+			// --welle anzahl,intervall[,start]
+			// zB --welle 10000,1 für 10000 Einheiten, jede ms eine.
+			std::string w = wert(i, argc, argv);
+			std::array<Uint32,3> welle{{0, 0, 0}};
+			size_t pos = 0;
+			for( int teil = 0; teil < 3 && pos <= w.size(); ++teil){
+				auto komma = w.find(',', pos);
+				if( komma == std::string::npos) komma = w.size();
+				if( komma > pos) welle[teil] = std::stoul(w.substr(pos, komma - pos));
+				pos = komma + 1;
+			}
+			if( welle[0] == 0) throw std::runtime_error("Welle ohne Einheiten: " + w);
+			o.wellen.push_back(welle);
+		}
+		else throw std::runtime_error("Unbekanntes Argument: " + arg);
+	}
+	if( o.ticks <= 0 || o.dt <= 0){
+		throw std::runtime_error("--ticks und --dt müssen größer 0 sein");
+	}
+	if( o.bilderAlle <= 0) throw std::runtime_error("--bilder-alle muss größer 0 sein");
+	return o;
+}
+
+// Der maximale Speicherverbrauch des Prozesses in KiB.
+// Unter Linux liefert getrusage den Wert schon in KiB.
+long peakRssKiB(){
+#ifdef __unix__
+	rusage nutzung;
+	if( getrusage(RUSAGE_SELF, &nutzung) == 0) return nutzung.ru_maxrss;
+#endif
+	return -1;
+}
+
+// Ein Lauf der Simulation mit den gegebenen Optionen.
+Messung messe( const HeadlessOptionen &o){
+	// Ohne Renderer gibt es keine Texturen. Die Größe brauchen wir aber
+	// trotzdem, also nehmen wir die 32x32 der Bilder.
+	// Die Leinwand kommt vor der Welt: der Hintergrund der Welt hat eine
+	// Texture des Renderers, der muss also länger leben.
+	std::unique_ptr<Leinwand> leinwand;
+	if( o.zeichnen) leinwand.reset(new Leinwand);
+
+	Welt welt;
+	// Ohne Fenster und mit vielen Einheiten wollen wir keine Treffer auf der
+	// Konsole, nur Fehler.
+	logbuch().setzeStufe(LogStufe::Fehler);
+	welt.zielsuche = o.zielsuche;
+	welt.hintergrund.an = o.hintergrund;
+	welt.aktiveEinheiten.setzeKern(o.kern);
+	welt.jobs.starte(o.threads);
+	if( o.profil || !o.traceDatei.empty()) welt.profiler.starte();
+
+	std::unique_ptr<Bildfang> bildfang;
+	if( !o.bilder.empty()){
+		bildfang.reset(new Bildfang(o.bilder, o.bildformat, leinwand->bild->w, leinwand->bild->h, o.bilderWarten));
+	}
+
+	// Die Tabelle wird hier einmal fertig gemacht. Danach teilen sie sich
+	// diese Welt und die Kopie zum Schnappschuss-Vergleich.
+	const std::string turmArt = o.turmArt.empty() ? "turm" : o.turmArt;
+	auto arten = erstelleArten(o, leinwand.get(), turmArt);
+	welt.setzeArten(arten);
+	const Arten::Nummer einheitArt = arten->einheitNummer(o.einheitArt);
+	const EinheitenArt &ea = arten->einheit(einheitArt);
+
+	Einheit einheit;
+	einheit.init(*arten, einheitArt, 0, 0);
+	einheit.setzeWegpunkte(erstelleWegpunkte(ea.breite, ea.hoehe));
+
+	Turm turm;
+	turm.init(*arten, arten->turmNummer(turmArt), 0, 0);
+
+	// Die simulierte Zeit. Sie läuft pro Tick um genau dt weiter, egal wie
+	// lange der Tick wirklich gedauert hat.
+	Uint32 jetzt = 0;
+
+	if( !o.von.empty()){
+		// Einheiten, Türme, Wellen und Weg stehen schon im Schnappschuss.
+		welt.lade(Schnappschuss::lies(o.von), einheit);
+		jetzt = welt.zeitplaner.zeit();
+	}else{
+		if( o.weg == "fluss") welt.nutzeFlussfeld(1024-ea.breite, 768-ea.hoehe);
+		if( o.weg == "pfad") welt.nutzePfad(*einheit.getWegpunkte());
+
+		std::minstd_rand zufall(42);
+		welt.aktiveEinheiten.reserve(o.einheiten);
+		for( int n = 0; n < o.einheiten; ++n){
+			Einheit e{einheit};
+			int x = (int)(zufall() % (1024-ea.breite));
+			e.init(*arten, einheitArt, x, (int)(zufall() % (768-ea.hoehe)));
+			welt.aktiveEinheiten.fuegeHinzu(e);
+		}
+		welt.stelleTuermeAuf(turm, o.tuerme);
+
+		if( o.spawnIntervall > 0) welt.planeSpawn(einheit, o.spawnIntervall);
+		for( auto &w:o.wellen){
+			welt.planeWelle(einheit, w[2], w[0], w[1]);
+		}
+	}
+
+	// Wie viele Entities (Einheiten + Türme) wurden insgesamt geupdatet?
+	unsigned long long entityUpdates = 0;
+	std::chrono::steady_clock::duration simDauer{0};
+	double zeichenAufrufe = 0;
+	double absendenUs = 0;
+	double hintergrundPixel = 0;
+	std::chrono::steady_clock::duration zeichenDauer{0};
+
+	const uint64_t anforderungenVorher = speicherAnforderungen();
+	uint64_t anforderungenHalbzeit = anforderungenVorher;
+
+	auto start = std::chrono::steady_clock::now();
+	{
+		// Gezählt wird nur, was die Simulation selbst holt (siehe
+		// Speicher.h), nicht der Bildfang oder das Logbuch.
+		SpeicherZaehlen zaehlen;
+		for( long tick = 0; tick < o.ticks; ++tick){
+			if( tick == o.ticks / 2) anforderungenHalbzeit = speicherAnforderungen();
+			jetzt += o.dt;
+			Profiler::Abschnitt frame(welt.profiler, Phase::Frame);
+
+			entityUpdates += welt.aktiveEinheiten.size() + welt.aktiveTuerme.size();
+
+			auto vorher = std::chrono::steady_clock::now();
+			welt.update(o.dt, jetzt);
+			simDauer += std::chrono::steady_clock::now() - vorher;
+
+			if( leinwand){
+				auto vorZeichnen = std::chrono::steady_clock::now();
+				welt.draw(leinwand->renderer);
+				zeichenDauer += std::chrono::steady_clock::now() - vorZeichnen;
+				zeichenAufrufe += welt.batch.zeichenAufrufe();
+				absendenUs += welt.batch.mikrosekunden();
+				hintergrundPixel += o.hintergrund ? welt.hintergrund.pixel() : 1024 * 768;
+				if( bildfang && tick % o.bilderAlle == 0) bildfang->fange(leinwand->renderer, tick);
+			}else{
+				// Ohne renderer zeichnet keiner die Schüsse. Also weg damit.
+				welt.zuZeichnendeSchuesse.clear();
+			}
+		}
+	}
+	auto gesamt = std::chrono::steady_clock::now() - start;
+	const uint64_t anforderungenNachher = speicherAnforderungen();
+
+	Messung m;
+	if( bildfang){
+		auto vorher = std::chrono::steady_clock::now();
+		bildfang->warte();
+		m.nachlaufSekunden = std::chrono::duration<double>(std::chrono::steady_clock::now() - vorher).count();
+		m.bilderGeschrieben = bildfang->geschrieben();
+		m.bilderVerworfen = bildfang->verworfen();
+		m.fangenUs = bildfang->mikrosekundenProBild();
+	}
+	m.ticks = o.ticks;
+	m.simulierteZeit = jetzt;
+	m.sekunden = std::chrono::duration<double>(gesamt).count();
+	m.nsProEntity = entityUpdates > 0
+		? std::chrono::duration<double, std::nano>(simDauer).count() / entityUpdates
+		: 0.0;
+	m.einheitenAmEnde = welt.aktiveEinheiten.size();
+	m.tuermeAmEnde = welt.aktiveTuerme.size();
+	m.pruefsumme = welt.pruefsumme();
+	m.anforderungen = anforderungenNachher - anforderungenVorher;
+	m.anforderungenEingeschwungen = anforderungenNachher - anforderungenHalbzeit;
+	m.zeichenAufrufe = zeichenAufrufe / o.ticks;
+	m.absendenUs = absendenUs / o.ticks;
+	m.zeichnenUs = std::chrono::duration<double, std::micro>(zeichenDauer).count() / o.ticks;
+	m.hintergrundPixel = hintergrundPixel / o.ticks;
+
+	if( !o.schnappschuss.empty()){
+		// Speichern und wieder laden. Die geladene Welt muss danach genau so
+		// weiterlaufen wie diese.
+		auto vorher = std::chrono::steady_clock::now();
+		Schnappschuss s = welt.schnappschuss();
+		s.schreibe(o.schnappschuss);
+		m.speichernUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - vorher).count();
+		m.schnappschussBytes = s.daten().size();
+
+		Welt kopie;
+		kopie.setzeArten(arten);
+		kopie.zielsuche = o.zielsuche;
+		kopie.aktiveEinheiten.setzeKern(o.kern);
+		kopie.jobs.starte(o.threads);
+		vorher = std::chrono::steady_clock::now();
+		kopie.lade(Schnappschuss::lies(o.schnappschuss), einheit);
+		m.ladenUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - vorher).count();
+
+		bool gleich = kopie.pruefsumme() == welt.pruefsumme();
+		for( Welt *w:{&welt, &kopie}){
+			w->update(o.dt, jetzt + o.dt);
+			w->zuZeichnendeSchuesse.clear();
+		}
+		gleich = gleich && kopie.pruefsumme() == welt.pruefsumme();
+		if( !gleich) throw std::runtime_error("Nach dem Laden kommt etwas anderes heraus!");
+
+		// Wie viel ändert sich in einem Tick?
+		Schnappschuss danach = welt.schnappschuss();
+		auto delta = danach.delta(s);
+		m.deltaBytes = delta.size();
+		if( Schnappschuss::ausDelta(s, delta).daten() != danach.daten()){
+			throw std::runtime_error("Aus dem Delta kommt ein anderer Schnappschuss heraus!");
+		}
+	}
+
+	// Im Ring sind nur die letzten Ticks. Bei einem langen Lauf ist das
+	// gerade der Teil, in dem am meisten los ist.
+	if( o.profil) welt.profiler.gibAus(std::cout, "[PROFIL] ");
+	if( !o.traceDatei.empty()) welt.profiler.schreibeTrace(o.traceDatei);
+	return m;
+}
+
+// Zwei Geschosse treffen im gleichen Frame die gleiche Einheit. Schon das
+// erste erledigt sie. Das zweite darf dann keinen Splash mehr machen und
+// keinen Abschuss mehr zählen. Gibt zurück, ob das stimmt.
+bool pruefeDoppelTreffer(){
+	Arten arten = Arten::standard();
+	EinheitenArt steht;
+	steht.geschwindigkeit = 0.0;
+	steht.leben = 1;
+	const Arten::Nummer ziel = arten.neueEinheit("ziel", steht);
+	steht.leben = 10;
+	const Arten::Nummer nachbar = arten.neueEinheit("nachbar", steht);
+	TurmArt werfer;
+	werfer.setzeReichweite(0);	// Schießt nicht selber, nur unsere zwei
+	werfer.splash = 40;
+	werfer.geschossTempo = 1.0;
+	const Arten::Nummer turmArt = arten.neuerTurm("werfer", werfer);
+
+	Welt welt;
+	logbuch().setzeStufe(LogStufe::Fehler);
+	welt.setzeArten(std::make_shared<const Arten>(std::move(arten)));
+	const Arten &a = welt.arten();
+
+	Turm turm;
+	turm.init(a, turmArt, 0, 0);
+	welt.neuerTurm(turm);
+
+	// Das Ziel bei 500,400, der Nachbar 30px rechts daneben, im Splash.
+	auto wegpunkte = erstelleWegpunkte(32, 32);
+	for( auto art:{ziel, nachbar}){
+		Einheit e;
+		e.init(a, art, art == ziel ? 500 : 530, 400);
+		e.setzeWegpunkte(wegpunkte);
+		welt.aktiveEinheiten.fuegeHinzu(e);
+	}
+	const auto handleNachbar = welt.aktiveEinheiten.handle(1);
+
+	// Beide kommen von links und sind nach einem Frame von 16ms da.
+	const auto mitte = welt.aktiveEinheiten.getMitte(0);
+	for( int n = 0; n < 2; ++n){
+		welt.geschosse.feuere(mitte[0] - 26, mitte[1], welt.aktiveEinheiten.handle(0), mitte[0], mitte[1],
+				werfer.geschossTempo, 100.0, werfer.schaden, werfer.splash, 0);
+	}
+	welt.update(16, 16);
+
+	const bool gut = welt.geschosse.anzahl() == 0
+		&& welt.aktiveEinheiten.size() == 1
+		&& welt.aktiveEinheiten.gueltig(handleNachbar)
+		&& welt.aktiveEinheiten.leben(welt.aktiveEinheiten.index(handleNachbar)) == 10 - werfer.schaden
+		&& welt.aktiveTuerme[0].getAbschuesse() == 1;
+	std::cout << "[TEST] Zwei Geschosse auf eine Einheit: " << (gut ? "ok" : "FEHLER") << std::endl;
+	return gut;
+}
+
+// Spielt eine Aufnahme ab, so schnell es geht.
+// Die Welt fängt genauso an wie im Fenster, und bekommt die gleichen Klicks
+// und Zeiten. Gibt 1 zurück, wenn die Prüfsummen von denen in --gegen
+// abweichen.
+int spieleAb( const HeadlessOptionen &o){
+	Welt welt;
+	logbuch().setzeStufe(LogStufe::Fehler);
+	welt.zielsuche = o.zielsuche;
+	welt.aktiveEinheiten.setzeKern(o.kern);
+	welt.jobs.starte(o.threads);
+
+	// Ohne Bilder, aber mit den gleichen Arten wie im Fenster. Die Aufnahme
+	// passt nur mit der gleichen arten.txt.
+	const std::string turmArt = o.turmArt.empty() ? "geschuetz" : o.turmArt;
+	welt.setzeArten(erstelleArten(o, nullptr, turmArt));
+	Einheit einheit;
+	Turm turm;
+	richteSpielEin(welt, einheit, turm, o.einheitArt, turmArt);
+
+	EingabeWiedergabe log(o.replay);
+
+	std::ofstream hashes;
+	if( !o.hashDatei.empty()){
+		hashes.open(o.hashDatei);
+		if( !hashes) throw std::runtime_error("Kann " + o.hashDatei + " nicht schreiben");
+	}
+	std::ifstream gegen;
+	if( !o.gegenDatei.empty()){
+		gegen.open(o.gegenDatei);
+		if( !gegen) throw std::runtime_error("Kann " + o.gegenDatei + " nicht lesen");
+	}
+	const bool proTick = hashes.is_open() || gegen.is_open();
+
+	long ticks = 0;
+	long abweichung = -1;
+	Uint32 simulierteZeit = 0;
+	Eingabe e;
+
+	auto start = std::chrono::steady_clock::now();
+	while( log.naechste(e)){
+		if( e.art == Eingabe::Art::Klick){
+			welt.baueTurm(turm, e.a, e.b);
+			continue;
+		}
+
+		welt.update(e.a, e.b);
+		welt.zuZeichnendeSchuesse.clear();
+		simulierteZeit += e.a;
+		++ticks;
+
+		if( !proTick) continue;
+		auto summe = welt.pruefsumme();
+		if( hashes.is_open()){
+			hashes << e.tick << '\t' << std::hex << summe << std::dec << '\n';
+		}
+		if( gegen.is_open() && abweichung < 0){
+			uint32_t tick = 0;
+			uint64_t erwartet = 0;
+			gegen >> tick >> std::hex >> erwartet >> std::dec;
+			if( !gegen || tick != e.tick || erwartet != summe) abweichung = e.tick;
+		}
+	}
+	double sekunden = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "[BENCH] Replay: " << o.replay << std::endl;
+	std::cout << "[BENCH] Ticks: " << ticks << " (" << simulierteZeit / 1000.0
+		<< " s gespielt, " << sekunden << " s gebraucht)" << std::endl;
+	std::cout << "[BENCH] Ticks pro Sekunde: " << ticks / sekunden << std::endl;
+	std::cout << "[BENCH] Einheiten am Ende: " << welt.aktiveEinheiten.size()
+		<< ", Tuerme: " << welt.aktiveTuerme.size() << std::endl;
+	std::cout << "[BENCH] Pruefsumme: " << std::hex << welt.pruefsumme() << std::dec << std::endl;
+
+	if( abweichung >= 0){
+		std::cout << "[BENCH] Abweichung von " << o.gegenDatei << " ab Tick " << abweichung << std::endl;
+		return 1;
+	}
+	if( gegen.is_open()){
+		std::cout << "[BENCH] Gleich wie " << o.gegenDatei << std::endl;
+	}
+	return 0;
+}
+
+}
+
+bool istHeadless( int argc, char **argv){
+	for( int i = 1; i < argc; ++i){
+		if( std::strcmp(argv[i], "--headless") == 0) return true;
+	}
+	return false;
+}
+
+int starteHeadless( int argc, char **argv){
+	try{
+		auto o = leseOptionen(argc, argv);
+
+		// SDL brauchen wir hier gar nicht erst starten. Kein Video, und das
+		// Nachladen und Spawnen erledigt der Zeitplaner der Welt.
+
+		if( o.selbsttest){
+			return pruefeDoppelTreffer() ? 0 : 1;
+		}
+
+		if( !o.replay.empty()){
+			int ergebnis = spieleAb(o);
+			std::cout << "[BENCH] Peak RSS: " << peakRssKiB() << " KiB" << std::endl;
+			return ergebnis;
+		}
+
+		if( o.vergleich){
+			// Beide Zielsuchen bei gleicher Last nebeneinander. Sie müssen
+			// auf die gleichen Einheiten schießen, also muss auch die
+			// Prüfsumme gleich sein.
+			std::cout << "[BENCH] Einheiten\tZielsuche\tTicks/s\tns/Entity\tPruefsumme" << std::endl;
+			bool gleich = true;
+			for( int anzahl:{1000, 10000, 100000}){
+				uint64_t naiveSumme = 0;
+				for( auto art:{Zielsuche::Naiv, Zielsuche::Raster}){
+					auto lauf = o;
+					lauf.einheiten = anzahl;
+					lauf.zielsuche = art;
+					auto m = messe(lauf);
+					if( art == Zielsuche::Naiv) naiveSumme = m.pruefsumme;
+					else gleich = gleich && m.pruefsumme == naiveSumme;
+					std::cout << "[BENCH] " << anzahl << "\t"
+						<< (art == Zielsuche::Naiv ? "naiv" : "raster") << "\t"
+						<< m.ticks / m.sekunden << "\t" << m.nsProEntity
+						<< "\t" << std::hex << m.pruefsumme << std::dec << std::endl;
+				}
+			}
+			if( !gleich){
+				std::cerr << "Naiv und Raster kommen zu etwas anderem!" << std::endl;
+				return 1;
+			}
+		}else if( o.skalierung){
+			// Der gleiche Lauf mit immer mehr Threads. Die Prüfsumme muss
+			// dabei immer gleich bleiben.
+			unsigned int maximal = o.threads > 0 ? o.threads : std::max(1u, std::thread::hardware_concurrency());
+			if( maximal == 1) maximal = std::max(1u, std::thread::hardware_concurrency());
+			std::cout << "[BENCH] Threads\tTicks/s\tSpeedup\tPruefsumme" << std::endl;
+			double basis = 0;
+			uint64_t ersteSumme = 0;
+			bool gleich = true;
+			for( unsigned int threads = 1; ; threads = std::min(maximal, threads * 2)){
+				auto lauf = o;
+				lauf.threads = threads;
+				auto m = messe(lauf);
+				double tps = m.ticks / m.sekunden;
+				if( threads == 1){
+					basis = tps;
+					ersteSumme = m.pruefsumme;
+				}
+				gleich = gleich && m.pruefsumme == ersteSumme;
+				std::cout << "[BENCH] " << threads << "\t" << tps << "\t" << tps / basis
+					<< "\t" << std::hex << m.pruefsumme << std::dec << std::endl;
+				if( threads == maximal) break;
+			}
+			if( !gleich){
+				std::cerr << "Mit mehr Threads kommt etwas anderes heraus!" << std::endl;
+				return 1;
+			}
+		}else{
+			auto m = messe(o);
+			std::cout << "[BENCH] Bewegungs-Kern: " << (o.weg == "wegpunkte" ? name(o.kern) : o.weg.c_str()) << std::endl;
+			std::cout << "[BENCH] Threads: " << o.threads << std::endl;
+			std::cout << "[BENCH] Ticks: " << m.ticks << " (dt " << o.dt << " ms, "
+				<< m.simulierteZeit / 1000.0 << " s simuliert)" << std::endl;
+			std::cout << "[BENCH] Ticks pro Sekunde: " << m.ticks / m.sekunden << std::endl;
+			std::cout << "[BENCH] ns pro Entity-Update: " << m.nsProEntity << std::endl;
+			std::cout << "[BENCH] Einheiten am Ende: " << m.einheitenAmEnde
+				<< ", Tuerme: " << m.tuermeAmEnde << std::endl;
+			std::cout << "[BENCH] Pruefsumme: " << std::hex << m.pruefsumme << std::dec << std::endl;
+			std::cout << "[BENCH] Speicheranforderungen: " << m.anforderungen
+				<< ", davon in der zweiten Hälfte: " << m.anforderungenEingeschwungen << std::endl;
+			if( !o.schnappschuss.empty()){
+				std::cout << "[BENCH] Schnappschuss: " << m.schnappschussBytes << " Bytes, speichern "
+					<< m.speichernUs << " us, laden " << m.ladenUs << " us" << std::endl;
+				std::cout << "[BENCH] Delta nach einem Tick: " << m.deltaBytes << " Bytes" << std::endl;
+			}
+			if( o.zeichnen){
+				std::cout << "[BENCH] Zeichenaufrufe pro Frame: " << m.zeichenAufrufe << std::endl;
+				std::cout << "[BENCH] Absenden pro Frame: " << m.absendenUs << " us" << std::endl;
+				std::cout << "[BENCH] Zeichnen pro Frame: " << m.zeichnenUs << " us" << std::endl;
+				std::cout << "[BENCH] Hintergrund pro Frame: " << m.hintergrundPixel << " Pixel"
+					<< (o.hintergrund ? "" : " (gelöscht)") << std::endl;
+			}
+			if( !o.bilder.empty()){
+				std::cout << "[BENCH] Bilder: " << m.bilderGeschrieben << " geschrieben, "
+					<< m.bilderVerworfen << " verworfen, " << m.fangenUs << " us pro Bild im Frame" << std::endl;
+				std::cout << "[BENCH] Nach dem letzten Tick noch " << m.nachlaufSekunden << " s geschrieben" << std::endl;
+			}
+		}
+		std::cout << "[BENCH] Peak RSS: " << peakRssKiB() << " KiB" << std::endl;
+
+	}catch(std::exception &e){
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,27 @@
+/*
+ * Headless - ohne Kopf, also ohne Fenster und ohne Renderer.
+ *
+ * Auf Rechnern ohne Grafikkarte (zB bei der CI) wollen wir trotzdem messen,
+ * wie schnell unsere Simulation ist. Dazu lassen wir die gleiche Welt::update
+ * wie im Spiel laufen, aber mit einer festen, simulierten Zeit pro Tick und so
+ * schnell, wie der Rechner eben kann.
+ *
+ * Aufruf zB:
+ *		TD_Tutorial --headless --ticks 100000 --dt 1ms --einheiten 1000 --tuerme 50
+ *
+ * Am Ende gibt es:
+ * → Ticks pro Sekunde
+ * → Nanosekunden pro Entity-Update (Einheiten + Türme je Tick)
+ * → den maximalen Speicherverbrauch (peak RSS)
+ * */
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+// Steht --headless irgendwo in den Argumenten?
+bool istHeadless( int argc, char **argv);
+
+// Lässt die Simulation ohne Fenster laufen und gibt die Messwerte aus.
+// Der Rückgabewert ist für main() gedacht.
+int starteHeadless( int argc, char **argv);
+
+#endif // HEADLESS_H
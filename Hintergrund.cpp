@@ -0,0 +1,71 @@
+#include "Hintergrund.h"
+
+Hintergrund::~Hintergrund(){
+	gibFrei();
+}
+
+void Hintergrund::gibFrei(){
+	if( m_texture != nullptr) SDL_DestroyTexture(m_texture);
+	m_texture = nullptr;
+	m_renderer = nullptr;
+}
+
+bool Hintergrund::vorbereiten( SDL_Renderer *renderer){
+	if( !an || renderer == nullptr) return false;
+
+	if( renderer != m_renderer){
+		gibFrei();
+		SDL_RendererInfo info;
+		if( SDL_GetRendererInfo(renderer, &info) != 0) return false;
+		if( (info.flags & SDL_RENDERER_TARGETTEXTURE) == 0) return false;
+		m_software = (info.flags & SDL_RENDERER_SOFTWARE) != 0;
+		m_renderer = renderer;
+	}
+
+	int breite = 0;
+	int hoehe = 0;
+	if( SDL_GetRendererOutputSize(renderer, &breite, &hoehe) != 0) return false;
+	if( m_texture == nullptr || breite != m_breite || hoehe != m_hoehe){
+		if( m_texture != nullptr) SDL_DestroyTexture(m_texture);
+		m_texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+				SDL_TEXTUREACCESS_TARGET, breite, hoehe);
+		if( m_texture == nullptr){
+			m_renderer = nullptr;
+			return false;
+		}
+		// Der Hintergrund deckt alles ab, da wird nichts gemischt.
+		SDL_SetTextureBlendMode(m_texture, SDL_BLENDMODE_NONE);
+		m_breite = breite;
+		m_hoehe = hoehe;
+		m_flecken.setzeGroesse(breite, hoehe);
+		m_veraltet = true;
+	}
+	return true;
+}
+
+void Hintergrund::beginne( SDL_Renderer *renderer){
+	SDL_SetRenderTarget(renderer, m_texture);
+	SDL_RenderClear(renderer);
+}
+
+void Hintergrund::ende( SDL_Renderer *renderer){
+	SDL_SetRenderTarget(renderer, nullptr);
+	m_veraltet = false;
+	m_alles = true;
+}
+
+void Hintergrund::stelleWiederHer( SDL_Renderer *renderer){
+	if( m_alles || !m_software){
+		SDL_RenderCopy(renderer, m_texture, nullptr, nullptr);
+		m_pixel = (long)m_breite * m_hoehe;
+		m_alles = false;
+		m_flecken.leere();
+		return;
+	}
+
+	m_pixel = 0;
+	m_flecken.fuerJedenStreifen([&]( const SDL_Rect &r){
+			SDL_RenderCopy(renderer, m_texture, &r, &r);
+			m_pixel += (long)r.w * r.h;
+		});
+}
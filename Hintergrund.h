@@ -0,0 +1,96 @@
+/*
+ * Der Hintergrund.
+ *
+ * Bisher wird jedes Frame der ganze Bildschirm mit SDL_RenderClear gelöscht
+ * und dann alles neu gezeichnet: Einheiten, Schüsse, aber auch die Türme, die
+ * sich nur ändern, wenn einer dazukommt. Mit dem Software-Renderer (ohne
+ * Grafikkarte, siehe Headless.h) kostet schon das Löschen jedes Pixels Zeit.
+ *
+ * Darum gibt es jetzt zwei Ebenen:
+ * → Der Hintergrund mit allem, was still steht (die Türme), wird einmal in
+ *   eine eigene Texture (ein Render-Target) gezeichnet. Neu gezeichnet wird
+ *   er erst, wenn neuZeichnen() aufgerufen wurde, also wenn ein Turm
+ *   dazukommt.
+ * → Alles, was sich bewegt, wird jedes Frame darüber gezeichnet.
+ *
+ * Statt zu löschen wird der Hintergrund auf den Bildschirm kopiert. Beim
+ * Software-Renderer bleibt das Bild zwischen zwei Frames stehen. Dort
+ * reicht es, den Hintergrund nur an den Stellen wiederherzustellen, die im
+ * letzten Frame bemalt wurden (siehe Flecken.h). Bei einem Renderer mit
+ * Grafikkarte ist nach SDL_RenderPresent nicht klar, was noch im Buffer
+ * steht. Da wird der ganze Hintergrund kopiert.
+ *
+ * Kann der Renderer keine Render-Targets, gibt vorbereiten() false zurück
+ * und es wird wie früher alles gelöscht und neu gezeichnet.
+ * */
+#ifndef HINTERGRUND_H
+#define HINTERGRUND_H
+
+#include <SDL.h>
+
+#include "Flecken.h"
+
+class Hintergrund {
+	public:
+		Hintergrund() = default;
+		~Hintergrund();
+
+		Hintergrund( const Hintergrund&) = delete;
+		Hintergrund& operator=( const Hintergrund&) = delete;
+
+		// Zum Vergleichen: mit false wird wie früher jedes Frame alles
+		// gelöscht und neu gezeichnet.
+		bool an = true;
+
+		// Beim nächsten Frame muss der Hintergrund neu gezeichnet werden.
+		void neuZeichnen(){
+			m_veraltet = true;
+		}
+
+		bool veraltet() const{
+			return m_veraltet;
+		}
+
+		// Legt, wenn nötig, die Texture für 'renderer' an. Gibt false zurück,
+		// wenn es keinen Hintergrund geben kann.
+		bool vorbereiten( SDL_Renderer *renderer);
+
+		// Alles, was zwischen beginne() und ende() gezeichnet wird, landet
+		// im Hintergrund.
+		void beginne( SDL_Renderer *renderer);
+		void ende( SDL_Renderer *renderer);
+
+		// Kopiert den Hintergrund dorthin, wo seit dem letzten Mal etwas
+		// anderes gezeichnet wurde.
+		void stelleWiederHer( SDL_Renderer *renderer);
+
+		// Hier wird markiert, was in diesem Frame über den Hintergrund
+		// gezeichnet wird. Siehe SpriteBatch::setzeFlecken.
+		Flecken &flecken(){
+			return m_flecken;
+		}
+
+		// Wie viele Pixel hat das letzte stelleWiederHer() kopiert?
+		long pixel() const{
+			return m_pixel;
+		}
+
+		// Gibt die Texture frei. Muss vor SDL_DestroyRenderer kommen, der
+		// räumt seine Texturen nämlich selber weg, und danach wäre unser
+		// Zeiger ungültig. Beim nächsten vorbereiten() gibt es eine neue.
+		void gibFrei();
+
+	private:
+
+		SDL_Renderer *m_renderer = nullptr;
+		SDL_Texture *m_texture = nullptr;
+		int m_breite = 0;
+		int m_hoehe = 0;
+		bool m_software = false;	// Bleibt das Bild zwischen Frames stehen?
+		bool m_veraltet = true;
+		bool m_alles = true;		// Beim nächsten Mal alles kopieren
+		Flecken m_flecken;
+		long m_pixel = 0;
+};
+
+#endif // HINTERGRUND_H
@@ -0,0 +1,134 @@
+#include "JobSystem.h"
+#include "Speicher.h"
+
+#include <algorithm>
+
+JobSystem::JobSystem( unsigned int threads){
+	starte(threads);
+}
+
+JobSystem::~JobSystem(){
+	halteAn();
+}
+
+void JobSystem::starte( unsigned int threads){
+	halteAn();
+
+	if( threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+	m_schlangen.clear();
+	for( unsigned int i = 0; i < threads; ++i){
+		m_schlangen.emplace_back(new Schlange);
+	}
+
+	// Nummer 0 ist der Thread, der parallelFuer aufruft.
+	m_ende = false;
+	for( unsigned int i = 1; i < threads; ++i){
+		m_threads.emplace_back(&JobSystem::arbeite, this, i);
+	}
+}
+
+void JobSystem::halteAn(){
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_ende = true;
+	}
+	m_wecker.notify_all();
+	for( auto &t:m_threads) t.join();
+	m_threads.clear();
+}
+
+void JobSystem::parallelFuer( size_t anzahl, size_t block, const Aufgabe &aufgabe){
+	if( anzahl == 0) return;
+	if( block == 0) block = 1;
+
+	// Lohnt sich nicht oder geht nicht anders.
+	if( m_threads.empty() || anzahl <= block){
+		aufgabe(0, anzahl, 0);
+		return;
+	}
+
+	// Die Stücke reihum auf die Schlangen verteilen.
+	const size_t stuecke = (anzahl + block - 1) / block;
+	const bool zaehlen = speicherWirdGezaehlt();
+	m_offen.store(stuecke, std::memory_order_relaxed);
+	for( size_t s = 0; s < stuecke; ++s){
+		auto &schlange = *m_schlangen[s % m_schlangen.size()];
+		std::lock_guard<std::mutex> lock(schlange.mutex);
+		schlange.jobs.push_back({&aufgabe, s * block, std::min(anzahl, (s + 1) * block), zaehlen});
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_runde;
+	}
+	m_wecker.notify_all();
+
+	// Selber mitarbeiten ...
+	Job job;
+	while( hole(0, job)) fuehreAus(0, job);
+
+	// ... und auf die letzten warten. Die sind gerade in Arbeit, das dauert
+	// nicht mehr lange.
+	while( m_offen.load(std::memory_order_acquire) != 0){
+		std::this_thread::yield();
+	}
+}
+
+bool JobSystem::hole( unsigned int arbeiter, Job &job){
+	{
+		auto &eigene = *m_schlangen[arbeiter];
+		std::lock_guard<std::mutex> lock(eigene.mutex);
+		if( !eigene.leer()){
+			job = eigene.jobs.back();
+			eigene.jobs.pop_back();
+			if( eigene.leer()){
+				eigene.jobs.clear();
+				eigene.anfang = 0;
+			}
+			return true;
+		}
+	}
+
+	// Bei den anderen klauen. Beim nächsten Nachbarn fangen wir an, damit
+	// nicht alle beim gleichen klauen.
+	const unsigned int n = m_schlangen.size();
+	for( unsigned int k = 1; k < n; ++k){
+		auto &fremde = *m_schlangen[(arbeiter + k) % n];
+		std::lock_guard<std::mutex> lock(fremde.mutex);
+		if( !fremde.leer()){
+			job = fremde.jobs[fremde.anfang++];
+			if( fremde.leer()){
+				fremde.jobs.clear();
+				fremde.anfang = 0;
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::fuehreAus( unsigned int arbeiter, const Job &job){
+	{
+		SpeicherZaehlen zaehlen(job.zaehlen);
+		(*job.aufgabe)(job.von, job.bis, arbeiter);
+	}
+	// release: was der Job geschrieben hat, sieht der Aufrufer, sobald er
+	// die 0 sieht.
+	m_offen.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::arbeite( unsigned int arbeiter){
+	unsigned long gesehen = 0;
+	while( true){
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wecker.wait(lock, [&]{ return m_ende || m_runde != gesehen; });
+			if( m_ende) return;
+			gesehen = m_runde;
+		}
+
+		Job job;
+		while( hole(arbeiter, job)) fuehreAus(arbeiter, job);
+	}
+}
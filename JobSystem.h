@@ -0,0 +1,125 @@
+/*
+ * Das JobSystem.
+ *
+ * Ein Frame hat viele kleine Aufgaben, die nichts voneinander wissen müssen:
+ * jede Einheit bewegt sich für sich, jeder Turm kann für sich in seine Zellen
+ * schauen. Das kann man auf mehrere Kerne verteilen.
+ *
+ * Für jeden Frame neue Threads zu starten, dauert aber viel zu lange. Also
+ * starten wir sie einmal und lassen sie schlafen, bis es Arbeit gibt.
+ *
+ * Die Arbeit wird in Stücke (Jobs) zerteilt. Jeder Thread hat seine eigene
+ * Schlange mit Jobs. Die eigenen Jobs nimmt er sich von hinten.
+ * Ist seine Schlange leer, klaut er sich einen Job von vorne aus der Schlange
+ * eines anderen (work stealing). So hat keiner lange nichts zu tun, auch wenn
+ * manche Stücke länger dauern als andere.
+ *
+ * Der Thread, der parallelFuer aufruft, arbeitet selber mit. Bei einem Thread
+ * wird gar nichts verteilt, dann läuft alles wie vorher.
+ * */
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem {
+	public:
+		// Bekommt die Arbeit von 'von' bis (ohne) 'bis' und die Nummer des
+		// Threads, der sie erledigt (0 bis threads()-1).
+		//
+		// Früher war das eine std::function. Die kopiert das Lambda aber auf
+		// den Heap, sobald es mehr als zwei Dinge einfängt, und das in jedem
+		// Frame. Wir brauchen das Lambda aber nur, solange parallelFuer
+		// läuft. Also merken wir uns nur, wo es liegt, und wie man es
+		// aufruft.
+		class Aufgabe{
+			public:
+				template<typename F>
+				Aufgabe( const F &f)
+					: m_f(&f)
+					, m_rufe(&rufe<F>)
+				{}
+
+				void operator()( size_t von, size_t bis, unsigned int arbeiter) const{
+					m_rufe(m_f, von, bis, arbeiter);
+				}
+
+			private:
+				template<typename F>
+				static void rufe( const void *f, size_t von, size_t bis, unsigned int arbeiter){
+					(*static_cast<const F*>(f))(von, bis, arbeiter);
+				}
+
+				const void *m_f;
+				void (*m_rufe)( const void*, size_t, size_t, unsigned int);
+		};
+
+		explicit JobSystem( unsigned int threads = 1);
+		~JobSystem();
+
+		JobSystem( const JobSystem&) = delete;
+		JobSystem& operator=( const JobSystem&) = delete;
+
+		// Hält die alten Threads an und startet 'threads'-1 neue.
+		// 0 heißt: so viele, wie der Rechner Kerne hat.
+		void starte( unsigned int threads);
+
+		unsigned int threads() const{
+			return m_schlangen.size();
+		}
+
+		// Teilt 0..anzahl in Stücke von 'block' und verteilt sie.
+		// Kehrt erst zurück, wenn alle Stücke fertig sind.
+		void parallelFuer( size_t anzahl, size_t block, const Aufgabe &aufgabe);
+
+	private:
+		struct Job{
+			const Aufgabe *aufgabe;
+			size_t von;
+			size_t bis;
+			bool zaehlen;	// Zählt der Verteiler Speicher mit? (Speicher.h)
+		};
+
+		// Der Besitzer nimmt hinten weg, die anderen klauen vorne bei
+		// 'anfang'. Ist sie leer, geht es wieder von vorne los. Anders als
+		// eine deque holt sie so keinen neuen Speicher, wenn sie erst einmal
+		// groß genug war.
+		struct Schlange{
+			std::mutex mutex;
+			std::vector<Job> jobs;
+			size_t anfang = 0;
+
+			bool leer() const{
+				return anfang == jobs.size();
+			}
+		};
+
+		void halteAn();
+
+		// Der Arbeiter holt sich einen Job. Erst aus der eigenen Schlange,
+		// dann von den anderen.
+		bool hole( unsigned int arbeiter, Job &job);
+		void fuehreAus( unsigned int arbeiter, const Job &job);
+
+		// Die Schleife der Threads.
+		void arbeite( unsigned int arbeiter);
+
+		std::vector<std::unique_ptr<Schlange>> m_schlangen;
+		std::vector<std::thread> m_threads;
+
+		// Geweckt wird, wenn es eine neue Runde Arbeit gibt.
+		std::mutex m_mutex;
+		std::condition_variable m_wecker;
+		unsigned long m_runde = 0;
+		bool m_ende = false;
+
+		// Wie viele Jobs der aktuellen Runde sind noch nicht fertig?
+		std::atomic<size_t> m_offen{0};
+};
+
+#endif // JOBSYSTEM_H
@@ -0,0 +1,174 @@
+#include "Logbuch.h"
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+const size_t Logbuch::KAPAZITAET;
+const size_t Logbuch::WERTE;
+
+namespace {
+
+const char *name( LogBereich bereich){
+	switch(bereich){
+		case LogBereich::Spiel: return "Spiel";
+		case LogBereich::Treffer: return "Treffer";
+		case LogBereich::Bauen: return "Bauen";
+		case LogBereich::ANZAHL: break;
+	}
+	return "?";
+}
+
+const auto programmStart = std::chrono::steady_clock::now();
+
+}
+
+bool LogBremse::darf( uint64_t jetzt, uint32_t &unterdrueckt){
+	unterdrueckt = 0;
+	if( m_proSekunde == 0) return true;
+
+	// +1, damit die 0 am Anfang keine echte Sekunde ist.
+	const uint64_t sekunde = jetzt / 1000000000ull + 1;
+	if( m_sekunde.load(std::memory_order_relaxed) != sekunde){
+		m_sekunde.store(sekunde, std::memory_order_relaxed);
+		m_anzahl.store(0, std::memory_order_relaxed);
+	}
+	if( m_anzahl.fetch_add(1, std::memory_order_relaxed) < m_proSekunde){
+		unterdrueckt = m_unterdrueckt.exchange(0, std::memory_order_relaxed);
+		return true;
+	}
+	m_unterdrueckt.fetch_add(1, std::memory_order_relaxed);
+	return false;
+}
+
+Logbuch::Logbuch()
+	: m_aus(&std::clog)
+	, m_ring(new Platz[KAPAZITAET])
+{
+	setzeStufe(LogStufe::Info);
+	for( size_t i = 0; i < KAPAZITAET; ++i){
+		m_ring[i].sequenz.store(i, std::memory_order_relaxed);
+	}
+}
+
+Logbuch::~Logbuch(){
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_ende = true;
+	}
+	m_wecker.notify_all();
+	if( m_thread.joinable()) m_thread.join();
+}
+
+void Logbuch::setzeStufe( LogStufe stufe){
+	for( size_t b = 0; b < (size_t)LogBereich::ANZAHL; ++b){
+		setzeStufe((LogBereich)b, stufe);
+	}
+}
+
+uint64_t Logbuch::jetzt() const{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - programmStart).count();
+}
+
+void Logbuch::stelleEin( const Eintrag &e){
+	std::call_once(m_gestartet, [this]{ m_thread = std::thread(&Logbuch::arbeite, this); });
+
+	// Einen Platz reservieren: der nächste ist frei, wenn seine Sequenz
+	// gleich der Position ist. Hat ein anderer Thread schneller
+	// reserviert, versuchen wir es mit dem danach.
+	size_t pos = m_schreibPos.load(std::memory_order_relaxed);
+	Platz *platz;
+	for( ;;){
+		platz = &m_ring[pos & (KAPAZITAET - 1)];
+		size_t sequenz = platz->sequenz.load(std::memory_order_acquire);
+		if( sequenz == pos){
+			if( m_schreibPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+		}else if( sequenz < pos){
+			// Der Leser ist eine ganze Runde hinterher. Voll.
+			m_verworfen.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}else{
+			pos = m_schreibPos.load(std::memory_order_relaxed);
+		}
+	}
+
+	platz->eintrag = e;
+	// Jetzt darf der Leser ran.
+	platz->sequenz.store(pos + 1, std::memory_order_release);
+}
+
+bool Logbuch::nimm( Eintrag &e){
+	Platz &platz = m_ring[m_lesePos & (KAPAZITAET - 1)];
+	if( platz.sequenz.load(std::memory_order_acquire) != m_lesePos + 1) return false;
+	e = platz.eintrag;
+	// Eine Runde später darf hier wieder geschrieben werden.
+	platz.sequenz.store(m_lesePos + KAPAZITAET, std::memory_order_release);
+	++m_lesePos;
+	return true;
+}
+
+void Logbuch::gibAus( const Eintrag &e){
+	std::ostream &aus = *m_aus;
+	aus << "[" << name(e.bereich) << "] ";
+
+	// Die {} der Reihe nach durch die Werte ersetzen.
+	size_t wert = 0;
+	for( const char *c = e.text; *c != '\0'; ++c){
+		if( c[0] == '{' && c[1] == '}' && wert < e.anzahlWerte){
+			double w = e.werte[wert++];
+			// Ganze Zahlen auch ganz, ohne 1e+06.
+			if( w == std::floor(w) && std::fabs(w) < 1e15) aus << (long long)w;
+			else aus << w;
+			++c;
+		}else{
+			aus << *c;
+		}
+	}
+	if( e.unterdrueckt > 0) aus << " (" << e.unterdrueckt << " weitere unterdrückt)";
+	aus << '\n';
+}
+
+void Logbuch::arbeite(){
+	uint64_t gemeldetVerworfen = 0;
+	bool ende = false;
+	while( !ende){
+		{
+			// Alle 10ms schauen, ob es etwas gibt. Geweckt wird nur zum
+			// Leeren und am Ende, damit das Spiel beim Schreiben keinen
+			// Systemaufruf braucht.
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_wecker.wait_for(lock, std::chrono::milliseconds(10));
+			ende = m_ende;
+		}
+
+		Eintrag e;
+		size_t anzahl = 0;
+		while( nimm(e)){
+			gibAus(e);
+			++anzahl;
+		}
+		uint64_t verworfen = m_verworfen.load(std::memory_order_relaxed);
+		if( verworfen != gemeldetVerworfen){
+			*m_aus << "[LOG] " << verworfen - gemeldetVerworfen << " Einträge verworfen, die Schlange war voll\n";
+			gemeldetVerworfen = verworfen;
+		}
+		if( anzahl > 0){
+			m_aus->flush();
+			m_ausgegeben.fetch_add(anzahl, std::memory_order_release);
+		}
+	}
+}
+
+void Logbuch::leere(){
+	const size_t bis = m_schreibPos.load(std::memory_order_relaxed);
+	while( m_ausgegeben.load(std::memory_order_acquire) < bis){
+		m_wecker.notify_all();
+		std::this_thread::yield();
+	}
+}
+
+Logbuch &logbuch(){
+	static Logbuch buch;
+	return buch;
+}
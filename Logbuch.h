@@ -0,0 +1,182 @@
+/*
+ * Das Logbuch.
+ *
+ * Bisher stand mitten in der Zielsuche ein
+ *     std::clog << "Treffer!" << std::endl;
+ * Bei einer großen Welle sind das tausende Zeilen pro Sekunde, und jedes
+ * std::endl wartet, bis die Zeile wirklich im Terminal (oder in der Datei)
+ * ist. Die Framerate hängt dann davon ab, wie schnell das Terminal ist.
+ *
+ * Also schreibt das Spiel selber gar nichts mehr. Es legt nur einen kleinen
+ * Eintrag in eine Schlange: einen festen Text und ein paar Zahlen. Formatiert
+ * und ausgegeben wird in einem eigenen Thread, und am Ende jedes Schwungs
+ * wird einmal geflusht.
+ *
+ * Die Schlange ist ein Ring fester Größe ohne Mutex. Jeder Platz hat eine
+ * Nummer (Sequenz), an der Schreiber und Leser sehen, ob der Platz gerade
+ * frei oder voll ist. Ist der Ring voll, wird der Eintrag verworfen und
+ * gezählt, das Spiel wartet nie auf das Log.
+ *
+ * Außerdem:
+ * → Jeder Bereich (Treffer, Bauen, ...) hat seine eigene Stufe. Ist sie zu
+ *   niedrig, kostet TD_LOG nur eine Abfrage.
+ * → Jede Stelle mit TD_LOG darf höchstens so und so oft pro Sekunde. Was
+ *   darüber ist, wird nur gezählt und mit dem nächsten Eintrag gemeldet.
+ * → Mit -DTD_OHNE_LOG (in CMake: -DTD_LOG=OFF) bleibt von TD_LOG gar nichts
+ *   übrig.
+ *
+ *   TD_LOG(LogBereich::Bauen, LogStufe::Info, 0, "Neuer Turm bei {} {}", x, y);
+ *
+ * Die {} werden der Reihe nach durch die Zahlen ersetzt. Der Text muss fest
+ * im Programm stehen (ein "..."), es wird nur der Zeiger gemerkt.
+ * */
+#ifndef LOGBUCH_H
+#define LOGBUCH_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+enum class LogBereich : uint8_t{
+	Spiel,		// FPS und was sonst so läuft
+	Treffer,	// Treffer und Versenkt
+	Bauen,		// Türme
+	ANZAHL
+};
+
+// Je höher, desto mehr wird geschrieben.
+enum class LogStufe : uint8_t{
+	Aus,
+	Fehler,
+	Info,
+	Detail
+};
+
+// Zählt für eine Stelle im Code, wie oft sie in dieser Sekunde schon
+// geschrieben hat.
+class LogBremse {
+	public:
+		// 0 heißt: keine Grenze.
+		explicit LogBremse( uint32_t proSekunde)
+			: m_proSekunde(proSekunde)
+		{}
+
+		// Darf jetzt (in ns) geschrieben werden? Wenn ja, steht in
+		// 'unterdrueckt', wie viele seit dem letzten Mal nicht durften.
+		bool darf( uint64_t jetzt, uint32_t &unterdrueckt);
+
+	private:
+		const uint32_t m_proSekunde;
+		std::atomic<uint64_t> m_sekunde{0};
+		std::atomic<uint32_t> m_anzahl{0};
+		std::atomic<uint32_t> m_unterdrueckt{0};
+};
+
+class Logbuch {
+	public:
+		static const size_t KAPAZITAET = 4096;	// Eine Zweierpotenz
+		static const size_t WERTE = 4;
+
+		Logbuch();
+		~Logbuch();
+
+		Logbuch( const Logbuch&) = delete;
+		Logbuch& operator=( const Logbuch&) = delete;
+
+		void setzeStufe( LogBereich bereich, LogStufe stufe){
+			m_stufen[(size_t)bereich].store((uint8_t)stufe, std::memory_order_relaxed);
+		}
+
+		// Alle Bereiche auf einmal.
+		void setzeStufe( LogStufe stufe);
+
+		bool an( LogBereich bereich, LogStufe stufe) const{
+			return (uint8_t)stufe <= m_stufen[(size_t)bereich].load(std::memory_order_relaxed);
+		}
+
+		// Legt einen Eintrag in die Schlange. Lieber über TD_LOG.
+		template<typename... W>
+		void schreibe( LogBremse &bremse, LogBereich bereich, LogStufe stufe, const char *text, W... werte){
+			static_assert(sizeof...(W) <= WERTE, "Zu viele Werte für einen Eintrag");
+			Eintrag e;
+			e.zeit = jetzt();
+			if( !bremse.darf(e.zeit, e.unterdrueckt)) return;
+			e.text = text;
+			e.bereich = bereich;
+			e.stufe = stufe;
+			e.anzahlWerte = sizeof...(W);
+			const double alle[WERTE + 1] = {(double)werte...};
+			for( size_t i = 0; i < sizeof...(W); ++i) e.werte[i] = alle[i];
+			stelleEin(e);
+		}
+
+		// Wartet, bis alles ausgegeben ist, was bis jetzt eingestellt wurde.
+		void leere();
+
+		// Wohin wird geschrieben? Am Anfang std::clog. Nur aufrufen, bevor
+		// das erste Mal geschrieben wird.
+		void setzeAusgabe( std::ostream &aus){
+			m_aus = &aus;
+		}
+
+	private:
+		struct Eintrag{
+			uint64_t zeit;	// ns seit dem Start
+			const char *text;
+			double werte[WERTE];
+			uint32_t unterdrueckt;
+			uint8_t anzahlWerte;
+			LogBereich bereich;
+			LogStufe stufe;
+		};
+
+		struct Platz{
+			std::atomic<size_t> sequenz;
+			Eintrag eintrag;
+		};
+
+		uint64_t jetzt() const;
+		void stelleEin( const Eintrag &e);
+		bool nimm( Eintrag &e);
+		void gibAus( const Eintrag &e);
+		void arbeite();
+
+		std::array<std::atomic<uint8_t>, (size_t)LogBereich::ANZAHL> m_stufen;
+		std::ostream *m_aus;
+
+		std::unique_ptr<Platz[]> m_ring;
+		std::atomic<size_t> m_schreibPos{0};
+		size_t m_lesePos = 0;	// Nur der Thread liest.
+		std::atomic<uint64_t> m_verworfen{0};
+
+		// Der Thread wird erst beim ersten Eintrag gestartet.
+		std::once_flag m_gestartet;
+		std::thread m_thread;
+		std::mutex m_mutex;
+		std::condition_variable m_wecker;
+		bool m_ende = false;
+		std::atomic<size_t> m_ausgegeben{0};
+};
+
+// Das eine Logbuch für das ganze Programm.
+Logbuch &logbuch();
+
+#ifdef TD_OHNE_LOG
+#define TD_LOG( bereich, stufe, proSekunde, ...) do{}while(0)
+#else
+// Jede Stelle mit TD_LOG bekommt ihre eigene Bremse.
+#define TD_LOG( bereich, stufe, proSekunde, ...) \
+	do{ \
+		if( logbuch().an(bereich, stufe)){ \
+			static LogBremse bremse(proSekunde); \
+			logbuch().schreibe(bremse, bereich, stufe, __VA_ARGS__); \
+		} \
+	}while(0)
+#endif
+
+#endif // LOGBUCH_H
@@ -0,0 +1,78 @@
+#include "Pfad.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+Pfad::Pfad( const WaypointList &wegpunkte)
+	: m_punkte(wegpunkte)
+	, m_bis(wegpunkte.size(), 0.0)
+	, m_richtungX(wegpunkte.size(), 0.0)
+	, m_richtungY(wegpunkte.size(), 0.0)
+{
+	for( size_t k = 1; k < m_punkte.size(); ++k){
+		double wegX = m_punkte[k][0] - m_punkte[k-1][0];
+		double wegY = m_punkte[k][1] - m_punkte[k-1][1];
+		double laenge = std::sqrt(wegX*wegX + wegY*wegY);
+		m_bis[k] = m_bis[k-1] + laenge;
+		// Zwei gleiche Punkte hintereinander: da gibt es keine Richtung.
+		if( laenge > 0){
+			m_richtungX[k] = wegX / laenge;
+			m_richtungY[k] = wegY / laenge;
+		}
+	}
+}
+
+uint32_t Pfad::abschnitt( double strecke) const{
+	if( m_punkte.size() < 2) return 1;
+	// Der erste Wegpunkt, der mindestens so weit weg ist.
+	auto bis = std::lower_bound(m_bis.begin() + 1, m_bis.end() - 1, strecke);
+	return bis - m_bis.begin();
+}
+
+Point Pfad::punkt( double strecke) const{
+	uint32_t k = abschnitt(strecke);
+	return punkt(strecke, k);
+}
+
+double Pfad::strecke( const Point &p) const{
+	if( m_punkte.size() < 2) return 0.0;
+
+	// Für jeden Abschnitt den nächsten Punkt darauf suchen. Bei Gleichstand
+	// gewinnt der frühere.
+	double beste = 0.0;
+	double besterAbstand = -1.0;
+	for( size_t k = 1; k < m_punkte.size(); ++k){
+		const Point &a = m_punkte[k-1];
+		double laenge = m_bis[k] - m_bis[k-1];
+		double zuP_X = p[0] - a[0];
+		double zuP_Y = p[1] - a[1];
+		double t = zuP_X * m_richtungX[k] + zuP_Y * m_richtungY[k];
+		t = std::max(0.0, std::min(laenge, t));
+		double dx = zuP_X - t * m_richtungX[k];
+		double dy = zuP_Y - t * m_richtungY[k];
+		double abstand = dx*dx + dy*dy;
+		if( besterAbstand < 0 || abstand < besterAbstand){
+			besterAbstand = abstand;
+			beste = m_bis[k-1] + t;
+		}
+	}
+	return beste;
+}
+
+void Pfad::speichere( Schnappschuss::Schreiber &s) const{
+	s.feld(m_punkte);
+	s.feld(m_bis);
+	s.feld(m_richtungX);
+	s.feld(m_richtungY);
+}
+
+void Pfad::lade( Schnappschuss::Leser &l){
+	l.feld(m_punkte);
+	l.feld(m_bis);
+	l.feld(m_richtungX);
+	l.feld(m_richtungY);
+	const size_t n = m_punkte.size();
+	if( m_bis.size() != n || m_richtungX.size() != n || m_richtungY.size() != n){
+		throw std::runtime_error("Der Pfad im Schnappschuss ist kaputt");
+	}
+}
@@ -0,0 +1,88 @@
+/*
+ * Der Pfad.
+ *
+ * Die Wegpunkte ändern sich während des Spiels nicht. Trotzdem rechnet jede
+ * Einheit in jedem Frame aus, wie weit es noch bis zu ihrem nächsten
+ * Wegpunkt ist (mit einer Wurzel), und schleppt dazu noch die Restbewegung
+ * mit.
+ *
+ * Das können wir einmal vorher erledigen: für jeden Wegpunkt steht im Pfad,
+ * wie weit er vom Anfang entfernt ist (die Länge aller Abschnitte davor
+ * zusammen). Eine Einheit muss sich dann nur noch merken, wie weit sie schon
+ * gelaufen ist. Eine Zahl. Bewegen heißt: die Strecke dieses Frames dazu
+ * zählen. Wo sie dann gerade steht, rechnet der Pfad aus.
+ *
+ * Wer am weitesten gelaufen ist, ist dem Ausgang am nächsten. Das ist gleich
+ * noch praktisch für die Türme.
+ * */
+#ifndef PFAD_H
+#define PFAD_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Einheit.h"
+#include "Schnappschuss.h"
+
+class Pfad {
+	public:
+		Pfad() = default;
+		explicit Pfad( const WaypointList &wegpunkte);
+
+		const std::vector<Point> &punkte() const{
+			return m_punkte;
+		}
+
+		// Wie lang ist der ganze Pfad? In Pixeln.
+		double laenge() const{
+			return m_bis.empty() ? 0.0 : m_bis.back();
+		}
+
+		// Wo steht man nach 'strecke' Pixeln?
+		// 'abschnitt' merkt sich, auf welchem Abschnitt man das letzte Mal
+		// war. Da die Einheiten nur vorwärts laufen, geht die Suche von dort
+		// aus meistens gar nicht weiter. Am Anfang 1.
+		Point punkt( double strecke, uint32_t &abschnitt) const{
+			if( m_punkte.size() < 2) return m_punkte.empty() ? Point{{0, 0}} : m_punkte[0];
+			if( abschnitt < 1 || abschnitt >= m_punkte.size()) abschnitt = 1;
+			// Immer der erste Abschnitt, der bis 'strecke' reicht. Dann
+			// kommt bei gleicher Strecke auch der gleiche Punkt heraus, egal
+			// woher die Suche kam.
+			while( abschnitt > 1 && strecke <= m_bis[abschnitt - 1]) --abschnitt;
+			while( abschnitt + 1 < m_punkte.size() && strecke > m_bis[abschnitt]) ++abschnitt;
+			if( strecke >= laenge()) return m_punkte.back();
+
+			const Point &a = m_punkte[abschnitt - 1];
+			const double weiter = strecke - m_bis[abschnitt - 1];
+			return {{(int)std::floor(a[0] + weiter * m_richtungX[abschnitt]),
+				(int)std::floor(a[1] + weiter * m_richtungY[abschnitt])}};
+		}
+
+		// Das Gleiche ohne gemerkten Abschnitt. Sucht binär.
+		Point punkt( double strecke) const;
+
+		// Wie weit ist der Punkt auf dem Pfad, der p am nächsten liegt, vom
+		// Anfang entfernt? Für Einheiten, die neben dem Pfad anfangen.
+		double strecke( const Point &p) const;
+
+		// Der Abschnitt, auf dem man nach 'strecke' Pixeln ist.
+		uint32_t abschnitt( double strecke) const;
+
+		void speichere( Schnappschuss::Schreiber &s) const;
+		void lade( Schnappschuss::Leser &l);
+
+	private:
+		std::vector<Point> m_punkte;
+
+		// Pro Wegpunkt: wie weit vom Anfang. m_bis[0] ist 0.
+		std::vector<double> m_bis;
+
+		// Pro Abschnitt (von Punkt k-1 nach k, also ab 1): die Richtung,
+		// schon durch die Länge geteilt. Ein Pixel weiter auf dem Abschnitt
+		// sind so viel in x und y.
+		std::vector<double> m_richtungX;
+		std::vector<double> m_richtungY;
+};
+
+#endif // PFAD_H
@@ -0,0 +1,114 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+const size_t Profiler::KAPAZITAET;
+
+namespace {
+
+// Jeder Thread bekommt beim ersten Messen eine kleine Nummer. Der erste ist
+// meistens die Hauptschleife, also 0.
+uint16_t threadNummer(){
+	static std::atomic<uint16_t> naechste{0};
+	static thread_local uint16_t nummer = naechste.fetch_add(1);
+	return nummer;
+}
+
+// Der Wert an Stelle 'anteil' (0 bis 1) der sortierten Liste.
+double perzentil( std::vector<uint32_t> &werte, double anteil){
+	size_t k = std::min(werte.size() - 1, (size_t)(anteil * (werte.size() - 1) + 0.5));
+	std::nth_element(werte.begin(), werte.begin() + k, werte.end());
+	return werte[k] / 1000.0;
+}
+
+}
+
+const char *name( Phase phase){
+	switch(phase){
+		case Phase::Frame: return "Frame";
+		case Phase::Eingabe: return "Eingabe";
+		case Phase::Zeitplaner: return "Zeitplaner";
+		case Phase::Einheiten: return "Einheiten";
+		case Phase::Tuerme: return "Tuerme";
+		case Phase::Zielsuche: return "Zielsuche";
+		case Phase::Geschosse: return "Geschosse";
+		case Phase::Aufraeumen: return "Aufraeumen";
+		case Phase::Zeichnen: return "Zeichnen";
+		case Phase::Anzeigen: return "Anzeigen";
+		case Phase::ANZAHL: break;
+	}
+	return "?";
+}
+
+void Profiler::starte(){
+	if( m_aktiv) return;
+	m_ring.resize(KAPAZITAET);
+	m_anfang = std::chrono::steady_clock::now();
+	m_schreibPos.store(0);
+	m_fensterAnfang = 0;
+	m_aktiv = true;
+}
+
+void Profiler::trageEin( Phase phase, uint64_t anfang, uint64_t ende){
+	uint64_t dauer = std::min<uint64_t>(ende - anfang, UINT32_MAX);
+	uint64_t pos = m_schreibPos.fetch_add(1, std::memory_order_relaxed);
+	m_ring[pos % KAPAZITAET] = {anfang, (uint32_t)dauer, threadNummer(), phase};
+}
+
+std::vector<Profiler::Statistik> Profiler::auswertung() const{
+	std::vector<std::vector<uint32_t>> dauern((size_t)Phase::ANZAHL);
+	fuerAlle(m_fensterAnfang, [&]( const Messung &m){
+			dauern[(size_t)m.phase].push_back(m.dauer);
+		});
+
+	std::vector<Statistik> ergebnis;
+	for( size_t p = 0; p < dauern.size(); ++p){
+		auto &werte = dauern[p];
+		if( werte.empty()) continue;
+		Statistik s;
+		s.phase = (Phase)p;
+		s.anzahl = werte.size();
+		s.max = *std::max_element(werte.begin(), werte.end()) / 1000.0;
+		s.p99 = perzentil(werte, 0.99);
+		s.p50 = perzentil(werte, 0.5);
+		ergebnis.push_back(s);
+	}
+	return ergebnis;
+}
+
+void Profiler::gibAus( std::ostream &aus, const std::string &vorne) const{
+	aus << vorne << std::left << std::setw(12) << "Phase" << std::right
+		<< std::setw(8) << "Anzahl" << std::setw(12) << "p50 us"
+		<< std::setw(12) << "p99 us" << std::setw(12) << "max us" << std::endl;
+	auto alteFlags = aus.flags();
+	auto altePraezision = aus.precision();
+	aus << std::fixed << std::setprecision(1);
+	for( auto &s:auswertung()){
+		aus << vorne << std::left << std::setw(12) << name(s.phase) << std::right
+			<< std::setw(8) << s.anzahl << std::setw(12) << s.p50
+			<< std::setw(12) << s.p99 << std::setw(12) << s.max << std::endl;
+	}
+	aus.flags(alteFlags);
+	aus.precision(altePraezision);
+}
+
+void Profiler::schreibeTrace( const std::string &datei) const{
+	std::ofstream aus(datei);
+	if( !aus) throw std::runtime_error("Kann " + datei + " nicht schreiben");
+
+	// Chrome will Mikrosekunden. "X" ist ein Ereignis mit Anfang und Dauer.
+	aus << "{\"traceEvents\":[\n";
+	aus << std::fixed << std::setprecision(3);
+	bool erstes = true;
+	fuerAlle(0, [&]( const Messung &m){
+			if( !erstes) aus << ",\n";
+			erstes = false;
+			aus << "{\"name\":\"" << name(m.phase) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << m.thread
+				<< ",\"ts\":" << m.anfang / 1000.0 << ",\"dur\":" << m.dauer / 1000.0 << "}";
+		});
+	aus << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	if( !aus) throw std::runtime_error("Fehler beim Schreiben von " + datei);
+}
@@ -0,0 +1,158 @@
+/*
+ * Der Profiler.
+ *
+ * Bisher gab es nur die FPS einmal pro Sekunde, und die Zeit eines Frames mit
+ * SDL_GetTicks auf die Millisekunde genau. Wird ein Frame zu langsam, weiß
+ * man damit aber nicht, woran es liegt: am Bewegen? An der Zielsuche? Am
+ * Zeichnen?
+ *
+ * Also messen wir jeden Abschnitt (Phase) eines Frames für sich, mit der
+ * steady_clock auf die Nanosekunde. Dafür gibt es Profiler::Abschnitt: am
+ * Anfang eines Blocks anlegen, am Ende des Blocks (im Destruktor) wird die
+ * Dauer eingetragen.
+ *
+ *   {
+ *       Profiler::Abschnitt abschnitt(profiler, Phase::Zielsuche);
+ *       ...
+ *   }
+ *
+ * Die Messungen landen in einem Ring fester Größe. Wer eintragen will, holt
+ * sich mit einem atomaren Zähler den nächsten Platz, ganz ohne Mutex. Ist
+ * der Ring voll, werden die ältesten Messungen überschrieben.
+ *
+ * Daraus gibt es pro Phase den Median (p50), das 99. Perzentil (p99) und das
+ * Maximum. Oder alles als Datei im trace_event Format von Chrome. Die lässt
+ * sich in chrome://tracing oder https://ui.perfetto.dev öffnen, und man sieht
+ * jeden Frame als Balken.
+ *
+ * Ist der Profiler aus, kostet ein Abschnitt nur eine Abfrage.
+ * */
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Die Abschnitte eines Frames.
+enum class Phase : uint8_t{
+	Frame,		// Der ganze Frame
+	Eingabe,	// Die Events von SDL
+	Zeitplaner,	// Nachladen und Spawnen
+	Einheiten,	// Einheiten bewegen
+	Tuerme,		// Türme updaten
+	Zielsuche,
+	Geschosse,
+	Aufraeumen,	// Tote Einheiten entfernen
+	Zeichnen,	// Alles sammeln und an den Renderer schicken
+	Anzeigen,	// SDL_RenderPresent
+	ANZAHL
+};
+
+const char *name( Phase phase);
+
+class Profiler {
+	public:
+		// So viele Messungen passen in den Ring.
+		static const size_t KAPAZITAET = 1 << 16;
+
+		// Ab jetzt wird gemessen. Erst hier wird der Ring angelegt.
+		void starte();
+		bool aktiv() const{
+			return m_aktiv;
+		}
+
+		// Nanosekunden seit starte().
+		uint64_t jetzt() const{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - m_anfang).count();
+		}
+
+		// Phase hat von 'anfang' bis 'ende' gedauert (aus jetzt()).
+		// Darf von mehreren Threads gleichzeitig aufgerufen werden.
+		void trageEin( Phase phase, uint64_t anfang, uint64_t ende);
+
+		// Misst vom Anlegen bis zum Ende des Blocks.
+		class Abschnitt{
+			public:
+				Abschnitt( Profiler &profiler, Phase phase)
+					: m_profiler(profiler.aktiv() ? &profiler : nullptr)
+					, m_phase(phase)
+					, m_anfang(m_profiler ? m_profiler->jetzt() : 0)
+				{}
+
+				~Abschnitt(){
+					ende();
+				}
+
+				// Schon vor dem Ende des Blocks fertig.
+				void ende(){
+					if( m_profiler) m_profiler->trageEin(m_phase, m_anfang, m_profiler->jetzt());
+					m_profiler = nullptr;
+				}
+
+				Abschnitt( const Abschnitt&) = delete;
+				Abschnitt& operator=( const Abschnitt&) = delete;
+
+			private:
+				Profiler *m_profiler;
+				Phase m_phase;
+				uint64_t m_anfang;
+		};
+
+		// Pro Phase, in Mikrosekunden.
+		struct Statistik{
+			Phase phase;
+			size_t anzahl;
+			double p50;
+			double p99;
+			double max;
+		};
+
+		// Über alle Messungen seit dem letzten neuesFenster() (soweit sie
+		// noch im Ring sind). Phasen ohne Messung fehlen.
+		std::vector<Statistik> auswertung() const;
+
+		// Die nächste auswertung() fängt hier an. Der Ring bleibt, wie er
+		// ist, für schreibeTrace().
+		void neuesFenster(){
+			m_fensterAnfang = m_schreibPos.load(std::memory_order_acquire);
+		}
+
+		// Die Auswertung als Tabelle, jede Zeile fängt mit 'vorne' an.
+		void gibAus( std::ostream &aus, const std::string &vorne) const;
+
+		// Alle Messungen, die noch im Ring sind, als Chrome trace_event JSON.
+		// Wirft std::runtime_error, wenn die Datei nicht geschrieben werden
+		// kann.
+		void schreibeTrace( const std::string &datei) const;
+
+	private:
+		struct Messung{
+			uint64_t anfang;	// ns seit starte()
+			uint32_t dauer;		// ns, reicht für gut 4 Sekunden
+			uint16_t thread;
+			Phase phase;
+		};
+
+		// Ruft f für jede Messung ab Nummer 'von' auf, bis zur neuesten.
+		// Ältere als KAPAZITAET sind schon überschrieben.
+		// Gelesen wird zwischen den Frames, wenn gerade keiner misst.
+		template<typename F>
+		void fuerAlle( uint64_t von, F f) const{
+			const uint64_t bis = m_schreibPos.load(std::memory_order_acquire);
+			if( bis - von > KAPAZITAET) von = bis - KAPAZITAET;
+			for( uint64_t i = von; i < bis; ++i) f(m_ring[i % KAPAZITAET]);
+		}
+
+		bool m_aktiv = false;
+		std::chrono::steady_clock::time_point m_anfang;
+		std::vector<Messung> m_ring;
+		std::atomic<uint64_t> m_schreibPos{0};
+		uint64_t m_fensterAnfang = 0;
+};
+
+#endif // PROFILER_H
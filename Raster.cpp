@@ -0,0 +1,31 @@
+#include "Raster.h"
+
+EinheitenRaster::EinheitenRaster( int breite, int hoehe)
+	: m_spalten((breite + ZELLE - 1) / ZELLE)
+	, m_zeilen((hoehe + ZELLE - 1) / ZELLE)
+	, m_zellenStart(m_spalten * m_zeilen + 1, 0)
+{
+}
+
+void EinheitenRaster::baue( const int *x, const int *y, unsigned int n){
+	// 1) Zählen.
+	// Wir zählen in m_zellenStart[z+1]. Dann ist nach dem Aufsummieren
+	// m_zellenStart[z] genau der Anfang von Zelle z.
+	std::fill(m_zellenStart.begin(), m_zellenStart.end(), 0);
+	for( unsigned int i = 0; i < n; ++i){
+		++m_zellenStart[zelleY(y[i]) * m_spalten + zelleX(x[i]) + 1];
+	}
+	for( size_t z = 1; z < m_zellenStart.size(); ++z){
+		m_zellenStart[z] += m_zellenStart[z-1];
+	}
+
+	// 2) Einsortieren.
+	// Wir brauchen für jede Zelle einen Zeiger, wo der nächste Eintrag hin
+	// kommt. Dafür nehmen wir eine Kopie der Anfänge.
+	m_eintraege.resize(n);
+	m_schreibPos.assign(m_zellenStart.begin(), m_zellenStart.end() - 1);
+	for( unsigned int i = 0; i < n; ++i){
+		auto z = zelleY(y[i]) * m_spalten + zelleX(x[i]);
+		m_eintraege[m_schreibPos[z]++] = {i, x[i], y[i]};
+	}
+}
@@ -0,0 +1,88 @@
+/*
+ * Das Raster.
+ *
+ * Bisher hat jeder Turm bei jeder Einheit nachgefragt, ob sie in Reichweite
+ * ist. Bei 1000 Einheiten und 100 Türmen sind das 100000 Fragen pro Frame. Die
+ * allermeisten Einheiten sind aber viel zu weit weg.
+ *
+ * Also teilen wir das Spielfeld in Zellen auf. Ein Feld ist 32px breit (siehe
+ * m_reichweite im Turm), also nehmen wir auch 32x32 große Zellen. Nach dem
+ * Bewegen der Einheiten sortieren wir jede Einheit in ihre Zelle. Ein Turm
+ * schaut danach nur noch in die Zellen, die seine Reichweite berührt.
+ *
+ * Das Einsortieren geht in zwei Durchläufen (Counting Sort):
+ * → zählen, wie viele Einheiten in jeder Zelle sind
+ * → daraus den Anfang jeder Zelle in einer großen Liste berechnen und die
+ *   Einheiten dort hinein schreiben
+ * So liegen die Einheiten einer Zelle direkt hintereinander im Speicher, und
+ * innerhalb einer Zelle bleibt die Reihenfolge der Einheiten erhalten.
+ * */
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <vector>
+#include <algorithm>
+
+
+class EinheitenRaster {
+	public:
+		static const int ZELLE = 32;
+
+		EinheitenRaster( int breite = 1024, int hoehe = 768);
+
+		// Sortiert alle n Einheiten mit den Positionen x[i], y[i] neu in das
+		// Raster ein.
+		void baue( const int *x, const int *y, unsigned int n);
+
+		// Ruft f(index, x, y) für jede Einheit auf, deren Zelle das Rechteck
+		// von (x0,y0) bis (x1,y1) berührt. index ist die Stelle der Einheit
+		// im EinheitenPool. Ob die Einheit wirklich in Reichweite ist, muss f
+		// selber prüfen.
+		template<typename F>
+		void besuche( int x0, int y0, int x1, int y1, F f) const{
+			int zx0 = zelleX(x0), zx1 = zelleX(x1);
+			int zy0 = zelleY(y0), zy1 = zelleY(y1);
+			for( int zy = zy0; zy <= zy1; ++zy){
+				// Die Zellen einer Zeile liegen direkt hintereinander. Also
+				// ist das ein zusammenhängendes Stück der Liste.
+				auto von = m_zellenStart[zy * m_spalten + zx0];
+				auto bis = m_zellenStart[zy * m_spalten + zx1 + 1];
+				for( auto i = von; i < bis; ++i){
+					const Eintrag &e = m_eintraege[i];
+					f(e.index, e.x, e.y);
+				}
+			}
+		}
+
+	private:
+		// Einheiten außerhalb des Spielfeldes landen in den Randzellen.
+		// Anfragen werden genauso abgeschnitten, so geht keiner verloren.
+		int zelleX( int x) const{
+			return std::min(std::max(x / ZELLE, 0), m_spalten - 1);
+		}
+		int zelleY( int y) const{
+			return std::min(std::max(y / ZELLE, 0), m_zeilen - 1);
+		}
+
+		// Die Position kopieren wir mit. So muss der Turm für den Abstand
+		// nicht erst in der großen Einheit nachschauen.
+		struct Eintrag{
+			unsigned int index;
+			int x;
+			int y;
+		};
+
+		int m_spalten;
+		int m_zeilen;
+
+		// m_zellenStart[z] ist die Stelle in m_eintraege, an der Zelle z
+		// anfängt. Der letzte Wert ist das Ende der letzten Zelle.
+		std::vector<unsigned int> m_zellenStart;
+		std::vector<Eintrag> m_eintraege;
+
+		// Nur beim Einsortieren gebraucht. Wir behalten den Speicher aber,
+		// damit nicht jeden Frame neu angefordert wird.
+		std::vector<unsigned int> m_schreibPos;
+};
+
+#endif // RASTER_H
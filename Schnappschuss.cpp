@@ -0,0 +1,205 @@
+#include "Schnappschuss.h"
+
+#include <algorithm>
+#include <fstream>
+
+const uint32_t Schnappschuss::VERSION;
+const size_t Schnappschuss::AUSRICHTUNG;
+
+namespace {
+
+const char DELTA_KENNUNG[4] = {'T', 'D', 'S', 'D'};
+
+// Gleiche Stücke, die kürzer sind, lohnen sich nicht: "kopiere n ab Stelle
+// q" braucht selber schon ein paar Bytes.
+const size_t MIN_GLEICH = 16;
+
+// Die Zahlen als varint, wie in Aufzeichnung.cpp.
+void schreibeZahl( std::vector<uint8_t> &aus, uint64_t zahl){
+	while( zahl >= 0x80){
+		aus.push_back((uint8_t)(0x80 | (zahl & 0x7F)));
+		zahl >>= 7;
+	}
+	aus.push_back((uint8_t)zahl);
+}
+
+uint64_t leseZahl( const std::vector<uint8_t> &ein, size_t &pos){
+	uint64_t zahl = 0;
+	for( int schiebe = 0; schiebe < 64; schiebe += 7){
+		if( pos >= ein.size()) throw std::runtime_error("Das Delta ist zu kurz");
+		uint8_t b = ein[pos++];
+		zahl |= (uint64_t)(b & 0x7F) << schiebe;
+		if( (b & 0x80) == 0) return zahl;
+	}
+	throw std::runtime_error("Das Delta ist kaputt");
+}
+
+// FNV-1a über alle Bytes, wie in Welt::pruefsumme. Damit merkt ausDelta,
+// wenn es eine andere Basis bekommt, die nur zufällig gleich groß ist.
+uint64_t pruefsumme( const std::vector<uint8_t> &daten){
+	uint64_t summe = 14695981039346656037ull;
+	for( uint8_t b:daten) summe = (summe ^ b) * 1099511628211ull;
+	return summe;
+}
+
+// Ein Befehl im Delta: die unterste Stelle sagt, ob kopiert wird (0) oder
+// neue Bytes folgen (1), der Rest ist die Länge.
+// Kopieren: danach die Stelle in der Basis.
+// Neu: danach die Bytes selber.
+struct DeltaSchreiber{
+	std::vector<uint8_t> &aus;
+	std::vector<uint8_t> neu;
+
+	void neuesByte( uint8_t b){
+		neu.push_back(b);
+	}
+
+	void neueBytes( const uint8_t *von, size_t anzahl){
+		neu.insert(neu.end(), von, von + anzahl);
+	}
+
+	void kopiere( uint64_t quelle, uint64_t anzahl){
+		schreibeNeue();
+		schreibeZahl(aus, anzahl << 1);
+		schreibeZahl(aus, quelle);
+	}
+
+	void schreibeNeue(){
+		if( neu.empty()) return;
+		schreibeZahl(aus, ((uint64_t)neu.size() << 1) | 1);
+		aus.insert(aus.end(), neu.begin(), neu.end());
+		neu.clear();
+	}
+};
+
+}
+
+Schnappschuss::Schnappschuss( std::vector<uint8_t> daten)
+	: m_daten(std::move(daten))
+{
+	if( m_daten.size() < sizeof(Kopf) || std::memcmp(kopf().kennung, "TDSS", 4) != 0){
+		throw std::runtime_error("Das ist kein Schnappschuss");
+	}
+	if( kopf().version != VERSION){
+		throw std::runtime_error("Der Schnappschuss hat Version " + std::to_string(kopf().version)
+				+ ", gebraucht wird " + std::to_string(VERSION));
+	}
+	const uint64_t verzeichnis = kopf().verzeichnis;
+	if( verzeichnis % AUSRICHTUNG != 0 || verzeichnis > m_daten.size()
+			|| (m_daten.size() - verzeichnis) / sizeof(Teil) != kopf().teile){
+		throw std::runtime_error("Das Verzeichnis des Schnappschusses ist kaputt");
+	}
+	for( size_t i = 0; i < kopf().teile; ++i){
+		const Teil &t = teil(i);
+		if( t.anfang % AUSRICHTUNG != 0 || t.anfang < sizeof(Kopf) || t.anfang > verzeichnis
+				|| t.elementGroesse == 0 || t.anzahl > (verzeichnis - t.anfang) / t.elementGroesse){
+			throw std::runtime_error("Teil " + std::to_string(i) + " des Schnappschusses ist kaputt");
+		}
+	}
+}
+
+Schnappschuss Schnappschuss::lies( const std::string &datei){
+	std::ifstream ein(datei, std::ios::binary | std::ios::ate);
+	if( !ein) throw std::runtime_error("Kann " + datei + " nicht lesen");
+	std::vector<uint8_t> daten((size_t)ein.tellg());
+	ein.seekg(0);
+	ein.read(reinterpret_cast<char*>(daten.data()), daten.size());
+	if( !ein) throw std::runtime_error("Kann " + datei + " nicht lesen");
+	return Schnappschuss(std::move(daten));
+}
+
+void Schnappschuss::schreibe( const std::string &datei) const{
+	std::ofstream aus(datei, std::ios::binary);
+	aus.write(reinterpret_cast<const char*>(m_daten.data()), m_daten.size());
+	if( !aus) throw std::runtime_error("Kann " + datei + " nicht schreiben");
+}
+
+std::vector<uint8_t> Schnappschuss::delta( const Schnappschuss &basis) const{
+	std::vector<uint8_t> aus(DELTA_KENNUNG, DELTA_KENNUNG + sizeof(DELTA_KENNUNG));
+	schreibeZahl(aus, VERSION);
+	schreibeZahl(aus, basis.m_daten.size());
+	schreibeZahl(aus, pruefsumme(basis.m_daten));
+	schreibeZahl(aus, m_daten.size());
+
+	// Teil i wird mit Teil i der Basis verglichen. Verschiebt sich ein Teil,
+	// weil davor einer länger geworden ist, findet sich so trotzdem das
+	// Gleiche. Alles zwischen den Teilen (Kopf, Verzeichnis) ist klein und
+	// kommt einfach neu.
+	DeltaSchreiber d{aus, {}};
+	size_t pos = 0;
+	const size_t teile = m_daten.empty() ? 0 : kopf().teile;
+	const size_t basisTeile = basis.m_daten.empty() ? 0 : basis.kopf().teile;
+	for( size_t i = 0; i < teile; ++i){
+		const Teil &t = teil(i);
+		d.neueBytes(m_daten.data() + pos, t.anfang - pos);
+		pos = t.anfang;
+		const size_t laenge = t.anzahl * t.elementGroesse;
+
+		size_t vergleichbar = 0;
+		size_t quelle = 0;
+		if( i < basisTeile && basis.teil(i).elementGroesse == t.elementGroesse){
+			quelle = basis.teil(i).anfang;
+			vergleichbar = std::min<size_t>(laenge, basis.teil(i).anzahl * t.elementGroesse);
+		}
+
+		size_t k = 0;
+		while( k < vergleichbar){
+			size_t gleich = 0;
+			while( k + gleich < vergleichbar
+					&& m_daten[pos + k + gleich] == basis.m_daten[quelle + k + gleich]) ++gleich;
+			if( gleich >= MIN_GLEICH){
+				d.kopiere(quelle + k, gleich);
+			}else{
+				// Die paar gleichen und das erste andere Byte kommen neu.
+				d.neueBytes(m_daten.data() + pos + k, gleich);
+				if( k + gleich < vergleichbar){
+					d.neuesByte(m_daten[pos + k + gleich]);
+					++gleich;
+				}
+			}
+			k += gleich;
+		}
+		d.neueBytes(m_daten.data() + pos + k, laenge - k);
+		pos += laenge;
+	}
+	d.neueBytes(m_daten.data() + pos, m_daten.size() - pos);
+	d.schreibeNeue();
+	return aus;
+}
+
+Schnappschuss Schnappschuss::ausDelta( const Schnappschuss &basis, const std::vector<uint8_t> &delta){
+	if( delta.size() < sizeof(DELTA_KENNUNG)
+			|| std::memcmp(delta.data(), DELTA_KENNUNG, sizeof(DELTA_KENNUNG)) != 0){
+		throw std::runtime_error("Das ist kein Delta eines Schnappschusses");
+	}
+	size_t pos = sizeof(DELTA_KENNUNG);
+	if( leseZahl(delta, pos) != VERSION) throw std::runtime_error("Das Delta hat eine andere Version");
+	if( leseZahl(delta, pos) != basis.m_daten.size()){
+		throw std::runtime_error("Das Delta gehört zu einem anderen Schnappschuss");
+	}
+	if( leseZahl(delta, pos) != pruefsumme(basis.m_daten)){
+		throw std::runtime_error("Das Delta gehört zu einem anderen Schnappschuss");
+	}
+	const uint64_t groesse = leseZahl(delta, pos);
+
+	std::vector<uint8_t> daten;
+	daten.reserve(groesse);
+	while( pos < delta.size()){
+		const uint64_t befehl = leseZahl(delta, pos);
+		const uint64_t anzahl = befehl >> 1;
+		if( anzahl > groesse - daten.size()) throw std::runtime_error("Das Delta ist kaputt");
+		if( befehl & 1){
+			if( anzahl > delta.size() - pos) throw std::runtime_error("Das Delta ist zu kurz");
+			daten.insert(daten.end(), delta.begin() + pos, delta.begin() + pos + anzahl);
+			pos += anzahl;
+		}else{
+			const uint64_t quelle = leseZahl(delta, pos);
+			if( quelle > basis.m_daten.size() || anzahl > basis.m_daten.size() - quelle){
+				throw std::runtime_error("Das Delta gehört zu einem anderen Schnappschuss");
+			}
+			daten.insert(daten.end(), basis.m_daten.begin() + quelle, basis.m_daten.begin() + quelle + anzahl);
+		}
+	}
+	if( daten.size() != groesse) throw std::runtime_error("Das Delta ist zu kurz");
+	return Schnappschuss(std::move(daten));
+}
@@ -0,0 +1,215 @@
+/*
+ * Der Schnappschuss.
+ *
+ * Bisher ließ sich eine Welt weder speichern noch kopieren. Wer wissen
+ * wollte, wie es nach Tick 500000 weitergeht, musste alles ab Tick 0 noch
+ * einmal laufen lassen (siehe Aufzeichnung.h). Jetzt schreibt jeder Teil der
+ * Welt (Einheiten, Türme, Geschosse, Zeitplaner, ...) seinen Zustand in einen
+ * Schnappschuss, und kann ihn von dort wieder laden.
+ *
+ * Ein Schnappschuss ist ein einziger flacher Block aus Bytes:
+ *   Kopf: "TDSS", Version, Anzahl der Teile, wo das Verzeichnis steht
+ *   die Teile, jeder auf 8 Bytes ausgerichtet
+ *   das Verzeichnis: pro Teil Anfang, Anzahl und Größe eines Elements
+ * Ein Teil ist ein Array aus einfachen Werten, genau so, wie sie auch im
+ * Speicher liegen (die Arrays aus EinheitenPool.h passen direkt hinein). Es
+ * gibt keine Zeiger darin, nur Abstände vom Anfang. Gelesen wird die Datei
+ * darum mit einem read am Stück (oder einfach per mmap), danach gibt es nur
+ * noch einen Durchgang, der die Zeiger wieder einsetzt: Arten, Texturen und
+ * Wegpunkte, siehe Welt::lade.
+ *
+ * Geschrieben und gelesen werden die Teile immer in der gleichen
+ * Reihenfolge. Ändert sich daran etwas, muss VERSION hoch.
+ *
+ * Für viele Schnappschüsse hintereinander (alle paar Sekunden bei einem
+ * langen Lauf) gibt es außerdem das Delta: nur die Bytes, die sich gegenüber
+ * einem älteren Schnappschuss geändert haben. Meistens sind das nur die
+ * Positionen, der Rest wird als "wie dort an Stelle n" gespeichert. Vorne
+ * im Delta stehen Größe und Prüfsumme der Basis, damit es nicht auf eine
+ * andere Basis angewendet wird.
+ * */
+#ifndef SCHNAPPSCHUSS_H
+#define SCHNAPPSCHUSS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class Schnappschuss {
+	public:
+		static const uint32_t VERSION = 4;
+
+		Schnappschuss() = default;
+
+		// Prüft Kennung, Version und Verzeichnis. Wirft std::runtime_error,
+		// wenn etwas nicht passt.
+		explicit Schnappschuss( std::vector<uint8_t> daten);
+
+		// Liest eine Datei am Stück. Wirft std::runtime_error.
+		static Schnappschuss lies( const std::string &datei);
+
+		// Wirft std::runtime_error, wenn die Datei nicht geschrieben werden
+		// kann.
+		void schreibe( const std::string &datei) const;
+
+		const std::vector<uint8_t> &daten() const{
+			return m_daten;
+		}
+
+		// Was sich gegenüber 'basis' geändert hat. Ganz klein, wenn sich
+		// wenig geändert hat.
+		std::vector<uint8_t> delta( const Schnappschuss &basis) const;
+
+		// Setzt aus 'basis' und einem delta() wieder den ganzen Schnappschuss
+		// zusammen. Wirft std::runtime_error, wenn das Delta nicht zu
+		// 'basis' passt (andere Größe oder andere Prüfsumme).
+		static Schnappschuss ausDelta( const Schnappschuss &basis, const std::vector<uint8_t> &delta);
+
+		class Schreiber;
+		class Leser;
+
+	private:
+		struct Kopf{
+			char kennung[4];
+			uint32_t version;
+			uint64_t teile;
+			uint64_t verzeichnis;	// Abstand vom Anfang
+		};
+
+		struct Teil{
+			uint64_t anfang;		// Abstand vom Anfang
+			uint64_t anzahl;
+			uint32_t elementGroesse;
+			uint32_t frei;
+		};
+
+		static const size_t AUSRICHTUNG = 8;
+
+		const Kopf &kopf() const{
+			return *reinterpret_cast<const Kopf*>(m_daten.data());
+		}
+		const Teil &teil( size_t i) const{
+			return reinterpret_cast<const Teil*>(m_daten.data() + kopf().verzeichnis)[i];
+		}
+
+		std::vector<uint8_t> m_daten;
+};
+
+// Schreibt Teil für Teil in einen neuen Schnappschuss.
+//
+//   Schnappschuss::Schreiber s;
+//   s.wert(m_zeit);
+//   s.feld(m_ereignisse);
+//   Schnappschuss fertig = s.fertig();
+class Schnappschuss::Schreiber {
+	public:
+		Schreiber()
+			: m_daten(sizeof(Kopf), 0)
+		{}
+
+		template<typename T>
+		void feld( const T *werte, size_t anzahl){
+			static_assert(std::is_trivially_copyable<T>::value,
+					"In einen Schnappschuss passen nur einfache Werte");
+			static_assert(alignof(T) <= AUSRICHTUNG, "Zu stark ausgerichtet");
+			m_daten.resize((m_daten.size() + AUSRICHTUNG - 1) / AUSRICHTUNG * AUSRICHTUNG, 0);
+			m_teile.push_back({m_daten.size(), anzahl, sizeof(T), 0});
+			const uint8_t *bytes = reinterpret_cast<const uint8_t*>(werte);
+			m_daten.insert(m_daten.end(), bytes, bytes + anzahl * sizeof(T));
+		}
+
+		template<typename T>
+		void feld( const std::vector<T> &werte){
+			feld(werte.data(), werte.size());
+		}
+
+		template<typename T>
+		void wert( const T &w){
+			feld(&w, 1);
+		}
+
+		// Hängt das Verzeichnis an. Danach ist der Schreiber leer.
+		Schnappschuss fertig(){
+			m_daten.resize((m_daten.size() + AUSRICHTUNG - 1) / AUSRICHTUNG * AUSRICHTUNG, 0);
+			Kopf kopf{{'T', 'D', 'S', 'S'}, VERSION, m_teile.size(), m_daten.size()};
+			std::memcpy(m_daten.data(), &kopf, sizeof(kopf));
+			const uint8_t *bytes = reinterpret_cast<const uint8_t*>(m_teile.data());
+			m_daten.insert(m_daten.end(), bytes, bytes + m_teile.size() * sizeof(Teil));
+
+			Schnappschuss s;
+			s.m_daten.swap(m_daten);
+			m_daten.assign(sizeof(Kopf), 0);
+			m_teile.clear();
+			return s;
+		}
+
+	private:
+		std::vector<uint8_t> m_daten;
+		std::vector<Teil> m_teile;
+};
+
+// Liest die Teile in der gleichen Reihenfolge wieder heraus. Passt ein Teil
+// nicht (zu wenige, falsche Größe), gibt es std::runtime_error.
+class Schnappschuss::Leser {
+	public:
+		explicit Leser( const Schnappschuss &s)
+			: m_schnappschuss(s)
+		{
+			if( s.m_daten.empty()) throw std::runtime_error("Der Schnappschuss ist leer");
+		}
+
+		// Der nächste Teil, ohne Kopie. Zeigt direkt in den Schnappschuss.
+		template<typename T>
+		const T *zeiger( size_t &anzahl){
+			static_assert(std::is_trivially_copyable<T>::value,
+					"In einem Schnappschuss sind nur einfache Werte");
+			if( m_naechster >= m_schnappschuss.kopf().teile){
+				throw std::runtime_error("Im Schnappschuss fehlt etwas");
+			}
+			const Teil &t = m_schnappschuss.teil(m_naechster++);
+			if( t.elementGroesse != sizeof(T)){
+				throw std::runtime_error("Im Schnappschuss passt Teil "
+						+ std::to_string(m_naechster - 1) + " nicht");
+			}
+			anzahl = t.anzahl;
+			return reinterpret_cast<const T*>(m_schnappschuss.m_daten.data() + t.anfang);
+		}
+
+		template<typename T>
+		void feld( std::vector<T> &werte){
+			size_t anzahl;
+			const T *p = zeiger<T>(anzahl);
+			werte.assign(p, p + anzahl);
+		}
+
+		// Genau 'anzahl' Werte nach 'ziel'.
+		template<typename T>
+		void feld( T *ziel, size_t anzahl){
+			size_t vorhanden;
+			const T *p = zeiger<T>(vorhanden);
+			if( vorhanden != anzahl) throw std::runtime_error("Im Schnappschuss passt eine Anzahl nicht");
+			std::memcpy(static_cast<void*>(ziel), p, anzahl * sizeof(T));
+		}
+
+		template<typename T>
+		T wert(){
+			T w;
+			feld(&w, 1);
+			return w;
+		}
+
+		// Wurde alles gelesen?
+		bool amEnde() const{
+			return m_naechster == m_schnappschuss.kopf().teile;
+		}
+
+	private:
+		const Schnappschuss &m_schnappschuss;
+		size_t m_naechster = 0;
+};
+
+#endif // SCHNAPPSCHUSS_H
@@ -0,0 +1,183 @@
+/*
+ * Ein kleines Programm, das misst, was neue Einheiten und Türme kosten.
+ *
+ * Früher hatte die Einheit einen eigenen Kopierkonstruktor und damit keinen
+ * Move-Konstruktor (siehe Einheit.h). Zum Vergleich gibt es die hier als
+ * AlteEinheit noch einmal. Gemessen wird:
+ * → ein std::vector wächst um eine Einheit nach der anderen, mit der alten
+ *   und der neuen Einheit
+ * → ein voller std::vector zieht um (das passiert beim Wachsen immer wieder)
+ * → das Gleiche mit dem EinheitenPool, so wie die Welt heute spawnt
+ * → ein std::vector<Turm> wächst um einen Turm nach dem anderen, mit dem
+ *   alten Turm (der sich bei jeder Kopie einen Timer holte und ihn im
+ *   Destruktor wieder abgab) als AlterTurm und dem neuen
+ * → Türme sperren ihre Zelle im Flussfeld, so wie beim Bauen im Spiel
+ *
+ *   TD_Bench_Spawn [einheiten] [runden]
+ * */
+#include "Einheit.h"
+#include "EinheitenPool.h"
+#include "Flussfeld.h"
+#include "Turm.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+// So wie früher: ein eigener Kopierkonstruktor, also kein Move. Beim Wachsen
+// wird jede Einheit kopiert.
+struct AlteEinheit : Einheit{
+	explicit AlteEinheit( const Einheit &e) : Einheit(e){}
+	AlteEinheit( const AlteEinheit &e) : Einheit(e){}
+};
+
+// Was SDL_AddTimer und SDL_RemoveTimer für jeden Turm taten: unter einem
+// Lock einen Eintrag anlegen und wieder austragen. Den Thread, der die Timer
+// auslöst, lassen wir weg, der würde die Messung nur verrauschen.
+struct AlteTimer{
+	std::mutex mutex;
+	std::unordered_map<int, const void*> eintraege;
+	int naechster = 1;
+
+	int hinzu( const void *turm){
+		std::lock_guard<std::mutex> lock(mutex);
+		eintraege.emplace(naechster, turm);
+		return naechster++;
+	}
+
+	void weg( int id){
+		std::lock_guard<std::mutex> lock(mutex);
+		eintraege.erase(id);
+	}
+};
+AlteTimer alteTimer;
+
+// So wie früher: jede Kopie holt sich einen eigenen Timer zum Nachladen,
+// der Destruktor gibt ihn wieder ab. Kein Move, beim Wachsen wird kopiert.
+struct AlterTurm : Turm{
+	explicit AlterTurm( const Turm &t) : Turm(t), m_timerID(alteTimer.hinzu(this)){}
+	AlterTurm( const AlterTurm &t) : Turm(t), m_timerID(alteTimer.hinzu(this)){}
+	AlterTurm& operator=( const AlterTurm&) = delete;
+	~AlterTurm(){ alteTimer.weg(m_timerID); }
+
+	int m_timerID;
+};
+
+template<typename F>
+double nsPro( size_t anzahl, int runden, F f){
+	auto vorher = std::chrono::steady_clock::now();
+	for( int r = 0; r < runden; ++r) f();
+	auto dauer = std::chrono::steady_clock::now() - vorher;
+	return std::chrono::duration<double, std::nano>(dauer).count() / (double(anzahl) * runden);
+}
+
+// Damit der Compiler die Arbeit nicht wegoptimiert.
+volatile size_t senke = 0;
+
+template<typename T>
+double wachsen( const Einheit &vorlage, size_t anzahl, int runden){
+	return nsPro(anzahl, runden, [&]{
+			std::vector<T> einheiten;
+			for( size_t i = 0; i < anzahl; ++i) einheiten.emplace_back(vorlage);
+			senke = senke + einheiten.size();
+		});
+}
+
+template<typename T>
+double tuermeAufstellen( const Turm &vorlage, size_t anzahl, int runden){
+	return nsPro(anzahl, runden, [&]{
+			std::vector<T> tuerme;
+			for( size_t i = 0; i < anzahl; ++i) tuerme.emplace_back(vorlage);
+			senke = senke + tuerme.size();
+		});
+}
+
+// Nur das Umziehen: der vector ist voll und bekommt mehr Platz.
+template<typename T>
+double umziehen( const Einheit &vorlage, size_t anzahl, int runden){
+	std::chrono::steady_clock::duration dauer{0};
+	for( int r = 0; r < runden; ++r){
+		std::vector<T> einheiten;
+		einheiten.reserve(anzahl);
+		for( size_t i = 0; i < anzahl; ++i) einheiten.emplace_back(vorlage);
+
+		auto vorher = std::chrono::steady_clock::now();
+		einheiten.reserve(2 * anzahl);
+		dauer += std::chrono::steady_clock::now() - vorher;
+		senke = senke + einheiten.capacity();
+	}
+	return std::chrono::duration<double, std::nano>(dauer).count() / (double(anzahl) * runden);
+}
+
+}
+
+int main( int argc, char **argv){
+	size_t anzahl = argc > 1 ? std::stoul(argv[1]) : 100000;
+	int runden = argc > 2 ? std::stoi(argv[2]) : 20;
+
+	auto wegpunkte = std::make_shared<WaypointList>(WaypointList{
+			{{0, 0}}, {{1024-32, 0}}, {{0, 768-32}}, {{1024-32, 768-32}}, {{0, 0}}});
+	const Arten arten = Arten::standard();
+	Einheit vorlage;
+	vorlage.init(arten, 0, 0, 0);
+	vorlage.setzeWegpunkte(wegpunkte);
+
+	std::cout << "[BENCH] " << anzahl << " Einheiten, " << runden << " Runden" << std::endl;
+	std::cout << "[BENCH] vector<Einheit> nur Kopie (vorher): "
+		<< wachsen<AlteEinheit>(vorlage, anzahl, runden) << " ns pro Einheit" << std::endl;
+	std::cout << "[BENCH] vector<Einheit> mit Move (nachher): "
+		<< wachsen<Einheit>(vorlage, anzahl, runden) << " ns pro Einheit" << std::endl;
+	std::cout << "[BENCH] Umziehen nur Kopie (vorher): "
+		<< umziehen<AlteEinheit>(vorlage, anzahl, runden) << " ns pro Einheit" << std::endl;
+	std::cout << "[BENCH] Umziehen mit Move (nachher): "
+		<< umziehen<Einheit>(vorlage, anzahl, runden) << " ns pro Einheit" << std::endl;
+
+	std::cout << "[BENCH] EinheitenPool einzeln: "
+		<< nsPro(anzahl, runden, [&]{
+				EinheitenPool pool;
+				pool.setzeArten(&arten);
+				for( size_t i = 0; i < anzahl; ++i) pool.fuegeHinzu(vorlage);
+				senke = senke + pool.size();
+			}) << " ns pro Einheit" << std::endl;
+	std::cout << "[BENCH] EinheitenPool auf einmal: "
+		<< nsPro(anzahl, runden, [&]{
+				EinheitenPool pool;
+				pool.setzeArten(&arten);
+				pool.fuegeHinzu(vorlage, anzahl);
+				senke = senke + pool.size();
+			}) << " ns pro Einheit" << std::endl;
+
+	Turm turm;
+	turm.init(arten, 0, 0, 0);
+	std::cout << "[BENCH] vector<Turm> mit Timer (vorher): "
+		<< tuermeAufstellen<AlterTurm>(turm, anzahl, runden) << " ns pro Turm" << std::endl;
+	std::cout << "[BENCH] vector<Turm> ohne Timer (nachher): "
+		<< tuermeAufstellen<Turm>(turm, anzahl, runden) << " ns pro Turm" << std::endl;
+
+	// Jede zweite Zelle in jeder zweiten Reihe, in zufälliger Reihenfolge.
+	// So bleibt immer ein Weg frei.
+	std::vector<SDL_Rect> plaetze;
+	for( int y = 0; y < 768; y += 2 * Flussfeld::ZELLE){
+		for( int x = 0; x < 1024; x += 2 * Flussfeld::ZELLE){
+			plaetze.push_back({x, y, 32, 32});
+		}
+	}
+	std::minstd_rand zufall(42);
+	std::shuffle(plaetze.begin(), plaetze.end(), zufall);
+	std::cout << "[BENCH] Flussfeld sperren (mit Aufbau): "
+		<< nsPro(plaetze.size(), runden, [&]{
+				Flussfeld feld;
+				feld.setzeZiel(1024-32, 768-32);
+				for( auto &p:plaetze) feld.blockiere(p);
+				senke = senke + feld.erreichbar(0, 0);
+			}) << " ns pro Turm" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,89 @@
+#include "Speicher.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> anforderungen{0};
+
+// Ein einfaches bool, das braucht beim ersten Zugriff selber kein new.
+thread_local bool zaehlen = false;
+
+void *hole( std::size_t groesse){
+	if( zaehlen) anforderungen.fetch_add(1, std::memory_order_relaxed);
+	// new mit 0 muss trotzdem einen eigenen Zeiger liefern.
+	if( groesse == 0) groesse = 1;
+	for( ;;){
+		void *p = std::malloc(groesse);
+		if( p != nullptr) return p;
+		// So wie das eingebaute new: erst den new_handler fragen, ob er
+		// noch etwas frei machen kann.
+		std::new_handler handler = std::get_new_handler();
+		if( handler == nullptr) throw std::bad_alloc();
+		handler();
+	}
+}
+
+}
+
+uint64_t speicherAnforderungen(){
+	return anforderungen.load(std::memory_order_relaxed);
+}
+
+bool speicherWirdGezaehlt(){
+	return zaehlen;
+}
+
+SpeicherZaehlen::SpeicherZaehlen( bool an)
+	: m_vorher(zaehlen)
+{
+	zaehlen = an;
+}
+
+SpeicherZaehlen::~SpeicherZaehlen(){
+	zaehlen = m_vorher;
+}
+
+// Die Ersatzfunktionen. Alle anderen Formen von new und delete ruft die
+// Standardbibliothek über diese auf.
+void *operator new( std::size_t groesse){
+	return hole(groesse);
+}
+
+void *operator new[]( std::size_t groesse){
+	return hole(groesse);
+}
+
+void *operator new( std::size_t groesse, const std::nothrow_t&) noexcept{
+	try{
+		return hole(groesse);
+	}catch( const std::bad_alloc&){
+		return nullptr;
+	}
+}
+
+void *operator new[]( std::size_t groesse, const std::nothrow_t&) noexcept{
+	try{
+		return hole(groesse);
+	}catch( const std::bad_alloc&){
+		return nullptr;
+	}
+}
+
+void operator delete( void *p) noexcept{
+	std::free(p);
+}
+
+void operator delete[]( void *p) noexcept{
+	std::free(p);
+}
+
+void operator delete( void *p, const std::nothrow_t&) noexcept{
+	std::free(p);
+}
+
+void operator delete[]( void *p, const std::nothrow_t&) noexcept{
+	std::free(p);
+}
@@ -0,0 +1,45 @@
+/*
+ * Wie oft wird Speicher angefordert?
+ *
+ * Jedes new (und damit auch jedes Wachsen eines std::vector, jede Kopie eines
+ * std::string, ...) geht am Ende zum Heap. Das kostet Zeit, und mitten in
+ * einem Frame wollen wir das eigentlich gar nicht. Ob das stimmt, sieht man
+ * dem Code aber nicht an.
+ *
+ * Also zählen wir mit: Speicher.cpp ersetzt den globalen operator new und
+ * zählt jeden Aufruf. Ohne Fenster zeigt der Benchmark dann an, wie oft pro
+ * Tick Speicher angefordert wurde (siehe Headless.cpp). Wenn das Spiel
+ * eingeschwungen ist, sollte das 0 sein.
+ *
+ * Gezählt wird aber nur in Threads, die gerade die Simulation rechnen (siehe
+ * SpeicherZaehlen). Was das Logbuch oder der Bildfang in ihren eigenen
+ * Threads holen, gehört nicht zum Frame. Jobs aus dem JobSystem zählen, wenn
+ * der Thread zählt, der sie verteilt.
+ * */
+#ifndef SPEICHER_H
+#define SPEICHER_H
+
+#include <cstdint>
+
+// Wie oft wurde bisher Speicher angefordert? Nur in Threads, die dabei
+// gezählt haben.
+uint64_t speicherAnforderungen();
+
+// Zählt dieser Thread gerade mit?
+bool speicherWirdGezaehlt();
+
+// Solange es ihn gibt, zählt dieser Thread mit (oder mit 'an' false eben
+// nicht). Danach wieder so wie vorher.
+class SpeicherZaehlen {
+	public:
+		explicit SpeicherZaehlen( bool an = true);
+		~SpeicherZaehlen();
+
+		SpeicherZaehlen( const SpeicherZaehlen&) = delete;
+		SpeicherZaehlen& operator=( const SpeicherZaehlen&) = delete;
+
+	private:
+		const bool m_vorher;
+};
+
+#endif // SPEICHER_H
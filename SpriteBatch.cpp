@@ -0,0 +1,145 @@
+#include "SpriteBatch.h"
+
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+
+void SpriteBatch::zeichne( SDL_Texture *texture, const SDL_Rect *quelle, const SDL_Rect &ziel){
+	const float x0 = ziel.x, y0 = ziel.y;
+	const float x1 = ziel.x + ziel.w, y1 = ziel.y + ziel.h;
+	const float x[4] = {x0, x1, x1, x0};
+	const float y[4] = {y0, y0, y1, y1};
+	viereck(stapelFuer(texture), x, y, SDL_Color{255, 255, 255, 255}, quelle);
+	if( m_flecken != nullptr) m_flecken->markiere(ziel);
+}
+
+void SpriteBatch::linie( int x1, int y1, int x2, int y2, SDL_Color farbe){
+	m_linien.push_back({x1, y1, x2, y2, farbe});
+	if( m_flecken != nullptr){
+		m_flecken->markiere(std::min(x1, x2), std::min(y1, y2), std::max(x1, x2) + 1, std::max(y1, y2) + 1);
+	}
+}
+
+void SpriteBatch::absenden( SDL_Renderer *renderer){
+	auto vorher = std::chrono::steady_clock::now();
+	m_zeichenAufrufe = 0;
+
+#if TD_RENDER_GEOMETRY
+	for( auto &stapel:m_stapel){
+		if( stapel.ecken.empty()) continue;
+		SDL_RenderGeometry(renderer, stapel.texture,
+				stapel.ecken.data(), stapel.ecken.size(),
+				stapel.indizes.data(), stapel.indizes.size());
+		++m_zeichenAufrufe;
+	}
+
+	// Aus jeder Linie wird ein Viereck, das einen halben Pixel zu jeder
+	// Seite absteht. Dafür brauchen wir die Richtung senkrecht zur Linie.
+	for( auto &l:m_linien){
+		float dx = l.x2 - l.x1;
+		float dy = l.y2 - l.y1;
+		float laenge = std::sqrt(dx*dx + dy*dy);
+		float nx = 0.0f, ny = 0.5f;
+		if( laenge > 0.0f){
+			nx = -dy / laenge * 0.5f;
+			ny = dx / laenge * 0.5f;
+		}
+		// Durch die Mitte der Pixel, wie bei SDL_RenderDrawLine.
+		const float ax = l.x1 + 0.5f, ay = l.y1 + 0.5f;
+		const float bx = l.x2 + 0.5f, by = l.y2 + 0.5f;
+		const float x[4] = {ax + nx, bx + nx, bx - nx, ax - nx};
+		const float y[4] = {ay + ny, by + ny, by - ny, ay - ny};
+		viereck(m_linienStapel, x, y, l.farbe);
+	}
+	if( !m_linienStapel.ecken.empty()){
+		SDL_RenderGeometry(renderer, nullptr,
+				m_linienStapel.ecken.data(), m_linienStapel.ecken.size(),
+				m_linienStapel.indizes.data(), m_linienStapel.indizes.size());
+		++m_zeichenAufrufe;
+	}
+	m_linienStapel.ecken.clear();
+	m_linienStapel.indizes.clear();
+#else
+	// Wie früher: jedes Bild einzeln. Die Ecken 0 und 2 sind oben links
+	// und unten rechts. Das Rechteck in der Texture rechnen wir aus den
+	// Texturkoordinaten zurück.
+	for( auto &stapel:m_stapel){
+		for( size_t i = 0; i < stapel.ecken.size(); i += 4){
+			auto &a = stapel.ecken[i];
+			auto &c = stapel.ecken[i+2];
+			SDL_Rect ziel{(int)a.position.x, (int)a.position.y,
+				(int)(c.position.x - a.position.x), (int)(c.position.y - a.position.y)};
+			int qx = std::lround(a.tex_coord.x * stapel.breite);
+			int qy = std::lround(a.tex_coord.y * stapel.hoehe);
+			SDL_Rect quelle{qx, qy,
+				(int)std::lround(c.tex_coord.x * stapel.breite) - qx,
+				(int)std::lround(c.tex_coord.y * stapel.hoehe) - qy};
+			SDL_RenderCopy(renderer, stapel.texture, &quelle, &ziel);
+			++m_zeichenAufrufe;
+		}
+	}
+	if( !m_linien.empty()){
+		// Die Farbe merken und danach wieder setzen. Man kann ja nicht
+		// wissen, was andere zuvor angestellt haben...
+		Uint8 rgba[4];
+		SDL_GetRenderDrawColor(renderer, &rgba[0], &rgba[1], &rgba[2], &rgba[3]);
+		for( auto &l:m_linien){
+			SDL_SetRenderDrawColor(renderer, l.farbe.r, l.farbe.g, l.farbe.b, l.farbe.a);
+			SDL_RenderDrawLine(renderer, l.x1, l.y1, l.x2, l.y2);
+			++m_zeichenAufrufe;
+		}
+		SDL_SetRenderDrawColor(renderer, rgba[0], rgba[1], rgba[2], rgba[3]);
+	}
+#endif
+
+	for( auto &stapel:m_stapel){
+		stapel.ecken.clear();
+		stapel.indizes.clear();
+	}
+	m_linien.clear();
+
+	m_mikrosekunden = std::chrono::duration<double, std::micro>(
+			std::chrono::steady_clock::now() - vorher).count();
+}
+
+SpriteBatch::Stapel &SpriteBatch::stapelFuer( SDL_Texture *texture){
+	for( auto &stapel:m_stapel){
+		if( stapel.texture == texture) return stapel;
+	}
+	// Die Größe brauchen wir für die Texturkoordinaten. Einmal fragen
+	// reicht.
+	int breite = 1, hoehe = 1;
+	if( texture != nullptr) SDL_QueryTexture(texture, nullptr, nullptr, &breite, &hoehe);
+	m_stapel.push_back({texture, std::max(1, breite), std::max(1, hoehe), {}, {}});
+	return m_stapel.back();
+}
+
+void SpriteBatch::viereck( Stapel &stapel, const float (&x)[4], const float (&y)[4],
+		SDL_Color farbe, const SDL_Rect *quelle){
+	// Die Texturkoordinaten gehen von 0,0 (oben links) bis 1,1 (unten rechts)
+	// der ganzen Texture. Für einen Teil davon rechnen wir die Pixel um.
+	float u0 = 0.0f, v0 = 0.0f, u1 = 1.0f, v1 = 1.0f;
+	if( quelle != nullptr){
+		u0 = (float)quelle->x / stapel.breite;
+		v0 = (float)quelle->y / stapel.hoehe;
+		u1 = (float)(quelle->x + quelle->w) / stapel.breite;
+		v1 = (float)(quelle->y + quelle->h) / stapel.hoehe;
+	}
+	const float u[4] = {u0, u1, u1, u0};
+	const float v[4] = {v0, v0, v1, v1};
+
+	const int erste = stapel.ecken.size();
+	for( int i = 0; i < 4; ++i){
+		BatchVertex ecke;
+		ecke.position.x = x[i];
+		ecke.position.y = y[i];
+		ecke.color = farbe;
+		ecke.tex_coord.x = u[i];
+		ecke.tex_coord.y = v[i];
+		stapel.ecken.push_back(ecke);
+	}
+
+	// Zwei Dreiecke: 0,1,2 und 0,2,3
+	static const int dreiecke[6] = {0, 1, 2, 0, 2, 3};
+	for( int i:dreiecke) stapel.indizes.push_back(erste + i);
+}
@@ -0,0 +1,113 @@
+/*
+ * Der SpriteBatch.
+ *
+ * Bisher zeichnet jede Einheit und jeder Turm sich selber mit einem
+ * SDL_RenderCopy, und jeder Schuss ist ein eigenes SDL_RenderDrawLine. Jeder
+ * dieser Aufrufe kostet etwas, egal wie klein das Bild ist. Bei tausenden
+ * Einheiten ist der Renderer fast nur noch mit den Aufrufen beschäftigt.
+ *
+ * Der SpriteBatch sammelt erst einmal alles, was in einem Frame gezeichnet
+ * werden soll. Pro Texture gibt es eine Liste von Ecken (Vertices): jedes Bild
+ * ist ein Viereck aus zwei Dreiecken. Am Ende des Frames geht jede Liste mit
+ * einem einzigen SDL_RenderGeometry an den Renderer. Die Schüsse werden zu
+ * dünnen Vierecken ohne Texture und gehen zusammen in einem weiteren Aufruf.
+ *
+ * SDL_RenderGeometry gibt es erst seit SDL 2.0.18. Mit einem älteren SDL wird
+ * wie früher jedes Bild und jede Linie einzeln gezeichnet.
+ *
+ * Gezeichnet wird in der Reihenfolge, in der die Texturen das erste Mal
+ * aufgetaucht sind. Die Schüsse kommen immer zum Schluss.
+ * */
+#ifndef SPRITEBATCH_H
+#define SPRITEBATCH_H
+
+#include <SDL.h>
+
+#include "Flecken.h"
+
+#include <vector>
+
+// Ohne SDL_RenderGeometry haben wir auch kein SDL_Vertex. Dann nehmen wir
+// unseren eigenen, er wird ja eh nur zum Sammeln benutzt.
+#if SDL_VERSION_ATLEAST(2,0,18)
+#define TD_RENDER_GEOMETRY 1
+typedef SDL_Vertex BatchVertex;
+#else
+#define TD_RENDER_GEOMETRY 0
+struct BatchVertex{
+	struct{ float x, y; } position;
+	SDL_Color color;
+	struct{ float x, y; } tex_coord;
+};
+#endif
+
+// Ein Bild: ein Rechteck aus einer Texture, zB aus dem Atlas (siehe Atlas.h).
+struct Sprite{
+	SDL_Texture *texture;
+	SDL_Rect quelle;
+};
+
+class SpriteBatch {
+	public:
+		// Ein Bild: der Teil 'quelle' der Texture in das Rechteck 'ziel'.
+		// Ohne quelle die ganze Texture.
+		void zeichne( SDL_Texture *texture, const SDL_Rect *quelle, const SDL_Rect &ziel);
+		void zeichne( SDL_Texture *texture, const SDL_Rect &ziel){
+			zeichne(texture, nullptr, ziel);
+		}
+
+		// Eine Linie, 1 Pixel breit.
+		void linie( int x1, int y1, int x2, int y2, SDL_Color farbe);
+
+		// Ab jetzt wird jedes Bild und jede Linie auch in 'flecken'
+		// markiert, siehe Hintergrund.h. nullptr schaltet das wieder ab.
+		void setzeFlecken( Flecken *flecken){
+			m_flecken = flecken;
+		}
+
+		// Schickt alles Gesammelte an den Renderer und fängt von vorne an.
+		void absenden( SDL_Renderer *renderer);
+
+		// Wie viele Aufrufe an den Renderer hat das letzte absenden()
+		// gebraucht, und wie lange hat es gedauert?
+		unsigned int zeichenAufrufe() const{
+			return m_zeichenAufrufe;
+		}
+		double mikrosekunden() const{
+			return m_mikrosekunden;
+		}
+
+	private:
+		// Alles, was mit der gleichen Texture gezeichnet wird.
+		// Die Schüsse haben die Texture nullptr.
+		struct Stapel{
+			SDL_Texture *texture;
+			int breite;		// Größe der Texture, für die Texturkoordinaten
+			int hoehe;
+			std::vector<BatchVertex> ecken;
+			std::vector<int> indizes;
+		};
+
+		struct Linie{
+			int x1, y1, x2, y2;
+			SDL_Color farbe;
+		};
+
+		Stapel &stapelFuer( SDL_Texture *texture);
+		void viereck( Stapel &stapel, const float (&x)[4], const float (&y)[4],
+				SDL_Color farbe, const SDL_Rect *quelle = nullptr);
+
+		// Meistens nur eine Handvoll Texturen, da reicht eine Liste.
+		// Die Stapel bleiben zwischen den Frames stehen, dann müssen die
+		// std::vector nicht jedes Mal neuen Speicher holen.
+		std::vector<Stapel> m_stapel;
+		std::vector<Linie> m_linien;
+		Stapel m_linienStapel{nullptr, 1, 1, {}, {}};
+
+		Flecken *m_flecken = nullptr;
+
+		unsigned int m_zeichenAufrufe = 0;
+		double m_mikrosekunden = 0;
+};
+
+#endif // SPRITEBATCH_H
@@ -0,0 +1,331 @@
+#include "Stapel.h"
+
+#include "Welt.h"
+#include "Logbuch.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <exception>
+#include <stdexcept>
+
+// Wie in Headless.cpp: SDL_GetTicks ist für die Messung zu grob.
+#include <chrono>
+#include <thread>
+
+namespace {
+
+// Eine Zeile aus der Raster-Datei: ein Wert der Arten, an dem wir drehen,
+// und was wir dafür ausprobieren. Welche Werte es gibt und wie sie in die
+// Arten kommen, weiß Arten::setzeWert. Die Werte bleiben darum Text, auch
+// "zielwahl vorderste" geht.
+struct Parameter{
+	std::string name;
+	std::vector<std::string> werte;
+};
+
+struct StapelOptionen{
+	std::string datei;			// Die Raster-Datei
+	std::vector<Parameter> raster;
+	long ticks = 120000;		// Höchstens so viele Ticks pro Lauf
+	int dt = 1;					// Simulierte Zeit pro Tick in ms
+	int tuerme = 20;
+	uint32_t anzahl = 200;		// Einheiten in der Welle
+	Uint32 intervall = 100;		// ms zwischen zwei Einheiten
+	std::string weg = "wegpunkte";	// wegpunkte, pfad oder fluss
+	unsigned int threads = 0;	// 0 = so viele wie Kerne
+	std::string csv = "stapel.csv";
+	std::string turmCsv;		// Wenn gesetzt: eine Zeile pro Lauf und Turm
+
+	// Die Arten, siehe Arten.h. Die Werte aus dem Raster ändern in jedem
+	// Lauf eine Kopie der Arten 'einheitArt' und 'turmArt'.
+	std::string artenDatei;
+	Arten arten;
+	std::string einheitArt = "gegner";
+	std::string turmArt = "turm";
+};
+
+// Was bei einem Lauf heraus kommt.
+struct Ergebnis{
+	uint64_t entkommen = 0;		// Durchgekommen
+	size_t uebrig = 0;			// Nach dem letzten Tick noch unterwegs
+	Uint32 gespielt = 0;		// Simulierte ms, bis alle weg waren
+	long ticks = 0;
+	// Pro Turm: x, y, Abschüsse
+	std::vector<std::array<int,3>> tuerme;
+};
+
+const char *wert( int &i, int argc, char **argv){
+	if( i + 1 >= argc){
+		throw std::runtime_error(std::string("Wert fehlt nach ") + argv[i]);
+	}
+	return argv[++i];
+}
+
+std::vector<Parameter> leseRaster( const std::string &datei){
+	std::ifstream ein(datei);
+	if( !ein) throw std::runtime_error("Kann " + datei + " nicht lesen");
+
+	std::vector<Parameter> raster;
+	std::string zeile;
+	int nummer = 0;
+	while( std::getline(ein, zeile)){
+		++nummer;
+		auto kommentar = zeile.find('#');
+		if( kommentar != std::string::npos) zeile.erase(kommentar);
+
+		std::istringstream woerter(zeile);
+		std::string name;
+		if( !(woerter >> name)) continue;
+
+		if( !Arten::gibtWert(name)){
+			throw std::runtime_error(datei + ":" + std::to_string(nummer) + ": Unbekannter Wert " + name);
+		}
+		for( auto &p:raster){
+			if( p.name == name){
+				throw std::runtime_error(datei + ":" + std::to_string(nummer) + ": " + name + " steht doppelt da");
+			}
+		}
+		Parameter p{name, {}};
+		std::string w;
+		while( woerter >> w) p.werte.push_back(w);
+		if( p.werte.empty()){
+			throw std::runtime_error(datei + ":" + std::to_string(nummer) + ": " + name + " ohne Werte");
+		}
+		raster.push_back(p);
+	}
+	return raster;
+}
+
+StapelOptionen leseOptionen( int argc, char **argv){
+	StapelOptionen o;
+	for( int i = 1; i < argc; ++i){
+		std::string arg = argv[i];
+		if( arg == "--stapel") o.datei = wert(i, argc, argv);
+		else if( arg == "--ticks") o.ticks = std::stol(wert(i, argc, argv));
+		else if( arg == "--dt") o.dt = std::stoi(wert(i, argc, argv));
+		else if( arg == "--tuerme") o.tuerme = std::stoi(wert(i, argc, argv));
+		else if( arg == "--anzahl") o.anzahl = std::stoul(wert(i, argc, argv));
+		else if( arg == "--intervall") o.intervall = std::stoul(wert(i, argc, argv));
+		else if( arg == "--weg"){
+			o.weg = wert(i, argc, argv);
+			if( o.weg != "wegpunkte" && o.weg != "pfad" && o.weg != "fluss"){
+				throw std::runtime_error("Unbekannter Weg: " + o.weg);
+			}
+		}
+		else if( arg == "--threads") o.threads = std::stoul(wert(i, argc, argv));
+		else if( arg == "--csv") o.csv = wert(i, argc, argv);
+		else if( arg == "--turm-csv") o.turmCsv = wert(i, argc, argv);
+		else if( arg == "--arten") o.artenDatei = wert(i, argc, argv);
+		else if( arg == "--einheit-art") o.einheitArt = wert(i, argc, argv);
+		else if( arg == "--turm-art") o.turmArt = wert(i, argc, argv);
+		else throw std::runtime_error("Unbekanntes Argument: " + arg);
+	}
+	if( o.ticks <= 0 || o.dt <= 0){
+		throw std::runtime_error("--ticks und --dt müssen größer 0 sein");
+	}
+	if( o.anzahl == 0) throw std::runtime_error("--anzahl muss größer 0 sein");
+	o.raster = leseRaster(o.datei);
+	o.arten = Arten::standard();
+	if( !o.artenDatei.empty()) o.arten.lade(o.artenDatei);
+	// Gibt es die beiden, und passen alle Werte? Lieber jetzt als mitten
+	// in einem Lauf.
+	Arten probe = o.arten;
+	const Arten::Nummer einheit = probe.einheitNummer(o.einheitArt);
+	const Arten::Nummer turm = probe.turmNummer(o.turmArt);
+	for( auto &p:o.raster){
+		for( auto &w:p.werte){
+			try{
+				probe.setzeWert(p.name, w, einheit, turm);
+			}catch(std::runtime_error &e){
+				throw std::runtime_error(o.datei + ": " + p.name + ": " + e.what());
+			}
+		}
+	}
+	if( o.threads == 0) o.threads = std::max(1u, std::thread::hardware_concurrency());
+	return o;
+}
+
+size_t anzahlLaeufe( const std::vector<Parameter> &raster){
+	size_t laeufe = 1;
+	for( auto &p:raster) laeufe *= p.werte.size();
+	return laeufe;
+}
+
+// Die Werte für Lauf k. Wie beim Zählen: der letzte Parameter dreht sich am
+// schnellsten.
+std::vector<std::string> werteFuer( const std::vector<Parameter> &raster, size_t k){
+	std::vector<std::string> werte(raster.size());
+	for( size_t i = raster.size(); i-- > 0;){
+		werte[i] = raster[i].werte[k % raster[i].werte.size()];
+		k /= raster[i].werte.size();
+	}
+	return werte;
+}
+
+// Ein ganzes Spiel. Läuft, bis die Welle vorbei ist oder die Ticks aus sind.
+Ergebnis spiele( const StapelOptionen &o, const std::vector<std::string> &werte){
+	Welt welt;
+	welt.entkommenLassen = true;
+	// Die Kerne sind schon mit den anderen Läufen beschäftigt.
+	welt.jobs.starte(1);
+
+	// Jeder Lauf bekommt seine eigene Kopie der Arten, mit seinen Werten.
+	// Ohne Renderer keine Texturen, wie bei --headless.
+	Arten arten = o.arten;
+	const Arten::Nummer einheitArt = arten.einheitNummer(o.einheitArt);
+	const Arten::Nummer turmArt = arten.turmNummer(o.turmArt);
+	for( size_t i = 0; i < werte.size(); ++i){
+		arten.setzeWert(o.raster[i].name, werte[i], einheitArt, turmArt);
+	}
+	welt.setzeArten(std::make_shared<const Arten>(std::move(arten)));
+
+	Einheit einheit;
+	einheit.init(welt.arten(), einheitArt, 0, 0);
+	einheit.setzeWegpunkte(erstelleWegpunkte(einheit.getBreite(), einheit.getHoehe()));
+
+	Turm turm;
+	turm.init(welt.arten(), turmArt, 0, 0);
+
+	if( o.weg == "fluss") welt.nutzeFlussfeld(1024-einheit.getBreite(), 768-einheit.getHoehe());
+	if( o.weg == "pfad") welt.nutzePfad(*einheit.getWegpunkte());
+	welt.stelleTuermeAuf(turm, o.tuerme);
+	welt.planeWelle(einheit, 0, o.anzahl, o.intervall);
+
+	// Ab hier sind alle Einheiten der Welle unterwegs.
+	const Uint32 letzte = (o.anzahl - 1) * o.intervall;
+
+	Ergebnis e;
+	Uint32 jetzt = 0;
+	for( ; e.ticks < o.ticks; ++e.ticks){
+		jetzt += o.dt;
+		welt.update(o.dt, jetzt);
+		// Es zeichnet keiner die Schüsse.
+		welt.zuZeichnendeSchuesse.clear();
+		if( jetzt >= letzte && welt.aktiveEinheiten.size() == 0){
+			++e.ticks;
+			break;
+		}
+	}
+
+	e.entkommen = welt.entkommen;
+	e.uebrig = welt.aktiveEinheiten.size();
+	e.gespielt = jetzt;
+	e.tuerme.reserve(welt.aktiveTuerme.size());
+	for( auto &t:welt.aktiveTuerme){
+		auto pos = t.getPosition();
+		e.tuerme.push_back({{pos[0], pos[1], (int)t.getAbschuesse()}});
+	}
+	return e;
+}
+
+void schreibeCsv( const StapelOptionen &o, const std::vector<Ergebnis> &ergebnisse){
+	std::ofstream aus(o.csv);
+	aus << "lauf";
+	for( auto &p:o.raster) aus << "," << p.name;
+	aus << ",entkommen,abschuesse,tuerme,abschuesse_min,abschuesse_max,uebrig,gespielt_ms\n";
+	for( size_t k = 0; k < ergebnisse.size(); ++k){
+		const Ergebnis &e = ergebnisse[k];
+		aus << k;
+		for( auto &w:werteFuer(o.raster, k)) aus << "," << w;
+
+		long summe = 0;
+		int minimum = 0;
+		int maximum = 0;
+		for( size_t t = 0; t < e.tuerme.size(); ++t){
+			int abschuesse = e.tuerme[t][2];
+			summe += abschuesse;
+			minimum = t == 0 ? abschuesse : std::min(minimum, abschuesse);
+			maximum = std::max(maximum, abschuesse);
+		}
+		aus << "," << e.entkommen << "," << summe << "," << e.tuerme.size()
+			<< "," << minimum << "," << maximum << "," << e.uebrig << "," << e.gespielt << "\n";
+	}
+	if( !aus) throw std::runtime_error("Kann " + o.csv + " nicht schreiben");
+
+	if( o.turmCsv.empty()) return;
+	std::ofstream tuerme(o.turmCsv);
+	tuerme << "lauf,turm,x,y,abschuesse\n";
+	for( size_t k = 0; k < ergebnisse.size(); ++k){
+		for( size_t t = 0; t < ergebnisse[k].tuerme.size(); ++t){
+			auto &turm = ergebnisse[k].tuerme[t];
+			tuerme << k << "," << t << "," << turm[0] << "," << turm[1] << "," << turm[2] << "\n";
+		}
+	}
+	if( !tuerme) throw std::runtime_error("Kann " + o.turmCsv + " nicht schreiben");
+}
+
+}
+
+bool istStapel( int argc, char **argv){
+	for( int i = 1; i < argc; ++i){
+		if( std::strcmp(argv[i], "--stapel") == 0) return true;
+	}
+	return false;
+}
+
+int starteStapel( int argc, char **argv){
+	try{
+		auto o = leseOptionen(argc, argv);
+		logbuch().setzeStufe(LogStufe::Fehler);
+
+		const size_t laeufe = anzahlLaeufe(o.raster);
+		const unsigned int threads = (unsigned int)std::min<size_t>(o.threads, laeufe);
+
+		// Jeder Thread nimmt sich den nächsten freien Lauf. Die Ergebnisse
+		// kommen an die Stelle des Laufes, die CSV ist also immer in der
+		// gleichen Reihenfolge, egal wer wann fertig war.
+		std::vector<Ergebnis> ergebnisse(laeufe);
+		std::atomic<size_t> naechster{0};
+		std::atomic<bool> abbruch{false};
+		std::exception_ptr fehler;
+		std::mutex fehlerMutex;
+
+		auto arbeite = [&](){
+			for( ;;){
+				size_t k = naechster.fetch_add(1);
+				if( k >= laeufe || abbruch.load()) return;
+				try{
+					ergebnisse[k] = spiele(o, werteFuer(o.raster, k));
+				}catch(...){
+					std::lock_guard<std::mutex> lock(fehlerMutex);
+					if( !fehler) fehler = std::current_exception();
+					abbruch = true;
+					return;
+				}
+			}
+		};
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> arbeiter;
+		for( unsigned int t = 1; t < threads; ++t) arbeiter.emplace_back(arbeite);
+		arbeite();
+		for( auto &a:arbeiter) a.join();
+		double sekunden = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if( fehler) std::rethrow_exception(fehler);
+
+		schreibeCsv(o, ergebnisse);
+
+		long ticks = 0;
+		for( auto &e:ergebnisse) ticks += e.ticks;
+		std::cout << "[BENCH] Stapel: " << o.datei << " -> " << o.csv << std::endl;
+		std::cout << "[BENCH] Laeufe: " << laeufe << " mit " << threads << " Threads in "
+			<< sekunden << " s" << std::endl;
+		std::cout << "[BENCH] Laeufe pro Sekunde: " << laeufe / sekunden << std::endl;
+		std::cout << "[BENCH] Ticks pro Sekunde: " << ticks / sekunden << std::endl;
+
+	}catch(std::exception &e){
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * Stapel - viele Spiele auf einmal, zum Ausbalancieren.
+ *
+ * Wie weit muss ein Turm reichen? Wie schnell dürfen die Einheiten sein? Bis
+ * jetzt haben wir das im Code geändert, neu gebaut und zugeschaut. Hier
+ * schreiben wir stattdessen in eine kleine Datei, welche Werte wir
+ * ausprobieren wollen:
+ *
+ *		# Kommentare mit #
+ *		reichweite 100 160 220
+ *		cooldown 0 100
+ *		tempo 0.16 0.32
+ *		leben 1 3 5
+ *
+ * Jede Kombination ist ein Lauf, hier also 3*2*2*3 = 36. Jeder Lauf ist ein
+ * ganzes Spiel mit eigener Welt: eine Welle Einheiten gegen ein paar Türme,
+ * ohne Fenster, wie bei --headless. Die Läufe haben nichts miteinander zu
+ * tun, also bekommt jeder Kern seinen eigenen und nimmt sich danach den
+ * nächsten. Innerhalb eines Laufes gibt es keine Threads mehr, das JobSystem
+ * der Welt hat nur den einen.
+ *
+ * Die Werte ändern die Arten (siehe Arten.h) "gegner" und "turm", oder die
+ * nach --einheit-art und --turm-art. Mit --arten datei kommen weitere Arten
+ * dazu.
+ *
+ * Was geht:
+ *		reichweite	in px (Turm)
+ *		nachladen	alle wie viele ms ein Schuss dazukommt (Turm)
+ *		cooldown	ms zwischen zwei Schüssen (Turm)
+ *		schaden		pro Treffer (Turm)
+ *		splash		Radius in px (Turm)
+ *		geschosse	Tempo der Geschosse in px pro ms, 0 = sofort (Turm)
+ *		zielwahl	reihenfolge, vorderste, naechste, staerkste, schwaechste (Turm)
+ *		tempo		px pro ms (Einheit)
+ *		leben		(Einheit)
+ *
+ * Die Liste ist die gleiche wie für arten.txt, siehe Arten.h.
+ *
+ * Aufruf zB:
+ *		TD_Tutorial --stapel raster.txt --ticks 60000 --anzahl 500 --csv laeufe.csv
+ *
+ * Pro Lauf kommt eine Zeile in die CSV: die Werte, wie viele Einheiten
+ * durchgekommen sind und wie viele jeder Turm erledigt hat. Am Ende gibt es
+ * die Läufe pro Sekunde über alle Kerne.
+ * */
+#ifndef STAPEL_H
+#define STAPEL_H
+
+// Steht --stapel irgendwo in den Argumenten?
+bool istStapel( int argc, char **argv);
+
+// Lässt alle Läufe aus der Datei hinter --stapel laufen.
+// Der Rückgabewert ist für main() gedacht.
+int starteStapel( int argc, char **argv);
+
+#endif // STAPEL_H
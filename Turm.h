@@ -0,0 +1,250 @@
+/*
+ * Der Turm bekommt auch seine eigene Datei.
+ * */
+#ifndef TURM_H
+#define TURM_H
+
+#include <SDL.h>
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "Einheit.h"
+#include "SpriteBatch.h"
+#include "Schnappschuss.h"
+#include "Arten.h"
+
+/*
+ * Als nächstes der Tower.
+ * Er ist fest.
+ * Er schießt auf Gegner in einem bestimmten Radius.
+ *
+ * */
+class Turm {
+	public:
+		// Früher hat sich hier jeder Turm einen eigenen SDL Timer zum
+		// Nachladen geholt (und im Kopierkonstruktor gleich noch einen).
+		// Das macht jetzt der Zeitplaner der Welt, siehe Zeitplaner.h.
+		// Konstruktoren, Kopie und Destruktor kann C++ also wieder selber
+		// bauen.
+		//
+		// Reichweite, Schaden, Bild und Co. stehen nicht mehr im Turm,
+		// sondern einmal für alle Türme der gleichen Art, siehe Arten.h.
+		// 'arten' muss so lange leben wie der Turm.
+		void init( const Arten &arten, Arten::Nummer art, int x, int y){
+			m_artNummer = art;
+			setzeArt(arten);
+			m_rect = {x, y, m_art->breite, m_art->hoehe};
+		}
+
+		// Sucht die Art über ihre Nummer in 'arten'. Nach dem Laden eines
+		// Schnappschusses zeigt der alte Zeiger ins Leere, siehe
+		// Welt::lade. Wirft, wenn es die Nummer dort nicht gibt.
+		void setzeArt( const Arten &arten){
+			if( m_artNummer >= arten.anzahlTuerme()){
+				throw std::runtime_error("Den Turm mit Nummer " + std::to_string(m_artNummer) + " gibt es nicht");
+			}
+			m_art = &arten.turm(m_artNummer);
+		}
+
+		Arten::Nummer getArt() const{ return m_artNummer; }
+
+		// Was von einem Turm in den Schnappschuss kommt (siehe
+		// Schnappschuss.h). Der Zeiger auf die Art nicht, der wäre in der
+		// Datei bedeutungslos und bei jedem Lauf ein anderer. Ohne Lücken,
+		// damit gleiche Türme auch die gleichen Bytes ergeben.
+		struct Zustand{
+			SDL_Rect rect;
+			int shootsLeft;
+			int lastShoot;
+			unsigned int abschuesse;
+			Arten::Nummer art;
+			uint16_t frei;
+		};
+
+		Zustand zustand() const{
+			Zustand z{};
+			z.rect = m_rect;
+			z.shootsLeft = m_shootsLeft;
+			z.lastShoot = m_lastShoot;
+			z.abschuesse = m_abschuesse;
+			z.art = m_artNummer;
+			return z;
+		}
+
+		// Danach braucht der Turm noch setzeArt().
+		void setzeZustand( const Zustand &z){
+			m_art = nullptr;
+			m_rect = z.rect;
+			m_shootsLeft = z.shootsLeft;
+			m_lastShoot = z.lastShoot;
+			m_abschuesse = z.abschuesse;
+			m_artNummer = z.art;
+		}
+
+		void update( int frameZeit){
+			// TODO
+			// Es wäre natürlich ganz praktisch noch ein paar Schüsse zu haben
+			// Soll er doch bei jedem Update eine dazu bekommen ...
+			// TODO Natürlich sollte hier eine Zeit eingesetzt werden.
+			// Vielleicht nach jeder Sekunde oder so. Aber zum Testen sollte es
+			// erstmal so gehen
+		
+		}
+
+		void recoverShoot(){
+			++m_shootsLeft;
+			//std::clog << "Recovered to " << m_shootsLeft << std::endl;
+		}
+
+		void draw( SDL_Renderer *renderer){
+			SDL_RenderCopy(renderer, m_art->texture, quelle(), &m_rect);
+		}
+
+		// Oder gesammelt mit allen anderen, siehe SpriteBatch.h
+		void draw( SpriteBatch &batch) const{
+			batch.zeichne(m_art->texture, quelle(), m_rect);
+		}
+
+        /*
+		 * 
+		 * 1) Haben wir noch Schuss übrig?
+		 * 2) Schauen ob sich Einheit in Reichweite befindet
+		 * 3) Schießen.
+		 *
+		 * Die aktuelle Zeit bekommen wir von außen. Im Spiel ist das
+		 * SDL_GetTicks() vom Anfang des Frames, im Headless-Modus eine
+		 * simulierte Zeit. So fragen wir auch nicht für jede Einheit erneut
+		 * nach der Uhrzeit.
+		 *
+		 * Die drei Schritte gibt es auch einzeln. Die Zielsuche über das
+		 * Raster (siehe Raster.h) fragt erst, ob der Turm überhaupt bereit ist
+		 * und sucht dann nur in der Nähe nach Einheiten.
+		 * */
+		bool shoot( Einheit &einheit, Uint32 currentTime){
+			if( !bereit(currentTime)) return false;
+			if( !inReichweite(einheit.getPosition())) return false;
+
+			// An dieser Stelle wissen wir:
+			// - wir haben noch Schüsse übrig
+			// - der Gegner ist in Reichweite
+			// → also schießen wir
+			schiesse(currentTime);
+			return true;
+		}
+
+		// 1) Haben wir noch Schuss übrig und ist der cool down vorbei?
+		bool bereit( Uint32 currentTime) const{
+			if( m_shootsLeft <= 0) return false;
+
+			// Soll nur aller xx ms schießen können
+			// Braucht also cool down
+			//
+			auto diffTime = currentTime - m_lastShoot;
+			return m_art->coolDown <= diffTime;
+		}
+
+		// 2) Ist die Position in Reichweite?
+		bool inReichweite( Point ePos) const{
+			// Der Vektor von hier zum Gegner
+			Point zielVector{{ ePos[0] - m_rect.x, ePos[1] - m_rect.y}};
+
+			// Die länge des Weges quadriert.
+			auto weg = zielVector[0]*zielVector[0] + zielVector[1]*zielVector[1];
+
+			// Wir können das Quadrat nutzen, weil in unserem Fall
+			// sqrt(a) <= sqrt(b)  auch gleich a <= b
+			// wir sparen also die Berechnung der Wurzel
+			// Tja, ist also der Weg bis zum Gegner größer als unsere
+			// Reichweite, dann hören wir auf.
+			return weg <= m_art->reichweite2;
+		}
+
+		// 3) Schießen.
+		// Wir haben dann einen Schuss weniger.
+		// Der eigentliche Schuss wird an anderer Stelle behandelt.
+		void schiesse( Uint32 currentTime){
+			--m_shootsLeft;
+			m_lastShoot = currentTime;
+		}
+
+		// Alle wie viele ms gibt es einen Schuss dazu? Der Zeitplaner
+		// übernimmt das beim Aufstellen.
+		unsigned int getNachladen() const{
+			return m_art->nachladen;
+		}
+
+		// So lange muss der Turm nach einem Schuss mindestens warten.
+		unsigned int getCoolDown() const{ return m_art->coolDown; }
+
+		int getReichweite() const{
+			return m_art->reichweite;
+		}
+
+		// Wie viele Einheiten hat der Turm schon erledigt? Auch mit Splash.
+		unsigned int getAbschuesse() const{ return m_abschuesse; }
+		void zaehleAbschuesse( unsigned int anzahl){ m_abschuesse += anzahl; }
+
+		Point getPosition() const{
+			return {{m_rect.x, m_rect.y}};
+		}
+
+		// Von hier aus wird geschossen.
+		Point getMitte() const{
+			return {{m_rect.x + m_rect.w/2, m_rect.y + m_rect.h/2}};
+		}
+
+		int getBreite() const{ return m_rect.w; }
+		int getHoehe() const{ return m_rect.h; }
+
+		void setPosition( int x, int y){
+			m_rect.x = x;
+			m_rect.y = y;
+		}
+
+		// Wie viel Leben kostet ein Treffer?
+		int getSchaden() const{ return m_art->schaden; }
+
+		// Bei einem Treffer bekommen auch alle Einheiten bis 'radius' Pixel
+		// um das Ziel herum den Schaden ab. 0 heißt: nur das Ziel.
+		int getSplash() const{ return m_art->splash; }
+
+		// Wie schnell fliegen die Geschosse, in px pro ms? Bei 0 trifft der
+		// Schuss sofort, wie früher. Siehe Geschosse.h.
+		double getGeschossTempo() const{ return m_art->geschossTempo; }
+
+		Zielwahl getZielwahl() const{ return m_art->zielwahl; }
+
+		// Schießt der Turm anders als einfach der Reihe nach? Solche Türme
+		// kommen bei der Zielsuche extra dran, siehe Welt::zielsucheBesondere.
+		bool istBesonders() const{
+			return m_art->istBesonders();
+		}
+	private:
+		// Die Zeile in der Tabelle der Arten. Gehört dem Turm nicht.
+		const TurmArt *m_art = nullptr;
+		SDL_Rect m_rect{0,0,0,0};
+
+		// Welcher Teil der Texture? Bei w == 0 die ganze.
+		const SDL_Rect *quelle() const{
+			return m_art->quelle.w > 0 ? &m_art->quelle : nullptr;
+		}
+		//Point m_rotation; // Wo schaut er hin. Brauchen wir aber erstmal nicht.
+		
+		int m_shootsLeft = 0;
+		//int m_maxShoots = 1; // FIXME: wird gerade nicht benutzt
+		int m_lastShoot = 0;
+		unsigned int m_abschuesse = 0;
+		Arten::Nummer m_artNummer = 0;
+};
+
+// Ein Turm hat keinen eigenen Kopierkonstruktor und keinen Destruktor mehr
+// (kein Timer, und der Zeiger auf die Art gehört ihm nicht). Wächst der
+// std::vector mit den Türmen, werden sie einfach Byte für Byte umkopiert.
+// Damit das so bleibt:
+static_assert(std::is_trivially_copyable<Turm>::value,
+		"Turm soll sich mit memcpy umziehen lassen");
+static_assert(sizeof(Turm::Zustand) == 32, "Im Zustand eines Turms sollen keine Lücken sein");
+
+#endif // TURM_H
@@ -0,0 +1,858 @@
+#include "Welt.h"
+#include "Logbuch.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+const int Welt::BREITE;
+const int Welt::HOEHE;
+const unsigned int Welt::KANDIDATEN;
+
+namespace {
+
+// Wie viele Einheiten einer Welle müssten bis 'jetzt' gespawnt sein?
+// Die erste kommt bei 'start', dann alle 'intervall' ms eine weitere.
+template<typename W>
+uint32_t faellig( const W &w, Uint32 jetzt){
+	if( jetzt < w.start) return 0;
+	if( w.intervall == 0) return w.anzahl;
+	uint64_t soll = (jetzt - w.start) / w.intervall + 1;
+	if( w.anzahl > 0 && soll > w.anzahl) soll = w.anzahl;
+	return (uint32_t)soll;
+}
+
+}
+
+void Welt::update( int frameZeit, Uint32 jetzt){
+	// Erst einmal alles, was bis jetzt fällig war: Türme laden nach, neue
+	// Einheiten kommen dazu.
+	{
+		Profiler::Abschnitt abschnitt(profiler, Phase::Zeitplaner);
+		zeitplaner.laufe(jetzt, [this]( const Zeitplaner::Ereignis &e){ ereignis(e); });
+		spawneWellen(jetzt);
+	}
+
+	// Wir haben Events bekommen und können reagieren.
+	// Also können wir hier unsere Einheiten updaten.
+	// alle aktiven Einheiten werden geupdatet.
+	// Jede Einheit bewegt sich für sich alleine. Also kann jeder Thread ein
+	// Stück davon übernehmen.
+	{
+		Profiler::Abschnitt abschnitt(profiler, Phase::Einheiten);
+		jobs.parallelFuer(aktiveEinheiten.size(), 4096,
+				[&]( size_t von, size_t bis, unsigned int){
+					aktiveEinheiten.bewege(frameZeit, von, bis);
+				});
+		if( entkommenLassen) lasseEntkommen();
+	}
+	{
+		Profiler::Abschnitt abschnitt(profiler, Phase::Tuerme);
+		for( auto &t:aktiveTuerme) t.update(frameZeit);
+	}
+	m_rasterAktuell = false;
+
+	// Jetzt suchen sich die Türme ihre Ziele.
+	// Erst alle, die der Reihe nach schießen, dann die besonderen.
+	{
+		Profiler::Abschnitt abschnitt(profiler, Phase::Zielsuche);
+		if( zielsuche == Zielsuche::Raster && jobs.threads() > 1){
+			zielsucheParallel(jetzt);
+		}else if( zielsuche == Zielsuche::Raster){
+			zielsucheRaster(jetzt);
+		}else if( zielsuche == Zielsuche::Strecke){
+			zielsucheStrecke(jetzt);
+		}else{
+			zielsucheNaiv(jetzt);
+		}
+		zielsucheBesondere(jetzt);
+	}
+	{
+		Profiler::Abschnitt abschnitt(profiler, Phase::Geschosse);
+		bewegeGeschosse(frameZeit);
+	}
+
+	// jede verlorene Einheit wird jetzt von den aktiven Einheiten
+	// entfernt
+	// Der Pool macht das für alle auf einmal. Für jede Tote rückt die letzte
+	// Einheit an ihre Stelle, das kostet nicht mehr als ein paar Kopien.
+	Profiler::Abschnitt abschnitt(profiler, Phase::Aufraeumen);
+	aktiveEinheiten.raeumeAuf();
+
+	// Was die Zielsuche zum Rechnen gebraucht hat, ist jetzt egal.
+	frameSpeicher.zuruecksetzen();
+}
+
+// Die Türme suchen ihre Ziele, in dem sie jede Einheit fragen.
+//
+// Warum entfernen wir die Einheit nicht gleich wenn wir wissen,
+// dass sie hinüber ist?
+// Tja.
+// Während wir über die Einheiten laufen, würde sich sonst ihre Reihenfolge
+// ändern. Deswegen markiert der Pool die Einheit nur als tot und nimmt sie
+// erst heraus, wenn wir fertig sind.
+void Welt::zielsucheNaiv( Uint32 jetzt){
+	const size_t n = aktiveEinheiten.size();
+	for( size_t i = 0; i < n; ++i){
+		for( auto &t:aktiveTuerme){
+			if( t.istBesonders()) continue;
+			if( t.bereit(jetzt) && t.inReichweite(aktiveEinheiten.getPosition(i))){
+				t.schiesse(jetzt);
+				if( treffer(t, i)){
+					// Tot ist tot. Die anderen Türme brauchen nicht mehr auf
+					// diese Einheit schießen.
+					break;
+				}
+			}
+		}
+	}
+}
+
+// Die Türme suchen ihre Ziele über das Raster.
+//
+// Jetzt läuft die äußere Schleife über die Türme und nicht mehr über die
+// Einheiten. Trotzdem soll genau das Gleiche wie bei zielsucheNaiv passieren.
+// Dort schießt ein Turm immer auf die Einheit mit der kleinsten Nummer, die in
+// Reichweite und noch nicht tot ist. Ob sie schon tot ist, hängt nur von den
+// Türmen vor ihm ab. Das ist hier genauso, wenn wir die Türme der Reihe nach
+// abarbeiten und auch immer die kleinste Nummer nehmen.
+void Welt::zielsucheRaster( Uint32 jetzt){
+	baueRaster();
+
+	for( auto &t:aktiveTuerme){
+		// Ist der Turm nicht bereit, brauchen wir gar nicht erst suchen.
+		// Das ist meistens der Fall.
+		if( !t.bereit(jetzt) || t.istBesonders()) continue;
+
+		schiesseReihum(t, jetzt, -1);
+	}
+}
+
+void Welt::schiesseReihum( Turm &t, Uint32 jetzt, long letztes){
+	auto pos = t.getPosition();
+	auto r = t.getReichweite();
+
+	// Ohne cool down dürfte ein Turm auch mehrmals pro Frame schießen.
+	// Dann aber auf jede Einheit nur einmal, und immer auf die nächste
+	// mit größerer Nummer. Genau wie in der naiven Schleife.
+	while( t.bereit(jetzt)){
+		long ziel = -1;
+		raster.besuche(pos[0] - r, pos[1] - r, pos[0] + r, pos[1] + r,
+				[&]( unsigned int i, int x, int y){
+					if( (long)i <= letztes) return;
+					if( ziel >= 0 && (long)i >= ziel) return;
+					if( aktiveEinheiten.istTot(i)) return;
+					if( !t.inReichweite({{x, y}})) return;
+					ziel = i;
+				});
+		if( ziel < 0) break;
+
+		t.schiesse(jetzt);
+		treffer(t, ziel);
+		letztes = ziel;
+	}
+}
+
+// Die Zielsuche über das Raster, verteilt auf mehrere Threads.
+//
+// Das Schießen selber muss der Reihe nach passieren: ob Turm 5 eine Einheit
+// noch treffen kann, hängt davon ab, ob Turm 1 bis 4 sie schon erledigt haben.
+// Das Suchen im Raster ist aber die eigentliche Arbeit, und das kann jeder
+// Turm für sich.
+//
+// Also in zwei Schritten:
+// 1. Parallel: jeder bereite Turm merkt sich die KANDIDATEN Einheiten in
+//    Reichweite mit den kleinsten Nummern. Jeder Turm schreibt nur in seine
+//    eigene Zeile, also kommen sich die Threads nicht in die Quere.
+// 2. Der Reihe nach, Turm für Turm: geschossen wird auf den ersten Kandidaten,
+//    der noch lebt. Das ist genau die Einheit, die zielsucheRaster auch
+//    gefunden hätte.
+// Reichen die Kandidaten nicht (viele davon schon tot und der Turm kann noch
+// schießen), sucht der Turm wie gehabt im Raster weiter. Bei allem, was bis
+// zum letzten Kandidaten kommt, wissen wir ja schon Bescheid.
+void Welt::zielsucheParallel( Uint32 jetzt){
+	baueRaster();
+
+	const size_t anzahlTuerme = aktiveTuerme.size();
+	uint32_t *kandidaten = frameSpeicher.feld<uint32_t>(anzahlTuerme * KANDIDATEN);
+	uint32_t *kandidatenAnzahl = frameSpeicher.feld<uint32_t>(anzahlTuerme);
+
+	jobs.parallelFuer(anzahlTuerme, 16,
+			[&]( size_t von, size_t bis, unsigned int){
+				for( size_t n = von; n < bis; ++n){
+					const Turm &t = aktiveTuerme[n];
+					uint32_t gefunden = 0;
+					if( t.bereit(jetzt) && !t.istBesonders()){
+						uint32_t *liste = &kandidaten[n * KANDIDATEN];
+						auto pos = t.getPosition();
+						auto r = t.getReichweite();
+						raster.besuche(pos[0] - r, pos[1] - r, pos[0] + r, pos[1] + r,
+								[&]( unsigned int i, int x, int y){
+									if( !t.inReichweite({{x, y}})) return;
+									// Sortiert einfügen, die größte fällt hinten raus.
+									uint32_t k = std::min(gefunden, KANDIDATEN);
+									++gefunden;
+									if( k == KANDIDATEN){
+										if( i >= liste[KANDIDATEN - 1]) return;
+										--k;
+									}
+									for( ; k > 0 && liste[k - 1] > i; --k){
+										liste[k] = liste[k - 1];
+									}
+									liste[k] = i;
+								});
+					}
+					kandidatenAnzahl[n] = gefunden;
+				}
+			});
+
+	for( size_t n = 0; n < anzahlTuerme; ++n){
+		Turm &t = aktiveTuerme[n];
+		const uint32_t gefunden = kandidatenAnzahl[n];
+		if( gefunden == 0) continue;
+
+		const uint32_t *liste = &kandidaten[n * KANDIDATEN];
+		const uint32_t inListe = std::min(gefunden, KANDIDATEN);
+		long letztes = -1;
+		for( uint32_t k = 0; k < inListe && t.bereit(jetzt); ++k){
+			letztes = liste[k];
+			if( aktiveEinheiten.istTot(liste[k])) continue;
+			t.schiesse(jetzt);
+			treffer(t, liste[k]);
+		}
+
+		if( gefunden > KANDIDATEN && t.bereit(jetzt)){
+			schiesseReihum(t, jetzt, letztes);
+		}
+	}
+}
+
+// Die Türme suchen ihre Ziele auf dem Weg, siehe Abdeckung.h.
+//
+// Wie bei zielsucheRaster schießt jeder Turm der Reihe nach auf die kleinste
+// Nummer in Reichweite. Nur kommen die Kandidaten aus den Eimern des Turms,
+// und es kommen nur die Türme dran, die die Abdeckung geweckt hat.
+// Mit dem Flussfeld, oder solange eine Einheit noch nicht auf dem Weg ist,
+// geht es über das Raster.
+void Welt::zielsucheStrecke( Uint32 jetzt){
+	if( m_mitFlussfeld){
+		zielsucheRaster(jetzt);
+		return;
+	}
+
+	// Meistens lädt gerade jeder Turm nach. Dann braucht auch keiner zu
+	// suchen, und die Einheiten müssen nicht sortiert werden. Nachschauen
+	// lohnt sich aber nur, wenn es weniger Türme als Einheiten sind.
+	if( aktiveTuerme.size() < aktiveEinheiten.size()){
+		bool einerBereit = false;
+		for( auto &t:aktiveTuerme){
+			if( t.bereit(jetzt) && !t.istBesonders()){
+				einerBereit = true;
+				break;
+			}
+		}
+		if( !einerBereit) return;
+	}
+
+	// Die Wegpunkte kommen mit der ersten Einheit in den Pool.
+	const WaypointList *wegpunkte = aktiveEinheiten.wegpunkte().get();
+	if( !m_abdeckungAktuell || (!aktiveEinheiten.nutztPfad() && wegpunkte != m_abdeckungWegpunkte)){
+		if( aktiveEinheiten.nutztPfad()){
+			m_abdeckung.baue(pfad.punkte(), true, aktiveTuerme);
+		}else{
+			static const WaypointList keine;
+			m_abdeckung.baue(wegpunkte != nullptr ? *wegpunkte : keine, false, aktiveTuerme);
+		}
+		m_abdeckungAktuell = true;
+		m_abdeckungWegpunkte = wegpunkte;
+	}
+	if( !m_abdeckung.sortiere(aktiveEinheiten)){
+		zielsucheRaster(jetzt);
+		return;
+	}
+
+	// Neben dem Weg kann eine Einheit jedem Turm nahe kommen. Dann sind
+	// alle wach.
+	const bool alleWach = !m_abdeckung.neben().empty();
+	const size_t anzahl = alleWach ? aktiveTuerme.size() : m_abdeckung.wache().size();
+	for( size_t k = 0; k < anzahl; ++k){
+		const uint32_t n = alleWach ? k : m_abdeckung.wache()[k];
+		Turm &t = aktiveTuerme[n];
+		if( !t.bereit(jetzt) || t.istBesonders()) continue;
+
+		long letztes = -1;
+		while( t.bereit(jetzt)){
+			long ziel = -1;
+			m_abdeckung.besuche(n, [&]( uint32_t i){
+					if( (long)i <= letztes) return;
+					if( ziel >= 0 && (long)i >= ziel) return;
+					if( aktiveEinheiten.istTot(i)) return;
+					if( !t.inReichweite(aktiveEinheiten.getPosition(i))) return;
+					ziel = i;
+				});
+			if( ziel < 0) break;
+
+			t.schiesse(jetzt);
+			treffer(t, ziel);
+			letztes = ziel;
+		}
+	}
+}
+
+// Die Türme, die nicht einfach der Reihe nach schießen.
+//
+// Sie kommen nach allen anderen dran, jeder für sich in der Reihenfolge der
+// Türme. So bleibt es für die anderen Türme dabei, dass Naiv und Raster genau
+// das Gleiche tun. (Ein Splash könnte sonst einer Einheit den Garaus machen,
+// auf die ein späterer Turm in der naiven Schleife schon geschossen hätte.)
+//
+// Ein Turm sammelt die Einheiten in Reichweite einmal aus dem Raster, jede
+// mit ihrer Wertung. Daraus wird ein Heap. Oben liegt das beste Ziel, egal
+// ob das die vorderste, die nächste oder die stärkste Einheit ist. Kann der
+// Turm öfter schießen, kommt einfach die nächstbeste dran.
+void Welt::zielsucheBesondere( Uint32 jetzt){
+	// Mehr Ziele als Einheiten kann kein Turm haben. Der Platz wird erst
+	// geholt, wenn ihn einer braucht, und dann von allen benutzt.
+	Ziel *ziele = nullptr;
+
+	for( auto &t:aktiveTuerme){
+		if( !t.istBesonders() || !t.bereit(jetzt)) continue;
+
+		// Die naive Zielsuche baut kein Raster. Hier brauchen wir es aber.
+		baueRaster();
+		if( ziele == nullptr) ziele = frameSpeicher.feld<Ziel>(aktiveEinheiten.size());
+
+		auto pos = t.getPosition();
+		auto r = t.getReichweite();
+		Ziel *ende = ziele;
+		raster.besuche(pos[0] - r, pos[1] - r, pos[0] + r, pos[1] + r,
+				[&]( unsigned int i, int x, int y){
+					if( aktiveEinheiten.istTot(i)) return;
+					if( !t.inReichweite({{x, y}})) return;
+					*ende++ = {wertung(t, i, x, y), i};
+				});
+		std::make_heap(ziele, ende);
+
+		while( ende != ziele && t.bereit(jetzt)){
+			unsigned int ziel = ziele[0].index;
+			// Kann inzwischen durch einen Splash gestorben sein.
+			if( !aktiveEinheiten.istTot(ziel)){
+				t.schiesse(jetzt);
+				treffer(t, ziel);
+				// Ein Geschoss macht seinen Splash erst beim Einschlag.
+				if( t.getGeschossTempo() <= 0.0) t.zaehleAbschuesse(splash(ziel, t.getSplash(), t.getSchaden()));
+			}
+			// Lebt sie noch, bleibt sie das beste Ziel.
+			if( aktiveEinheiten.istTot(ziel)){
+				std::pop_heap(ziele, ende);
+				--ende;
+			}
+		}
+	}
+}
+
+double Welt::wertung( const Turm &t, unsigned int i, int x, int y) const{
+	switch(t.getZielwahl()){
+		case Zielwahl::Vorderste:
+			return aktiveEinheiten.fortschritt(i);
+		case Zielwahl::Naechste:{
+			auto pos = t.getPosition();
+			double dx = x - pos[0];
+			double dy = y - pos[1];
+			return -(dx*dx + dy*dy);
+		}
+		case Zielwahl::Staerkste:
+			return aktiveEinheiten.leben(i);
+		case Zielwahl::Schwaechste:
+			return -aktiveEinheiten.leben(i);
+		case Zielwahl::Reihenfolge:
+			break;
+	}
+	// Die kleinste Nummer zuerst.
+	return -(double)i;
+}
+
+unsigned int Welt::splash( unsigned int i, int r, int schaden){
+	if( r <= 0) return 0;
+	unsigned int tote = 0;
+
+	// Um das Ziel herum, gemessen wie die Reichweite: von Ecke zu Ecke.
+	auto mitte = aktiveEinheiten.getPosition(i);
+	raster.besuche(mitte[0] - r, mitte[1] - r, mitte[0] + r, mitte[1] + r,
+			[&]( unsigned int j, int x, int y){
+				if( j == i || aktiveEinheiten.istTot(j)) return;
+				int dx = x - mitte[0];
+				int dy = y - mitte[1];
+				if( dx*dx + dy*dy > r*r) return;
+				if( aktiveEinheiten.gotHit(j, schaden)) ++tote;
+			});
+	return tote;
+}
+
+void Welt::lasseEntkommen(){
+	const size_t n = aktiveEinheiten.size();
+	for( size_t i = 0; i < n; ++i){
+		if( !aktiveEinheiten.istTot(i) && aktiveEinheiten.amAusgang(i)){
+			aktiveEinheiten.entkommt(i);
+			++entkommen;
+		}
+	}
+}
+
+void Welt::baueRaster(){
+	if( m_rasterAktuell) return;
+	raster.baue(aktiveEinheiten.x(), aktiveEinheiten.y(), aktiveEinheiten.size());
+	m_rasterAktuell = true;
+}
+
+// Die Geschosse fliegen in zwei Schritten, ähnlich wie bei zielsucheParallel:
+// 1. Parallel: jedes Geschoss fliegt ein Stück und schaut, wen es dabei als
+//    erstes berührt. Dabei wird nur gelesen, an den Einheiten ändert sich
+//    nichts.
+// 2. Der Reihe nach: die Treffer bekommen ihren Schaden.
+// Treffen zwei Geschosse die gleiche Einheit und schon das erste erledigt
+// sie, ist das zweite trotzdem weg, aber ohne Schaden und ohne Splash. Es
+// hat ja nichts mehr getroffen. So hängt es nicht davon ab, welches Geschoss
+// auf welchem Platz liegt.
+void Welt::bewegeGeschosse( int frameZeit){
+	if( geschosse.anzahl() == 0) return;
+	baueRaster();
+
+	// Ein Geschoss ist ein kleiner Kreis mit 2px Radius.
+	const int radius = aktiveEinheiten.breite() / 2 + 2;
+	const size_t n = geschosse.spannweite();
+	jobs.parallelFuer(n, 1024,
+			[&]( size_t von, size_t bis, unsigned int){
+				geschosse.bewege(frameZeit, von, bis, raster, aktiveEinheiten, radius);
+			});
+
+	for( size_t g = 0; g < n; ++g){
+		if( !geschosse.aktiv(g)) continue;
+		uint32_t i = geschosse.treffer(g);
+		if( i != GeschossPool::KEIN_TREFFER && aktiveEinheiten.istTot(i)){
+			geschosse.entferne(g);
+		}else if( i != GeschossPool::KEIN_TREFFER){
+			TD_LOG(LogBereich::Treffer, LogStufe::Info, 10, "Treffer!");
+			unsigned int tote = 0;
+			if( aktiveEinheiten.gotHit(i, geschosse.schaden(g))){
+				TD_LOG(LogBereich::Treffer, LogStufe::Info, 10, "Versenkt!");
+				++tote;
+			}
+			tote += splash(i, geschosse.splash(g), geschosse.schaden(g));
+			aktiveTuerme[geschosse.schuetze(g)].zaehleAbschuesse(tote);
+			geschosse.entferne(g);
+		}else if( geschosse.amEnde(g)){
+			geschosse.entferne(g);
+		}
+	}
+}
+
+bool Welt::treffer( Turm &t, unsigned int i){
+	// Bei einer großen Welle kommt das tausende Male pro Sekunde. Mehr als
+	// 10 Zeilen pro Sekunde liest sowieso keiner, siehe Logbuch.h.
+	TD_LOG(LogBereich::Treffer, LogStufe::Info, 10, "Treffer!");
+
+	// Der Turm hat geschossen. Das sollten wir auch anzeigen.
+	// Am einfachsten mit einer Linie von Turm zu Einheit.
+	// Zeichnen tun wir aber erst weiter unten, also speichern
+	// wir die beiden Coordinaten und zeigen sie später an.
+	//
+	// Problem: Der Schuss wird hier von Position aus geschickt.
+	// Position ist aber oben links vom Bild/der Textur. Es
+	// sieht etwas seltsam aus. Also wäre es etwas besser, wenn
+	// wir von der Mitte des Turm aus schießen und auch die
+	// Einheit in der Mitte treffen.
+	// Die Mitte bekommen wir aus der Größe der Bilder. Die steht seit dem
+	// Atlas (siehe Atlas.h) bei jedem Bild dabei.
+	auto von = t.getMitte();
+	auto nach = aktiveEinheiten.getMitte(i);
+
+	// Mit Geschossen wird erst beim Einschlag getroffen, siehe
+	// bewegeGeschosse(). Fliegen darf es etwas weiter als die Reichweite,
+	// das Ziel läuft ja weg.
+	if( t.getGeschossTempo() > 0.0){
+		geschosse.feuere(von[0], von[1], aktiveEinheiten.handle(i), nach[0], nach[1],
+				t.getGeschossTempo(), t.getReichweite() * 1.5, t.getSchaden(), t.getSplash(),
+				(uint32_t)(&t - aktiveTuerme.data()));
+		return false;
+	}
+
+	zuZeichnendeSchuesse.push_back({{von[0], von[1], nach[0], nach[1]}});
+
+	if( aktiveEinheiten.gotHit(i, t.getSchaden())){
+		TD_LOG(LogBereich::Treffer, LogStufe::Info, 10, "Versenkt!");
+		t.zaehleAbschuesse(1);
+		// jetzt ists vorbei mit Einheit e
+		// der Pool merkt sich die Einheit in seiner Liste
+		// der frisch Verstorbenen
+		return true;
+	}
+	return false;
+}
+
+Welt::Welt(){
+	setzeArten(std::make_shared<const Arten>(Arten::standard()));
+}
+
+void Welt::setzeArten( std::shared_ptr<const Arten> arten){
+	if( !arten) throw std::runtime_error("Die Welt braucht Arten");
+	for( auto &t:aktiveTuerme) t.setzeArt(*arten);
+	m_arten = std::move(arten);
+	aktiveEinheiten.setzeArten(m_arten.get());
+	hintergrund.neuZeichnen();
+	m_abdeckungAktuell = false;
+}
+
+void Welt::neuerTurm( const Turm &turm){
+	aktiveTuerme.emplace_back(turm);
+	aktiveTuerme.back().setzeArt(*m_arten);
+	hintergrund.neuZeichnen();
+	m_abdeckungAktuell = false;
+
+	// Wir merken uns den Turm über seine Nummer. Die bleibt gleich, auch wenn
+	// der std::vector die Türme mal umzieht.
+	auto nachladen = aktiveTuerme.back().getNachladen();
+	zeitplaner.plane(zeitplaner.zeit() + nachladen, nachladen,
+			Zeitplaner::Art::TurmNachladen, aktiveTuerme.size() - 1);
+}
+
+void Welt::stelleTuermeAuf( const Turm &vorlage, int anzahl){
+	if( anzahl <= 0) return;
+	// Die Größe kommt aus der Art des Turmes. Die Türme am Rand sollen
+	// ganz auf dem Spielfeld stehen.
+	const int breite = vorlage.getBreite();
+	const int hoehe = vorlage.getHoehe();
+	int spalten = (int)std::ceil(std::sqrt(anzahl * (double)BREITE / HOEHE));
+	int zeilen = (anzahl + spalten - 1) / spalten;
+	aktiveTuerme.reserve(anzahl);
+	for( int n = 0; n < anzahl; ++n){
+		int x = (n % spalten) * (BREITE - breite) / std::max(1, spalten - 1);
+		int y = (n / spalten) * (HOEHE - hoehe) / std::max(1, zeilen - 1);
+		if( m_mitFlussfeld){
+			// Wie ein Klick auf die Mitte. Versperrt der Turm den Weg,
+			// fehlt er eben.
+			baueTurm(vorlage, x + breite/2, y + hoehe/2);
+			continue;
+		}
+		Turm t{vorlage};
+		t.setPosition(x, y);
+		neuerTurm(t);
+	}
+}
+
+bool Welt::baueTurm( const Turm &vorlage, int x, int y){
+	Turm t{vorlage};
+	t.setPosition(x - vorlage.getBreite()/2, y - vorlage.getHoehe()/2);
+
+	if( m_mitFlussfeld){
+		// Genau in eine Zelle, sonst sperrt ein Turm gleich vier.
+		auto ecke = flussfeld.zellenEcke(x - Flussfeld::ZELLE/2, y - Flussfeld::ZELLE/2);
+		t.setPosition(ecke[0], ecke[1]);
+		auto pos = t.getPosition();
+		SDL_Rect platz{pos[0], pos[1], t.getBreite(), t.getHoehe()};
+		if( !flussfeld.blockiere(platz, [this]{ return alleKommenDurch(); })){
+			TD_LOG(LogBereich::Bauen, LogStufe::Info, 0, "Kein Turm bei {} {}, das versperrt den Weg", x, y);
+			return false;
+		}
+	}
+
+	TD_LOG(LogBereich::Bauen, LogStufe::Info, 0, "Neuer Turm bei {} {}", x, y);
+	neuerTurm(t);
+	return true;
+}
+
+void Welt::nutzeFlussfeld( int zielX, int zielY){
+	flussfeld.setzeZiel(zielX, zielY);
+
+	// Die Türme, die schon stehen, sperren ihre Zellen. Gefragt wird hier
+	// keiner, die stehen ja schon.
+	for( auto &t:aktiveTuerme){
+		auto pos = t.getPosition();
+		flussfeld.blockiere({pos[0], pos[1], t.getBreite(), t.getHoehe()});
+	}
+
+	aktiveEinheiten.setzeFlussfeld(&flussfeld);
+	m_mitFlussfeld = true;
+}
+
+void Welt::nutzePfad( const WaypointList &wegpunkte){
+	pfad = Pfad(wegpunkte);
+	aktiveEinheiten.setzePfad(&pfad);
+	m_abdeckungAktuell = false;
+	m_mitFlussfeld = false;
+}
+
+bool Welt::alleKommenDurch() const{
+	for( auto &vorlage:m_spawnVorlagen){
+		auto pos = vorlage.getPosition();
+		if( !flussfeld.erreichbar(pos[0], pos[1])) return false;
+	}
+	for( size_t i = 0; i < aktiveEinheiten.size(); ++i){
+		auto pos = aktiveEinheiten.getPosition(i);
+		if( !flussfeld.erreichbar(pos[0], pos[1])) return false;
+	}
+	return true;
+}
+
+void Welt::planeWelle( const Einheit &vorlage, Uint32 start, uint32_t anzahl, Uint32 intervall){
+	// Ohne Ende und ohne Pause wären es unendlich viele auf einmal.
+	if( anzahl == 0 && intervall == 0) intervall = 1;
+
+	m_spawnVorlagen.emplace_back(vorlage);
+	m_wellen.push_back({(uint32_t)m_spawnVorlagen.size() - 1, start, intervall, anzahl, 0});
+
+	// Wir wissen schon, wie viele Einheiten kommen werden. Also können wir
+	// den Platz dafür gleich jetzt holen und nicht mitten im Spiel.
+	if( anzahl > 0) aktiveEinheiten.reserve(aktiveEinheiten.size() + anzahl);
+}
+
+void Welt::planeSpawn( const Einheit &vorlage, Uint32 intervall){
+	planeWelle(vorlage, zeitplaner.zeit() + intervall, 0, intervall);
+}
+
+void Welt::spawneWellen( Uint32 jetzt){
+	if( m_wellen.empty()) return;
+
+	// Erst zählen, wie viele insgesamt dazukommen. Dann wird der Speicher
+	// höchstens einmal pro Frame neu angefordert.
+	// Damit das nicht jeden Frame passiert, wächst er wie bei push_back auch
+	// auf mindestens das Doppelte.
+	size_t neu = 0;
+	for( auto &w:m_wellen){
+		neu += faellig(w, jetzt) - w.gespawnt;
+	}
+	if( neu == 0) return;
+	auto gebraucht = aktiveEinheiten.size() + neu;
+	if( gebraucht > aktiveEinheiten.capacity()){
+		aktiveEinheiten.reserve(std::max(gebraucht, 2 * aktiveEinheiten.capacity()));
+	}
+
+	for( auto &w:m_wellen){
+		auto soll = faellig(w, jetzt);
+		aktiveEinheiten.fuegeHinzu(m_spawnVorlagen[w.vorlage], soll - w.gespawnt);
+		w.gespawnt = soll;
+	}
+
+	// Fertige Wellen brauchen wir nicht mehr anschauen.
+	m_wellen.erase(std::remove_if(m_wellen.begin(), m_wellen.end(),
+				[]( const Welle &w){ return w.anzahl > 0 && w.gespawnt == w.anzahl; }),
+			m_wellen.end());
+}
+
+void Welt::ereignis( const Zeitplaner::Ereignis &e){
+	switch(e.art){
+		case Zeitplaner::Art::TurmNachladen:
+			aktiveTuerme[e.id].recoverShoot();
+			break;
+	}
+}
+
+void Welt::draw( SDL_Renderer *renderer, double anteil){
+	Profiler::Abschnitt abschnitt(profiler, Phase::Zeichnen);
+
+	// Die Türme kommen in den Hintergrund, wenn es einen gibt. Was sich
+	// bewegt, wird darüber gezeichnet und in den Flecken markiert.
+	const bool mitHintergrund = hintergrund.vorbereiten(renderer);
+	batch.setzeFlecken(nullptr);
+	if( mitHintergrund){
+		if( hintergrund.veraltet()){
+			hintergrund.beginne(renderer);
+			for( auto &t:aktiveTuerme) t.draw(batch);
+			batch.absenden(renderer);
+			hintergrund.ende(renderer);
+		}
+		hintergrund.stelleWiederHer(renderer);
+		batch.setzeFlecken(&hintergrund.flecken());
+	}else{
+		SDL_RenderClear(renderer);
+	}
+
+	// Und hier zeichnen wir die Einheiten
+	// alle aktiven Einheiten auf den Renderer zeichnen
+	// Erst einmal wird nur gesammelt.
+	aktiveEinheiten.draw(batch, anteil);
+	if( !mitHintergrund){
+		for( auto &t:aktiveTuerme) t.draw(batch);
+	}
+
+	// Schüsse zeichnen
+	//
+	// Da wir die aber nur ein Frame lang zeichnen, könnte es sein, dass
+	// wir davon nicht viel mitbekommen. Werden wir ja im Test sehen ;-)
+	//
+	// Die Linie sollte eine Farbe != schwarz haben.
+	// Die Farbe hängt an der Linie selber, die Farbe des Renderers bleibt
+	// wie sie ist.
+	for( auto &line:zuZeichnendeSchuesse){
+		batch.linie(line[0], line[1], line[2], line[3], SDL_Color{255, 0, 0, 255});
+	}
+	zuZeichnendeSchuesse.clear();
+
+	// Die Geschosse, als kurzer gelber Strich mit Schweif nach hinten.
+	for( size_t g = 0; g < geschosse.spannweite(); ++g){
+		if( !geschosse.aktiv(g)) continue;
+		double gx = geschosse.altX(g) + (geschosse.x(g) - geschosse.altX(g)) * anteil;
+		double gy = geschosse.altY(g) + (geschosse.y(g) - geschosse.altY(g)) * anteil;
+		batch.linie((int)gx, (int)gy, (int)(gx - 6.0 * geschosse.richtungX(g)),
+				(int)(gy - 6.0 * geschosse.richtungY(g)), SDL_Color{255, 255, 0, 255});
+	}
+
+	// Und jetzt alles auf einmal.
+	batch.absenden(renderer);
+}
+
+uint64_t Welt::pruefsumme() const{
+	uint64_t summe = 14695981039346656037ull;
+	auto mische = [&summe]( uint32_t wert){
+		summe = (summe ^ wert) * 1099511628211ull;
+	};
+
+	mische(zeitplaner.zeit());
+	mische(aktiveEinheiten.size());
+	for( size_t i = 0; i < aktiveEinheiten.size(); ++i){
+		for( int wert:aktiveEinheiten.getPosition(i)) mische(wert);
+	}
+	mische(aktiveTuerme.size());
+	for( auto &t:aktiveTuerme){
+		for( int wert:t.getPosition()) mische(wert);
+	}
+
+	// Welches Geschoss auf welchem Platz liegt, soll egal sein. Also wird
+	// jedes für sich gemischt und dann nur zusammengezählt. Ohne Geschosse
+	// bleibt die Summe wie früher.
+	if( geschosse.anzahl() > 0){
+		uint64_t alle = 0;
+		for( size_t g = 0; g < geschosse.spannweite(); ++g){
+			if( !geschosse.aktiv(g)) continue;
+			uint64_t eines = 14695981039346656037ull;
+			for( double wert:{geschosse.x(g), geschosse.y(g)}){
+				eines = (eines ^ (uint32_t)(int32_t)std::floor(wert * 16.0)) * 1099511628211ull;
+			}
+			alle += eines;
+		}
+		mische(geschosse.anzahl());
+		mische((uint32_t)alle);
+		mische((uint32_t)(alle >> 32));
+	}
+	return summe;
+}
+
+Schnappschuss Welt::schnappschuss() const{
+	Schnappschuss::Schreiber s;
+
+	// Die Wegpunkte teilen sich der Pool und alle Vorlagen. Sie kommen nur
+	// einmal hinein.
+	WaypointList wegpunkte;
+	if( aktiveEinheiten.wegpunkte()) wegpunkte = *aktiveEinheiten.wegpunkte();
+	else if( !m_spawnVorlagen.empty() && m_spawnVorlagen.front().getWegpunkte()){
+		wegpunkte = *m_spawnVorlagen.front().getWegpunkte();
+	}
+	s.feld(wegpunkte);
+
+	s.wert<char>(m_mitFlussfeld);
+	s.wert<char>(entkommenLassen);
+	s.wert(entkommen);
+	zeitplaner.speichere(s);
+	flussfeld.speichere(s);
+	pfad.speichere(s);
+	aktiveEinheiten.speichere(s);
+
+	// Von den Türmen nur ihr Zustand, ohne den Zeiger auf die Art. Der kommt
+	// beim Laden über die Nummer neu.
+	std::vector<Turm::Zustand> tuerme;
+	tuerme.reserve(aktiveTuerme.size());
+	for( auto &t:aktiveTuerme) tuerme.push_back(t.zustand());
+	s.feld(tuerme);
+
+	geschosse.speichere(s);
+	s.feld(m_wellen);
+	s.wert<uint64_t>(m_spawnVorlagen.size());
+	for( auto &e:m_spawnVorlagen) e.speichere(s);
+	return s.fertig();
+}
+
+void Welt::lade( const Schnappschuss &s, const Einheit &einheit){
+	Schnappschuss::Leser l(s);
+
+	WaypointList punkte;
+	l.feld(punkte);
+	WaypointListZeiger wegpunkte = punkte.empty() ? nullptr : std::make_shared<WaypointList>(punkte);
+	Einheit bild{einheit};
+	if( wegpunkte) bild.setzeWegpunkte(wegpunkte);
+
+	m_mitFlussfeld = l.wert<char>() != 0;
+	entkommenLassen = l.wert<char>() != 0;
+	entkommen = l.wert<uint64_t>();
+	zeitplaner.lade(l);
+	flussfeld.lade(l);
+	pfad.lade(l);
+	aktiveEinheiten.lade(l, bild, &flussfeld, &pfad);
+
+	std::vector<Turm::Zustand> tuerme;
+	l.feld(tuerme);
+	aktiveTuerme.assign(tuerme.size(), Turm());
+	for( size_t n = 0; n < tuerme.size(); ++n){
+		aktiveTuerme[n].setzeZustand(tuerme[n]);
+		aktiveTuerme[n].setzeArt(*m_arten);
+	}
+	hintergrund.neuZeichnen();
+	m_abdeckungAktuell = false;
+
+	geschosse.lade(l);
+	for( size_t g = 0; g < geschosse.spannweite(); ++g){
+		if( geschosse.aktiv(g) && geschosse.schuetze(g) >= aktiveTuerme.size()){
+			throw std::runtime_error("Ein Geschoss im Schnappschuss hat keinen Turm");
+		}
+	}
+	l.feld(m_wellen);
+	m_spawnVorlagen.assign(l.wert<uint64_t>(), bild);
+	for( auto &e:m_spawnVorlagen) e.lade(l, wegpunkte);
+	for( auto &w:m_wellen){
+		if( w.vorlage >= m_spawnVorlagen.size()) throw std::runtime_error("Die Wellen im Schnappschuss sind kaputt");
+	}
+	if( !l.amEnde()) throw std::runtime_error("Im Schnappschuss ist mehr, als die Welt kennt");
+
+	// Was nur während eines Frames gilt, fängt neu an.
+	zuZeichnendeSchuesse.clear();
+	m_rasterAktuell = false;
+	frameSpeicher.zuruecksetzen();
+}
+
+WaypointListZeiger erstelleWegpunkte( int breite, int hoehe){
+	// Wir erzeugen eine Wegpunktliste und bekommen davon einen shared_ptr
+	auto alleWegpunkte = std::make_shared<WaypointList>();
+
+	// Füllen wir ein paar Wegpunkte in die Liste
+	alleWegpunkte->push_back({{0,0}});
+	// Die Einheit soll ganz im Fenster bleiben, also ziehen wir ihre Größe
+	// ab.
+	alleWegpunkte->push_back({{Welt::BREITE-breite,0}});
+	alleWegpunkte->push_back({{0,Welt::HOEHE-hoehe}});
+	alleWegpunkte->push_back({{Welt::BREITE-breite,Welt::HOEHE-hoehe}});
+	alleWegpunkte->push_back({{0,0}});
+
+	return alleWegpunkte;
+}
+
+void richteSpielEin( Welt &welt, Einheit &einheit, Turm &turm,
+		const std::string &einheitArt, const std::string &turmArt){
+	const Arten &arten = welt.arten();
+	einheit.init(arten, arten.einheitNummer(einheitArt), 0, 0);
+	einheit.setzeWegpunkte(erstelleWegpunkte(einheit.getBreite(), einheit.getHoehe()));
+
+	// Der Turm steht erst einmal in der Mitte. Gebaut wird er mit der Maus.
+	const TurmArt &t = arten.turm(arten.turmNummer(turmArt));
+	turm.init(arten, arten.turmNummer(turmArt), (Welt::BREITE - t.breite)/2, (Welt::HOEHE - t.hoehe)/2);
+
+	// Die Einheiten laufen in die Ecke unten rechts. Wie, das ergibt sich
+	// aus den Türmen, die der Spieler in den Weg stellt.
+	welt.nutzeFlussfeld(Welt::BREITE - einheit.getBreite(), Welt::HOEHE - einheit.getHoehe());
+
+	// die Einheit kommt in die Liste der aktiven Einheiten
+	welt.aktiveEinheiten.fuegeHinzu(einheit);
+
+	// Jede Sekunde kommt eine neue Einheit dazu.
+	welt.planeSpawn(einheit, 1000);
+}
@@ -0,0 +1,307 @@
+/*
+ * Die Welt.
+ *
+ * Bisher steckte alles, was in einem Frame passiert, direkt in der
+ * Hauptschleife in main(). Das geht so lange gut, wie es nur eine
+ * Hauptschleife gibt. Jetzt wollen wir die Simulation aber auch ohne Fenster
+ * laufen lassen (siehe Headless.h). Damit beide das Gleiche tun, packen wir die
+ * Listen und den Ablauf eines Frames hier zusammen.
+ * */
+#ifndef WELT_H
+#define WELT_H
+
+#include <SDL.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Einheit.h"
+#include "EinheitenPool.h"
+#include "Turm.h"
+#include "Raster.h"
+#include "Flussfeld.h"
+#include "Pfad.h"
+#include "Geschosse.h"
+#include "Arena.h"
+#include "Profiler.h"
+#include "Schnappschuss.h"
+#include "Zeitplaner.h"
+#include "JobSystem.h"
+#include "SpriteBatch.h"
+#include "Hintergrund.h"
+#include "Abdeckung.h"
+#include "Arten.h"
+
+// Wie finden die Türme ihre Ziele?
+// Naiv: jeder Turm fragt bei jeder Einheit nach.
+// Raster: jeder Turm schaut nur in die Zellen seiner Reichweite.
+// Strecke: jeder Turm schaut nur auf die Stücke des Weges, die er erreicht,
+// und wer keine Einheit in der Nähe hat, schläft. Siehe Abdeckung.h.
+// Alle schießen auf genau die gleichen Einheiten. Naiv bleibt zum Vergleichen
+// drin.
+enum class Zielsuche{
+	Naiv,
+	Raster,
+	Strecke
+};
+
+struct Welt{
+	// So groß ist das Spielfeld in px, genau so groß wie das Fenster.
+	static const int BREITE = 1024;
+	static const int HOEHE = 768;
+
+	// Fängt mit Arten::standard() an.
+	Welt();
+
+	// Alle aktiven Einheiten
+	// so können wir diese leichter überwachen
+	// Tote Einheiten merkt sich der Pool selber und räumt sie am Ende des
+	// Frames auf einen Schlag weg.
+	EinheitenPool aktiveEinheiten;
+
+	std::vector<Turm> aktiveTuerme;
+
+	// Von wo nach wo in diesem Frame geschossen wurde.
+	std::vector<std::array<int,4>> zuZeichnendeSchuesse;
+
+	// Die Geschosse, die gerade unterwegs sind. Nur von Türmen mit einem
+	// Geschoss-Tempo, siehe TurmArt::geschossTempo.
+	GeschossPool geschosse;
+
+	Zielsuche zielsuche = Zielsuche::Raster;
+
+	// Verschwinden Einheiten, die am Ende ihres Weges ankommen? Bisher
+	// bleiben sie dort einfach stehen, darum ist das erst einmal aus.
+	// Mitgezählt werden sie in 'entkommen'. Siehe Stapel.h.
+	bool entkommenLassen = false;
+	uint64_t entkommen = 0;
+	EinheitenRaster raster;
+
+	// Der Weg zum Ziel, wenn nicht über Wegpunkte gelaufen wird. Siehe
+	// nutzeFlussfeld().
+	Flussfeld flussfeld;
+
+	// Die Wegpunkte, schon fertig ausgerechnet. Siehe nutzePfad().
+	Pfad pfad;
+
+	// Das Nachladen der Türme läuft über die Zeit der Simulation.
+	// Siehe Zeitplaner.h.
+	Zeitplaner zeitplaner;
+
+	// Mit wie vielen Threads wird gerechnet? Siehe JobSystem.h.
+	// Egal wie viele, heraus kommt immer genau das Gleiche.
+	JobSystem jobs;
+
+	// Platz für alles, was nur während eines Frames gebraucht wird. Wird am
+	// Ende von update() auf einen Schlag frei. Siehe Arena.h.
+	Arena frameSpeicher;
+
+	// Misst, wie lange die Abschnitte eines Frames dauern. Ist erst einmal
+	// aus, siehe Profiler.h.
+	Profiler profiler;
+
+	// Sammelt beim Zeichnen alle Bilder und Schüsse und schickt sie mit
+	// wenigen Aufrufen an den Renderer. Siehe SpriteBatch.h.
+	SpriteBatch batch;
+
+	// Die Türme stehen still. Sie werden nur neu gezeichnet, wenn einer
+	// dazukommt, sonst kommen sie fertig aus dem Hintergrund. Siehe
+	// Hintergrund.h.
+	Hintergrund hintergrund;
+
+	// Die Arten der Einheiten und Türme, siehe Arten.h. Alle Einheiten im
+	// Pool und alle Türme müssen eine Art daraus haben. Türme, die schon
+	// stehen, suchen ihre Art neu; wirft, wenn es sie nicht mehr gibt.
+	// Die Tabelle ändert sich danach nicht mehr, Kopien der Welt (siehe
+	// Headless) können sie sich also teilen.
+	void setzeArten( std::shared_ptr<const Arten> arten);
+	const Arten &arten() const{
+		return *m_arten;
+	}
+
+	// Stellt einen neuen Turm auf. Er lädt ab jetzt regelmäßig nach.
+	// Seine Art kommt aus arten(), auch wenn 'turm' mit einer anderen
+	// Tabelle eingerichtet wurde.
+	void neuerTurm( const Turm &turm);
+
+	// Ein Klick auf x,y: dort kommt eine Kopie von 'vorlage' hin, mit der
+	// Mitte unter dem Mauszeiger.
+	// Mit dem Flussfeld kommt der Turm in die Zelle unter dem Mauszeiger und
+	// sperrt sie. Würde das einer Einheit den Weg zum Ziel abschneiden, wird
+	// nicht gebaut und es gibt false.
+	bool baueTurm( const Turm &vorlage, int x, int y);
+
+	// Verteilt 'anzahl' Kopien von 'vorlage' gleichmäßig in einem Raster
+	// über das Spielfeld. Für Headless und Stapel.
+	void stelleTuermeAuf( const Turm &vorlage, int anzahl);
+
+	// Ab jetzt laufen die Einheiten nicht mehr die Wegpunkte ab, sondern
+	// über das Flussfeld nach x,y. Türme versperren dann den Weg.
+	void nutzeFlussfeld( int zielX, int zielY);
+	bool nutztFlussfeld() const{
+		return m_mitFlussfeld;
+	}
+
+	// Ab jetzt laufen die Einheiten die Wegpunkte als Pfad ab: jede merkt
+	// sich nur noch, wie weit sie schon ist. Siehe Pfad.h.
+	void nutzePfad( const WaypointList &wegpunkte);
+
+	// Eine Welle: ab 'start' kommt alle 'intervall' ms eine Kopie von
+	// 'vorlage' dazu, insgesamt 'anzahl' Stück. Bei anzahl 0 hört die Welle
+	// nie auf.
+	void planeWelle( const Einheit &vorlage, Uint32 start, uint32_t anzahl, Uint32 intervall);
+
+	// Ab jetzt kommt alle 'intervall' ms eine Kopie von 'vorlage' dazu.
+	// Also eine Welle ohne Ende.
+	void planeSpawn( const Einheit &vorlage, Uint32 intervall);
+
+	// Ein Frame der Simulation:
+	// → Einheiten und Türme bewegen
+	// → Türme schießen lassen
+	// → Geschosse fliegen lassen
+	// → tote Einheiten entfernen
+	// → frameSpeicher leeren
+	// frameZeit ist die vergangene Zeit in ms, jetzt die aktuelle Zeit in ms.
+	// Vorher wird noch alles erledigt, was laut Zeitplaner bis jetzt fällig
+	// war.
+	void update( int frameZeit, Uint32 jetzt);
+
+	// Zeichnet Einheiten, Türme und die Schüsse dieses Frames.
+	// Danach sind die Schüsse vergessen.
+	// Einheiten und Geschosse stehen 'anteil' des Weges zwischen dem
+	// vorletzten und dem letzten update(). Läuft die Simulation in festen
+	// Schritten (siehe main.cpp), bewegt sich so auch zwischen zwei
+	// Schritten noch etwas.
+	// Wie viele Aufrufe das an den Renderer waren und wie lange das
+	// gedauert hat, steht danach in batch.
+	// Gelöscht wird hier, vorher braucht es kein SDL_RenderClear mehr. Der
+	// Software-Renderer darf zwischen zwei draw() auch nichts anderes
+	// zeichnen, sonst bleibt es stehen.
+	void draw( SDL_Renderer *renderer, double anteil = 1.0);
+
+	// Eine Prüfsumme (FNV-1a) über den Zustand: Zeit, Einheiten, Türme und
+	// Geschosse.
+	// Zwei Läufe mit der gleichen Summe sind (so gut wie sicher) gleich
+	// verlaufen.
+	uint64_t pruefsumme() const;
+
+	// Der ganze Zustand der Simulation: Einheiten, Türme, Geschosse,
+	// Zeitplaner, Wellen, Flussfeld, Pfad und Wegpunkte. Nur zwischen zwei
+	// update(). Siehe Schnappschuss.h.
+	// Was keinen Einfluss auf das Ergebnis hat, bleibt draußen: Zielsuche,
+	// Threads, Kern, Profiler.
+	Schnappschuss schnappschuss() const;
+
+	// Macht genau dort weiter, wo schnappschuss() war. Danach kommt mit den
+	// gleichen Eingaben das Gleiche heraus, auch die gleiche pruefsumme().
+	// Im Schnappschuss stehen nur die Nummern der Arten. Werte und Bilder
+	// kommen aus arten(), die muss also die gleiche Tabelle sein wie beim
+	// Speichern. Die Texture der Spawn-Vorlagen kommt von 'einheit', so wie
+	// beim Einrichten des Spiels.
+	// Wirft std::runtime_error, wenn der Schnappschuss nicht passt. Die Welt
+	// ist dann nur noch zum Wegwerfen gut.
+	void lade( const Schnappschuss &s, const Einheit &einheit);
+
+	private:
+		void zielsucheNaiv( Uint32 jetzt);
+		void zielsucheRaster( Uint32 jetzt);
+		void zielsucheParallel( Uint32 jetzt);
+		void zielsucheStrecke( Uint32 jetzt);
+		void zielsucheBesondere( Uint32 jetzt);
+
+		// Turm t schießt, solange er kann, auf die Einheiten mit der
+		// kleinsten Nummer größer 'letztes'.
+		void schiesseReihum( Turm &t, Uint32 jetzt, long letztes);
+
+		// Turm t hat Einheit i getroffen. Gibt true zurück, wenn sie tot ist.
+		bool treffer( Turm &t, unsigned int i);
+
+		// Alle bis 'radius' um Einheit i herum bekommen 'schaden' ab. i
+		// selber nicht. Gibt zurück, wie viele daran gestorben sind.
+		unsigned int splash( unsigned int i, int radius, int schaden);
+
+		// Wer am Ausgang ist, verschwindet. Siehe entkommenLassen.
+		void lasseEntkommen();
+
+		// Bewegt die Geschosse und verteilt ihre Treffer.
+		void bewegeGeschosse( int frameZeit);
+
+		// Sortiert die Einheiten in das Raster, falls das in diesem Frame
+		// noch keiner gemacht hat.
+		void baueRaster();
+		bool m_rasterAktuell = false;
+
+		// Siehe setzeArten(). Der Pool und die Türme zeigen hinein.
+		std::shared_ptr<const Arten> m_arten;
+
+		// Für zielsucheStrecke. Muss neu, wenn ein Turm dazukommt oder sich
+		// der Weg ändert.
+		Abdeckung m_abdeckung;
+		bool m_abdeckungAktuell = false;
+		const WaypointList *m_abdeckungWegpunkte = nullptr;
+
+		// Wie gern schießt Turm t auf Einheit i an x,y? Je größer, desto
+		// lieber.
+		double wertung( const Turm &t, unsigned int i, int x, int y) const;
+
+		// Ein Ereignis aus dem Zeitplaner ist fällig.
+		void ereignis( const Zeitplaner::Ereignis &e);
+
+		// Setzt alle Einheiten der Wellen ein, die bis jetzt fällig sind.
+		void spawneWellen( Uint32 jetzt);
+
+		// Eine Welle merkt sich nur, wie viele sie schon gespawnt hat. Wie
+		// viele es jetzt sein müssten, lässt sich aus der Zeit ausrechnen.
+		// So braucht es kein Ereignis pro Einheit.
+		struct Welle{
+			uint32_t vorlage;	// Stelle in m_spawnVorlagen
+			Uint32 start;
+			Uint32 intervall;
+			uint32_t anzahl;	// 0 = ohne Ende
+			uint32_t gespawnt;
+		};
+		std::vector<Welle> m_wellen;
+		std::vector<Einheit> m_spawnVorlagen;
+
+		// Kommen noch alle Einheiten, auch die, die noch gespawnt werden,
+		// zum Ziel?
+		bool alleKommenDurch() const;
+
+		bool m_mitFlussfeld = false;
+
+		// Für zielsucheParallel: pro Turm die Einheiten in Reichweite mit
+		// den kleinsten Nummern, höchstens KANDIDATEN Stück.
+		static const unsigned int KANDIDATEN = 16;
+
+		// Für zielsucheBesondere: die Einheiten in Reichweite eines Turms,
+		// als Heap. Oben liegt die mit der besten Wertung.
+		struct Ziel{
+			double wertung;
+			uint32_t index;
+
+			// Bei gleicher Wertung gewinnt die kleinere Nummer.
+			bool operator<( const Ziel &z) const{
+				return wertung < z.wertung || (wertung == z.wertung && index > z.index);
+			}
+		};
+};
+
+// Der Weg, den die Gegner ablaufen.
+// Fenster und Headless-Modus sollen den gleichen Weg nutzen.
+// breite und hoehe sind die Größe der Einheiten.
+WaypointListZeiger erstelleWegpunkte( int breite = 32, int hoehe = 32);
+
+// So fängt das Spiel an: eine Einheit der Art 'einheitArt' ist schon da,
+// jede Sekunde kommt eine weitere dazu. Sie laufen über das Flussfeld nach
+// unten rechts.
+// Die Türme, die der Spieler baut, sind Kopien von 'turm', der Art
+// 'turmArt'. Der "geschuetz" aus Arten::standard() schießt mit Geschossen.
+// Beide kommen aus welt.arten(), 'einheit' und 'turm' werden hier
+// eingerichtet. Wirft, wenn es eine der Arten nicht gibt.
+// Das Fenster und das Abspielen einer Aufnahme müssen gleich anfangen.
+void richteSpielEin( Welt &welt, Einheit &einheit, Turm &turm,
+		const std::string &einheitArt = "gegner", const std::string &turmArt = "geschuetz");
+
+#endif // WELT_H
@@ -0,0 +1,71 @@
+#include "Zeitplaner.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+const uint32_t Zeitplaner::KEINS;
+
+void Zeitplaner::plane( Uint32 faellig, Uint32 intervall, Art art, uint32_t id){
+	// Was in der Vergangenheit oder genau jetzt fällig wäre, kommt in der
+	// nächsten Millisekunde dran. Die aktuelle ist ja schon vorbei.
+	if( faellig <= m_zeit) faellig = m_zeit + 1;
+
+	uint32_t k;
+	if( m_frei != KEINS){
+		k = m_frei;
+		m_frei = m_naechstes[k];
+		m_ereignisse[k] = {faellig, intervall, art, {0, 0, 0}, id};
+	}else{
+		k = m_ereignisse.size();
+		m_ereignisse.push_back({faellig, intervall, art, {0, 0, 0}, id});
+		m_naechstes.push_back(KEINS);
+	}
+	haengeAn(m_faecher[faellig % SLOTS], k);
+}
+
+void Zeitplaner::speichere( Schnappschuss::Schreiber &s) const{
+	s.wert(m_zeit);
+	s.feld(m_faecher.data(), m_faecher.size());
+	s.feld(m_ereignisse);
+	s.feld(m_naechstes);
+	s.wert(m_frei);
+}
+
+void Zeitplaner::lade( Schnappschuss::Leser &l){
+	m_zeit = l.wert<Uint32>();
+	l.feld(m_faecher.data(), m_faecher.size());
+	l.feld(m_ereignisse);
+	l.feld(m_naechstes);
+	m_frei = l.wert<uint32_t>();
+
+	// Jedes Ereignis muss in genau einer Liste stecken: im passenden Fach
+	// oder bei den freien Plätzen. Sonst greift das nächste laufe() oder
+	// plane() daneben.
+	const size_t n = m_ereignisse.size();
+	if( m_naechstes.size() != n || n >= KEINS){
+		throw std::runtime_error("Der Zeitplaner im Schnappschuss ist kaputt");
+	}
+	std::vector<char> gesehen(n, 0);
+	auto folge = [&]( uint32_t k, const Fach *fach){
+		uint32_t letztes = KEINS;
+		for( ; k != KEINS; k = m_naechstes[k]){
+			if( k >= n || gesehen[k]){
+				throw std::runtime_error("Der Zeitplaner im Schnappschuss ist kaputt");
+			}
+			gesehen[k] = 1;
+			letztes = k;
+			if( fach != nullptr && (&m_faecher[m_ereignisse[k].faellig % SLOTS] != fach
+					|| m_ereignisse[k].art != Art::TurmNachladen)){
+				throw std::runtime_error("Ein Ereignis im Schnappschuss liegt im falschen Fach");
+			}
+		}
+		if( fach != nullptr && fach->letztes != letztes){
+			throw std::runtime_error("Der Zeitplaner im Schnappschuss ist kaputt");
+		}
+	};
+	for( const auto &fach:m_faecher) folge(fach.erstes, &fach);
+	folge(m_frei, nullptr);
+	if( std::count(gesehen.begin(), gesehen.end(), 1) != (std::ptrdiff_t)n){
+		throw std::runtime_error("Der Zeitplaner im Schnappschuss ist kaputt");
+	}
+}
@@ -0,0 +1,149 @@
+/*
+ * Der Zeitplaner.
+ *
+ * Bisher hatte jeder Turm seinen eigenen SDL Timer, der ihm alle 250ms einen
+ * Schuss nachlädt. Das hat ein paar Haken:
+ * → SDL ruft die Timer in einem eigenen Thread auf. Der schreibt dann einfach
+ *   in m_shootsLeft, während die Hauptschleife den gleichen Wert liest.
+ * → Wird der std::vector mit den Türmen größer, zieht er die Türme um. Der
+ *   Timer zeigt aber noch auf die alte Adresse.
+ * → Hunderte Türme heißt hunderte Timer beim Betriebssystem.
+ * → Die Timer laufen nach der echten Uhr. Ohne Fenster, wenn die Simulation
+ *   schneller als die echte Zeit läuft, passt das nicht zusammen.
+ *
+ * Also machen wir das selber. Der Zeitplaner läuft mit der Zeit der
+ * Simulation mit und wird von der Hauptschleife aus bedient. Kein zweiter
+ * Thread, keine Zeiger auf Türme, immer gleiche Reihenfolge.
+ *
+ * Er ist ein sogenanntes Timer-Rad: ein Ring aus SLOTS Fächern, eins pro
+ * Millisekunde. Ein Ereignis, das zur Zeit t fällig ist, liegt im Fach
+ * t % SLOTS. Läuft die Zeit eine Millisekunde weiter, schauen wir nur in das
+ * eine Fach. Ereignisse, die erst eine Runde später dran sind, bleiben einfach
+ * liegen. Einplanen und Auslösen kostet so im Schnitt O(1).
+ * */
+#ifndef ZEITPLANER_H
+#define ZEITPLANER_H
+
+#include <SDL.h>
+
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "Schnappschuss.h"
+
+class Zeitplaner {
+	public:
+		// Was soll passieren?
+		// Die id sagt, wen es betrifft, zB die Nummer des Turmes.
+		// (Gespawnt wird über die Wellen der Welt, die brauchen kein
+		// Ereignis pro Einheit.)
+		enum class Art : uint8_t{
+			TurmNachladen
+		};
+
+		struct Ereignis{
+			Uint32 faellig;		// Wann? In ms Simulationszeit.
+			Uint32 intervall;	// Danach alle wie viele ms? 0 heißt nur einmal.
+			Art art;
+			uint8_t frei[3];	// Keine Lücke, siehe unten
+			uint32_t id;
+		};
+
+		static const Uint32 SLOTS = 256;
+
+		// Wie SDL_AddTimer, nur mit einem festen Zeitpunkt in der
+		// Simulationszeit.
+		void plane( Uint32 faellig, Uint32 intervall, Art art, uint32_t id);
+
+		// Lässt die Zeit bis einschließlich 'bis' laufen und ruft für jedes
+		// fällige Ereignis f(ereignis) auf. Wiederkehrende Ereignisse werden
+		// danach neu eingeplant.
+		// Innerhalb einer Millisekunde in der Reihenfolge, in der sie
+		// eingeplant wurden.
+		// Liegt 'bis' nicht nach zeit(), passiert nichts. Die Zeit läuft
+		// nicht rückwärts, und sie läuft auch nicht einmal ganz um die Uhr
+		// (2^32 ms), um wieder bei 'bis' anzukommen.
+		template<typename F>
+		void laufe( Uint32 bis, F f){
+			if( (int32_t)(bis - m_zeit) <= 0) return;
+			while( m_zeit != bis){
+				++m_zeit;
+				Fach &fach = m_faecher[m_zeit % SLOTS];
+				if( fach.erstes == KEINS) continue;
+
+				// Das Fach wird geleert, bevor wir die Ereignisse abarbeiten.
+				// Sonst würde ein Ereignis mit einem Intervall von genau
+				// SLOTS (oder einem Vielfachen) im gleichen Fach landen und
+				// gleich nochmal drankommen.
+				uint32_t k = fach.erstes;
+				fach.erstes = fach.letztes = KEINS;
+				while( k != KEINS){
+					const uint32_t weiter = m_naechstes[k];
+					if( m_ereignisse[k].faellig != m_zeit){
+						// Noch nicht dran, erst in einer späteren Runde.
+						haengeAn(fach, k);
+					}else{
+						// Eine Kopie: f und plane dürfen m_ereignisse
+						// wachsen lassen.
+						const Ereignis e = m_ereignisse[k];
+						gibFrei(k);
+						f(e);
+						if( e.intervall > 0){
+							plane(e.faellig + e.intervall, e.intervall, e.art, e.id);
+						}
+					}
+					k = weiter;
+				}
+			}
+		}
+
+		// Bis wohin ist die Zeit schon gelaufen?
+		Uint32 zeit() const{
+			return m_zeit;
+		}
+
+		// Die Zeit und alle geplanten Ereignisse, siehe Schnappschuss.h.
+		void speichere( Schnappschuss::Schreiber &s) const;
+		void lade( Schnappschuss::Leser &l);
+
+	private:
+		static const uint32_t KEINS = 0xFFFFFFFFu;
+
+		// Ein Fach ist eine verkettete Liste durch m_ereignisse. So braucht
+		// nicht jedes Fach seinen eigenen std::vector, der wächst, wenn
+		// viele Türme zur gleichen Millisekunde nachladen.
+		struct Fach{
+			uint32_t erstes = KEINS;
+			uint32_t letztes = KEINS;
+		};
+
+		void haengeAn( Fach &fach, uint32_t k){
+			m_naechstes[k] = KEINS;
+			if( fach.letztes == KEINS) fach.erstes = k;
+			else m_naechstes[fach.letztes] = k;
+			fach.letztes = k;
+		}
+
+		void gibFrei( uint32_t k){
+			m_naechstes[k] = m_frei;
+			m_frei = k;
+		}
+
+		Uint32 m_zeit = 0;
+		std::array<Fach, SLOTS> m_faecher;
+
+		// Alle Ereignisse liegen in einem Pool. Abgearbeitete Plätze kommen
+		// in die Liste der freien Plätze (über m_naechstes) und werden vom
+		// nächsten plane() wieder benutzt. Neuer Speicher wird nur gebraucht,
+		// wenn gleichzeitig mehr Ereignisse geplant sind als je zuvor.
+		std::vector<Ereignis> m_ereignisse;
+		std::vector<uint32_t> m_naechstes;
+		uint32_t m_frei = KEINS;
+};
+
+// Die Ereignisse kommen Byte für Byte in den Schnappschuss. Gleiche Pläne
+// sollen dort auch gleiche Bytes ergeben, also keine Lücken mit Zufall.
+static_assert(sizeof(Zeitplaner::Ereignis) == 16, "Im Ereignis sollen keine Lücken sein");
+
+#endif // ZEITPLANER_H
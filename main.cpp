@@ -37,509 +37,29 @@
 #include <memory>
 
 #include <functional>
+#include <fstream>
+#include <string>
 
 // Für ein paar Mathefunktionen
 #include <cmath>
 
-/*
- * Das hier ist eine kleine Hilfsfunktion.
- * An sich ist sie wohl auch als ASSERT bekannt.
- * Man nimmt an, dass etwas stimmt. Und wenn nicht, dann ist es schlimm. In
- * diesem Fall nutzen wir die Funktion für SDL Funktionen. Sollte jene kritisch
- * sein und fehlschlagen, dann werfen wir eine Exception mit dem passenden
- * Fehler.
- * */
-void SDL_ANNAHME( bool stimmt){
-	if(!stimmt){
-		throw std::runtime_error(std::string() + SDL_GetError());
-	}
-}
-
-/*
- * Eine plumpe Kopie der Zeilen oben drüber.
- * (Vielleicht später geschickt ummodeln.)
- * */
-void IMG_ANNAHME( bool stimmt){
-	if(!stimmt){
-		throw std::runtime_error(std::string() + IMG_GetError());
-	}
-}
-
-
-/*
- * Was wollen wir...
- * → Einheiten bewegen
- * Dazu brauchen wir:
- * → eine Bewegung pro Frame
- * → eine "Einheit"
- * → ein Weg
- *
- * Egal wie viele Frames man pro Sekunde hat, soll sich eine Einheit gleich
- * bewegen. Die Bewegung muss also Abhängig von den Frames je Sekunde sein.
- * Je mehr FPS, desto kleinere Schritte.
- *
- * Jetzt basteln wir uns eine Einheit.
- * Das wird eine eigene Klasse.
- * → Update soll jeden Frame aufgerufen werden und die Position neu berechnen
- * → Draw soll die Einheit zeichnen
- * Beide müssen public sein, damit sie von außen aufgerufen werden können.
- *
- * Erstmal haben wir einen ziemlich einfachen Weg. Er geht nur von 0,0 nach
- * 1024,768.
- * Es wäre aber praktisch, wenn wir einen beliebigen Weg laufen könnten. Immer
- * in Teilabschnitte - versteht sich.
- * Waypoints machen sich da nicht schlecht.
- * Wir brauchen also eine Liste von Wegpunkten.
- * Und dann laufen wir diese ab.
- * Viele Einheiten sollen später auf dem gleichen Weg laufen. Also ist es
- * besser, wie auch bei der Texture, dass die Einheiten sich die Wegpunkte
- * teilen. 
- * Die Einheit muss also nur wissen:
- * → Wo ist die Liste mit Wegpunkten
- * → Wo ist mein nächster Punkt
- * 
- * Gut. Das wäre das.
- * */
-
-/*
- * Faulheit!
- * Wir erstellen ein paar Synonyme.
- * Es ist kürzer einfach 'Point' als Type zu verwenden, als dieses std::array...
- * Auch der Zeiger würde ausgeschrieben um einiges länger sein, und ggf. etwas
- * unverständlich. So kann man dem Typ auch eine kleine Bedeutung anhängen.
- * */
-typedef std::array<int, 2> Point;
-typedef std::vector<Point> WaypointList;
-typedef std::shared_ptr<WaypointList> WaypointListZeiger;
-
-// Der shared_ptr ist ein Konstrukt, der im Prinzip ein * Zeiger ist.
-// Er sorgt aber dafür, dass, sobald keiner mehr den Zeiger verwendet, dieser
-// gelöscht wird. Man muss also nicht acht geben, wann man wohlmöglich ein
-// 'delete' setzen müsste. 
-
-class Einheit {
-	public:
-        // Hier sind wir richtig.
-		// Es gibt ein paar kleine Methoden für eine Klasse, die an speziellen
-		// Orten aufgerufen werden. 
-		// Man kenn sie als Konstruktoren
-		// Es gibt ein paar davon.
-		// Gerade interessieren wir uns für den Copy-Constructor
-		// Mit diesem sehen wir, dass wir unten in die Liste nicht das Objekt
-		// selber, sondern eine Kopie davon reinstecken.
-		//
-		// C++ baut automatisch diese Konstruktoren, wenn er es kann.
-		// Da wir nichts "seltsames" nutzen, hat uns C++ die Konstruktoren
-		// passend eingesetzt.
-		// Jetzt bauen wir uns einen eigenen.
-		// 
-		// Kopierkonstruktor
-		// Wir erstellen also eine Kopie. Von einem Objekt, dass vom gleichen
-		// Typ ist.
-		// Das ist die Zuweisung von Werten zu unserem Objekt
-		// Wir übernehmen die Werte, die die einheit (Parameter) hat.
-		// An sich könnten wir das auch innerhalb der Methode, also in den {}
-		// machen, aber hier oben nach dem : werden die Werte sowieso festgelegt
-		// Schreiben wir also erst in den {} Werte in die Variablen, so werden
-		// diese 2 mal geschrieben. Einmal oben nach dem : und einmal im {}
-		//
-		Einheit( const Einheit &einheit)
-			: m_texture(einheit.m_texture)
-			, m_rect(einheit.m_rect)
-			, m_zielPosition(einheit.m_zielPosition)
-			, m_restBewegung( einheit.m_restBewegung)
-			, m_geschwindigkeit(einheit.m_geschwindigkeit)
-			, m_naechsterWegpunktID(einheit.m_naechsterWegpunktID)
-			, m_naechsterWegpunkt(einheit.m_naechsterWegpunkt)
-			, m_alleWegpunkte(einheit.m_alleWegpunkte)
-			, m_leben(einheit.m_leben)
-		{
-			// Lassen wir das Programm jetzt laufen, so sehen wir: 
-			// der Konstruktor unten wird nur ein mal aufgerufen
-			// der Kopier-Konstruktor hier jedoch öfter. Und zwar genau dann,
-			// wenn wir eine neue Einheit in die Liste der aktiven Einheiten
-			// stecken.
-			//std::clog << "[Einheit] Kopier-Konstruktor" << std::endl;
-		}
-
-		// Das hier ist der ganz normale Konstruktor.
-		// Er wird aufgerufen bei zB: 
-		//		Einheit e;
-		Einheit(){
-			//std::clog << "[Einheit] Konstruktor" << std::endl;
-		};
-
-		// Wir geben nichts zurück.
-		// Aber wir brauchen die Information, wie viel Zeit für den Frame
-		// verstrichen ist. Je größer die Zeit, desto weiter müssen wir uns
-		// bewegen. Heißt aber auch, dass nur wenig FPS da sein werden.
-		// Sind viele FPS da, wird die Zeit pro Frame kleiner, und wir bewegen
-		// uns in kleineren Schritten.
-		void update( int frameZeit){
-
-			// In m_rect steckt x und y, welche wir nutzen können um zu sagen,
-			// an welcher Position wir sind und die Texture zeichnen wollen
-			//
-			// Wir sind an x,y und wollen zum Ziel.
-			// Nehmen wir Vektoren.
-			// Ziel - Anfang == Weg
-			//
-			// Wir brauche double für die weiteren Berechnungen. 
-
-			double wegX = m_naechsterWegpunkt[0] - m_rect.x;
-			double wegY = m_naechsterWegpunkt[1] - m_rect.y;
-
-            // Wir sollen insgesamt eine Stecke ablaufen von ?
-			// Das dürfte der Betrag des Insgesamtweg Vektors sein
-			// also von 0,0 nach 1024,768
-			// Vektorrechnung!
-			// Die Wurzel aus a² + b²
-			//auto gesamtWeg = std::sqrt( 1024*1024 + 768*768);
-
-			// Den Weg in 3 Sekunden, also 3000ms
-			// das sind dann also 
-			// 4.2666667
-			//auto pixelProSekunde = gesamtWeg / (m_speed * 1000);
-
-
-            // Unser restlicher Weg ist mit wegX,Y gegeben.
-			// Wie lang ist dieser?
-			auto wegLaenge = std::sqrt( wegX*wegX + wegY*wegY);
-			
-
-			// Ist der Weg größer, als das, was wir innerhalb der Zeit schaffen
-			// würden, dann dürfen wir nicht soweit gehen.
-			// Pro MS dürfen wir maximal 4 Pixel gehen. Das legen wir jetzt
-			// einfach so fest. 
-			// Wir werden pro Frame nicht immer genau eine Millisekunde Zeit
-			// haben. Also können wir auch nicht immer nur maximal 4 Schritte
-			// gehen. Haben wir mehr Zeit gebraucht, gehen wir weiter. Wir
-			// müssen also die 4 mit der Zeit für einen Frame multiplizieren.
-			// Speed ist zur Zeit die angabe, wie lange die Einheit für einen
-			// "Streckenabschnitt" benötigen darf. 1 heißt 1Sekunde, 5 sind 5
-			// Sekunden.
-			// Besser ist eine Geschwindigkeit in Pixel pro Millisekunde.
-			//  s = v*t --- weg ist geschwindigkeit * zeit
-			// Je kleiner die Geschwindigkeit desto kürzer der Weg in gleicher
-			// Zeit.
-			//
-			auto derWeg = m_geschwindigkeit * frameZeit;
-			if( wegLaenge > derWeg){
-				// Ist der Weg zu lang, dann kürzen wir ihn soweit, dass es
-				// genau 4 Pixel werden.
-				auto scale = derWeg/wegLaenge;
-				wegX *= scale;
-				wegY *= scale;
-			}else{
-				// Wir schaffen des letzten Rest in einem Zug!
-				// Wir können also uns danach auf den nächsten Wegpunkt stürzen
-				// Vorher müssen wir aber feststellen, ob es noch einen nächsten
-				// Wegpunkt gibt oder ob wir schon am Ziel sind.
-				if( m_naechsterWegpunktID < m_alleWegpunkte->size()){
-					m_naechsterWegpunkt = m_alleWegpunkte->at( m_naechsterWegpunktID);
-					++m_naechsterWegpunktID;
-				}
-			}
-
-			// Was hinter dem Komma kommt, das schmeißen wir mit in die
-			// restliche Bewegung rein.
-			int iwegX = (int)std::floor(wegX);
-			int iwegY = (int)std::floor(wegY);
-			m_restBewegung[0] += (wegX - iwegX);
-			m_restBewegung[1] += (wegY - iwegY);
-
-
-			// Ist die restliche Bewegung größer gleich einem Pixel auf einer
-			// Achse, dann nehmen wir den Pixel und packen ihn zu der Bewegung
-			// mit hinzu.
-			int restX = (int)std::floor(m_restBewegung[0]);
-			int restY = (int)std::floor(m_restBewegung[1]);
-			iwegX += restX;
-			iwegY += restY;
-			m_restBewegung[0] -= restX;
-			m_restBewegung[1] -= restY;
-
-
-
-			// pro Millisekunde also 4.266 Pixel
-			// Schwierig. Es gibt selten Pixel, die kleiner 1 sind ;-)
-			//
-			// Die Pixel, die wir gehen dürfen, bewegen wir uns jetzt weiter.
-			//
-
-			m_rect.x += iwegX;
-			m_rect.y += iwegY;
-		
-		}
-
-		// Wir geben auch hier nichts zurück.
-		// Aber wir müssen wissen, wo wir die Einheit hinmalen sollen, auf
-		// welchen renderer. Deswegen übergeben wir diesen.
-		// In der Main-Funktion liegt der renderer schon in einem Zeiger, also
-		// nutzen wir das und verlangen hier auch einfach einen Zeiger.
-		//
-		// Wir kopieren die Texture an die passende Stelle auf die
-		// Render-Fläche. Das haben wir ja schon weiter unten im Code gemacht.
-		void draw(SDL_Renderer *renderer){
-			SDL_RenderCopy(renderer, m_texture, nullptr, &m_rect);
-		}
-
-		// Irgendwoher müssen wir ja unsere Texture bekommen. In dem Fall
-		// übergeben und setzen wir sie hier.
-		// Diese Methode muss dann aber auch vor dem ersten draw aufgerufen
-		// werden!
-		// In der  Texture steckt die Größe nicht drin, also müssen wir die auch
-		// noch erfahren.
-		void init( SDL_Texture *texture, SDL_Rect rect){
-			m_texture = texture;
-			m_rect.x = rect.x;
-			m_rect.y = rect.y;
-			m_rect.w = rect.w;
-			m_rect.h = rect.h;
-		}
-
-
-		// wir setzen die Liste der Wegpunkte
-		void setzeWegpunkte( WaypointListZeiger wegpunkte){
-			m_alleWegpunkte = wegpunkte;
-
-			// Wir haben die Liste.
-			// Also setzten wir doch gleich das erste Ziel
-			m_naechsterWegpunkt = m_alleWegpunkte->at(0);
-			m_naechsterWegpunktID = 1;
-		}
-
-
-		// An sich könnten wir so neue Wegpunkte in die Liste einfügen. Aber
-		// hier brauchen wir das nicht.
-		//void hinzufuegenWegpunkte( WaypointListZeiger wegpunkte){
-			//m_alleWegpunkte->insert(m_alleWegpunkte->end(), wegpunkte->begin(), wegpunkte->end());
-		//}
-		
-        Point getPosition(){
-			return {{m_rect.x, m_rect.y}};
-		}
-
-
-		// Wir wurden getoffen!
-		// Unser Leben sinkt...
-		// Sind wir tot, leben <= 0, dann ist es vorbei
-		bool gotHit(int damage){
-			m_leben -= damage;
-			return m_leben <= 0;
-		}
-	private:
-		// Private heißt, dass nur *ich*, also die Klasse selber zugriff auf die
-		// Variable oder Methode hat. Keiner kann diese von außen verändern oder
-		// lesen. Nicht einmal abgeleitete Klassen.
-		// 
-		// Um während des draw etwas zeichnen zu können, müssen wir auch etwas
-		// zeichenbares haben. Also am besten eine Texture.
-		// Wir könnten nun eine eigene Texture für jede Einheit nehmen. Aber da
-		// die Einheiten meist gleich sind, dürfen sie sich auch eine Texture
-		// teilen. Das spart Speicherplatz.
-		SDL_Texture *m_texture = nullptr;
-		SDL_Rect m_rect{0,0,0,0};
-
-		// Wir kennen ja noch die Größe des Fensters. Laufen wir also einfach
-		// mal schräg rüber (sofern wir bei 0,0 starten sollten).
-		// TODO natürlich müssen wir das nacher noch ordentlich machen.
-		// FIXME Ich weiß, dass die Texture 32x32 groß ist. Die Größe ziehe ich
-		// von der ZielPosition ab, damit ich unten rechts die Einheit auch noch
-		// sehe.
-		// 
-		std::array<int,2> m_zielPosition{{1024-32,768-32}};
-
-		// Wir bewegen uns ja immer in Pixeln. Die Berechnungen sind aber teis
-		// Komma-Werte. Also müssen wir irgendwo das absichern, was wir
-		// "abschneiden". Ist das abgeschnittene groß genug, hängen wir es an
-		// die Bewegung dran.
-		std::array<double,2> m_restBewegung{{0,0}};
-
-		// Probieren wir mal in 3 Sekunden es über den Bildschirm zu schaffen.
-		// Irgendwie war 4 viel zu schnell.
-		// Mit 1 geht es besser. Stimmt aber jetzt nicht mehr als "Sekunden"
-		//
-		// So passt das. Die Gesamtstrecke ist ja gerade noch 1280 px. Die will
-		// ich in 2 Sekunden bestreiten. Also 640 px pro Sekunde.
-		// Die 2 kann ich jetzt einfach durch andere Sekunden erstetzen. Mehr
-		// ist langsamer, weniger ist schneller.
-		double m_geschwindigkeit = (1280.0 /2.0)/1000.0; // 0.320; // in px / ms
-
-
-		uint32_t m_naechsterWegpunktID = 0;
-		Point m_naechsterWegpunkt{{0,0}};
-		WaypointListZeiger m_alleWegpunkte = nullptr;
-
-
-		int m_leben = 5;
-};
-
-
-struct TurmShootRecoverData{
-	class Turm *turm;
-};
-
-unsigned int turmShootRecover( unsigned int interval, void *data);
-
-/*
- * Als nächstes der Tower.
- * Er ist fest.
- * Er schießt auf Gegner in einem bestimmten Radius.
- *
- * */
-class Turm {
-	public:
-        Turm(){
-			m_timerID = SDL_AddTimer(250, turmShootRecover, &m_tsrd);
-		
-		}
-
-		Turm( const Turm &turm)
-		: m_texture(turm.m_texture)
-		, m_rect(turm.m_rect)
-		, m_shootsLeft(turm.m_shootsLeft)
-		, m_reichweite(turm.m_reichweite)
-		, m_reichweite2(turm.m_reichweite2)
-		, m_timerID(0)
-		, m_tsrd({this})
-		, m_coolDown(turm.m_coolDown)
-		, m_lastShoot(turm.m_lastShoot)
-		{
-			m_timerID = SDL_AddTimer(250, turmShootRecover, &m_tsrd);
-		}
-
-		~Turm(){
-			SDL_RemoveTimer(m_timerID);
-		}
-
-        void init( SDL_Texture *texture, SDL_Rect rect){
-			m_texture = texture;
-			m_rect = rect;
-		}
-
-		void update( int frameZeit){
-			// TODO
-			// Es wäre natürlich ganz praktisch noch ein paar Schüsse zu haben
-			// Soll er doch bei jedem Update eine dazu bekommen ...
-			// TODO Natürlich sollte hier eine Zeit eingesetzt werden.
-			// Vielleicht nach jeder Sekunde oder so. Aber zum Testen sollte es
-			// erstmal so gehen
-		
-		}
-
-		void recoverShoot(){
-			++m_shootsLeft;
-			//std::clog << "Recovered to " << m_shootsLeft << std::endl;
-		}
-
-		void draw( SDL_Renderer *renderer){
-			SDL_RenderCopy(renderer, m_texture, nullptr, &m_rect);
-		}
-
-        /*
-		 * 
-		 * 1) Haben wir noch Schuss übrig?
-		 * 2) Schauen ob sich Einheit in Reichweite befindet
-		 * 3) Schießen.
-		 *
-		 * */
-		bool shoot( Einheit &einheit){
-			if( m_shootsLeft <= 0) return false;
-
-			// Soll nur aller xx ms schießen können
-			// Braucht also cool down
-			//
-            auto currentTime = SDL_GetTicks();
-			auto diffTime = currentTime - m_lastShoot;
-			if( m_coolDown > diffTime){
-				return false;
-			}
-
-
-			auto ePos = einheit.getPosition();
-
-			// Der Vektor von hier zum Gegner
-			Point zielVector{{ ePos[0] - m_rect.x, ePos[1] - m_rect.y}};
-
-			// Die länge des Weges quadriert.
-			auto weg = zielVector[0]*zielVector[0] + zielVector[1]*zielVector[1];
-
-			// Wir können das Quadrat nutzen, weil in unserem Fall
-			// sqrt(a) <= sqrt(b)  auch gleich a <= b
-			// wir sparen also die Berechnung der Wurzel
-			// Tja, ist also der Weg bis zum Gegner größer als unsere
-			// Reichweite, dann hören wir auf.
-			if( weg > m_reichweite2) return false;
-
-			// An dieser Stelle wissen wir:
-			// - wir haben noch Schüsse übrig
-			// - der Gegner ist in Reichweite
-			// → also schießen wir
-			// Wir haben dann einen Schuss weniger.
-			// Der eigentliche Schuss wird an anderer Stelle behandelt.
-			--m_shootsLeft;
-			m_lastShoot = currentTime;
-			return true;
-		}
-
-		Point getPosition(){
-			return {{m_rect.x, m_rect.y}};
-		}
-
-		void setPosition( int x, int y){
-			m_rect.x = x;
-			m_rect.y = y;
-		}
-	private:
-		SDL_Texture *m_texture = nullptr;
-		SDL_Rect m_rect{0,0,0,0};
-		//Point m_rotation; // Wo schaut er hin. Brauchen wir aber erstmal nicht.
-		
-		int m_shootsLeft = 0;
-		//int m_maxShoots = 1; // FIXME: wird gerade nicht benutzt
-		// Ein Feld ist jetzt mal 32px breit. Die Reichweite ist 5 Felder.
-		int m_reichweite = 32*5;
-		int m_reichweite2 = m_reichweite*m_reichweite; // das quadrat davon
-		
-		int m_timerID = 0;
-		TurmShootRecoverData m_tsrd{this};
-		unsigned int m_coolDown = 250;
-		int m_lastShoot = 0;
-};
-
-unsigned int turmShootRecover( unsigned int interval, void *data){
-	
-	TurmShootRecoverData *tsrd = static_cast<TurmShootRecoverData*>(data);
-	tsrd->turm->recoverShoot();
-	return interval;
-}
-
-/*
- * structs sind auch nur Klassen
- * ohne Angabe von public oder private sind die angegebenen Werte public, bei
- * class hingegen private
- * */
-struct SpawnInfo{
-	public:
-		std::vector<Einheit> *einheiten;
-		Einheit *basicEinheit;
-	private:
-
-};
-
-unsigned int spawnEinheit( unsigned int interval, void *info){
-	SpawnInfo *i = static_cast<SpawnInfo*>(info);
-	i->einheiten->push_back(*(i->basicEinheit));
-
-	return interval;
-}
-
-void erstelleNeuenTurm(SDL_MouseButtonEvent &event, std::vector<Turm> &aktiveTuerme, Turm &turm){
-	Turm t{turm};
-	t.setPosition(event.x - 16, event.y - 16);
-	std::clog << "Neuer Turm bei " << event.x << " " << event.y << std::endl;
-	aktiveTuerme.push_back(t);
+// Die Hilfsfunktionen für Fehler, die Einheit, der Turm und die Welt wohnen
+// inzwischen in eigenen Dateien.
+#include "Annahme.h"
+#include "Einheit.h"
+#include "Turm.h"
+#include "Welt.h"
+#include "Logbuch.h"
+#include "Headless.h"
+#include "Stapel.h"
+#include "Aufzeichnung.h"
+#include "Atlas.h"
+
+
+void erstelleNeuenTurm(SDL_MouseButtonEvent &event, Welt &welt, Turm &turm){
+	// Das Abspielen einer Aufnahme baut seine Türme genauso. Darum steckt
+	// das jetzt in der Welt.
+	welt.baueTurm(turm, event.x, event.y);
 }
 
 /* Die Standard-Funktion eines jeden C++ Programms: main
@@ -553,6 +73,10 @@ void erstelleNeuenTurm(SDL_MouseButtonEvent &event, std::vector<Turm> &aktiveTue
  * */
 int main(int argc, char **argv){
 
+	// Ohne Fenster? Dann geht es woanders weiter.
+	if( istHeadless(argc, argv)) return starteHeadless(argc, argv);
+	if( istStapel(argc, argv)) return starteStapel(argc, argv);
+
 	/*
 	 * Legen wir ein paar Variablen an.
 	 * Ein Zeiger auf einen Renderer, auf dem wir später Grafiken zeichnen.
@@ -565,28 +89,12 @@ int main(int argc, char **argv){
 	SDL_Event event;
 
 
-	/*
-	 * Wir brauchen ein Bild. Das nutzen wir um damit den Web abzulaufen, den
-	 * die Gegner gehen sollen.
-	 *
-	 * Beim Laden eines Bildes erhalten wir zunächst ein Surface. Das wandeln
-	 * wir anschließend in eine Texture. Diese lässt sich leicht auf unseren
-	 * renderer zeichnen.
-	 * Außerdem brauchen wir ein Rechteck. Dort packen wir dann x,y,w,h unseres
-	 * Bildes rein.
-	 * */
-	SDL_Surface *surface = nullptr;
-	SDL_Texture *textureEinheit = nullptr;
-	SDL_Texture *textureTurm = nullptr;
-	SDL_Rect rectEinheit{0,0,0,0};
-	SDL_Rect rectTurm{0,0,0,0};
-
-	// Eine Liste aller aktiven Einheiten
-	// so können wir diese leichter überwachen
-	std::vector<Einheit> aktiveEinheiten;
-	std::vector<std::vector<Einheit>::iterator> verloreneEinheiten;
-
-	std::vector<Turm> aktiveTuerme;
+	// Die Listen aller aktiven Einheiten und Türme stecken jetzt in der Welt.
+	// So können wir sie leichter überwachen.
+	Welt welt;
+	// Alle Kerne mitrechnen lassen. Das Ergebnis ist das gleiche wie mit
+	// einem.
+	welt.jobs.starte(0);
 
 
 	// "Versuchen" wir doch einfach mal. Und falls ein Fehler/ eine Ausnahme
@@ -646,84 +154,99 @@ int main(int argc, char **argv){
 				SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
 				);
 
+		// Ohne Grafikkarte gibt es keinen beschleunigten Renderer. Dann
+		// zeichnet eben die CPU, wie ohne Fenster (siehe Headless.h).
+		if( renderer == nullptr){
+			renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+		}
+
 		// Wieder hoffen wir, dass die Operation erfolgreich war. Unsere
 		// renderer Variable sollte nun auf einen Renderer zeigen.
 		SDL_ANNAHME(renderer != nullptr);
 
 
 		/*
-		 * Laden wir also das Bild.
-		 * Diesmal als PNG und mit SDL_image.
+		 * Laden wir also die Bilder.
+		 * Früher jedes einzeln mit IMG_Load, jetzt alle auf einmal im Atlas
+		 * (siehe Atlas.h). Jedes Bild holen wir uns dort über seinen Namen.
+		 * Darin steckt auch gleich seine Größe.
+		 *
+		 * Der Atlas lebt nur bis zum Ende dieses Blocks. Er gibt seine Texture
+		 * dann frei, also noch bevor unten der renderer zerstört wird.
 		 * */
-		surface = IMG_Load("images/enemy.png");
-
-		// Hoffentlich konnte das Bild geladen werden ...
-		SDL_ANNAHME(surface != nullptr);
-
-		// Aus dem surface, der "Fläche", die wir haben, erstellen wir die
-		// Texture. Und wieder ein Check, dass dies auch geklappt hat.
-		textureEinheit = SDL_CreateTextureFromSurface(renderer, surface);
-		SDL_ANNAHME(textureEinheit != nullptr);
+		Atlas atlas;
+		atlas.lade(renderer, "images");
 
 		/*
-		 * Das Bild beginnt bei 0,0 und ist w,h Pixel groß. Die Werte finden wir
-		 * in surface.
+		 * Welche Arten von Einheiten und Türmen gibt es, und wie schnell,
+		 * stark, ... sind sie? Das steht in arten.txt (siehe Arten.h), oder
+		 * in der Datei nach --arten. Ohne Datei gibt es nur die Arten, die
+		 * schon im Programm stehen. Welche Art die Gegner und der Turm zum
+		 * Bauen haben, geht mit --einheit-art und --turm-art.
+		 *
+		 * Die Bilder kommen aus dem Atlas. Danach ändert sich an der
+		 * Tabelle nichts mehr, die Welt bekommt sie nur noch zum Lesen.
 		 * */
-		rectEinheit.x = 0;
-		rectEinheit.y = 0;
-		rectEinheit.w = surface->w;
-		rectEinheit.h = surface->h;
-
-		// Das surface brauchen wir nicht mehr und können den Speicher
-		// freigeben. Sicherheitshalber setzen wir es auch auf den nullptr.
-		SDL_FreeSurface(surface);
-		surface = nullptr;
-
-        // Die Texture des Turmes
-		surface = IMG_Load("images/turret.png");
-		SDL_ANNAHME(surface != nullptr);
-		textureTurm = SDL_CreateTextureFromSurface(renderer, surface);
-		SDL_ANNAHME(textureTurm != nullptr);
-		rectTurm.x = (1024-32)/2; // Der Turm soll in der Mitte des Bildschirms
-		rectTurm.y = (768-32)/2; // angezeigt werden
-		rectTurm.w = surface->w;
-		rectTurm.h = surface->h;
-
-
-		// Wir erzeugen eine Wegpunktliste und bekommen davon einen shared_ptr
-		auto alleWegpunkte = std::make_shared<WaypointList>();
-
-		// Füllen wir ein paar Wegpunkte in die Liste
-		alleWegpunkte->push_back({{0,0}});
-		alleWegpunkte->push_back({{1024-32,0}});
-		alleWegpunkte->push_back({{0,768-32}});
-		alleWegpunkte->push_back({{1024-32,768-32}});
-		alleWegpunkte->push_back({{0,0}});
-
-		// Ein kleiner Gegner:
-		Einheit einheit;
-		einheit.init(textureEinheit, rectEinheit);
-		einheit.setzeWegpunkte(alleWegpunkte);
-
+		std::string artenDatei = "arten.txt";
+		bool artenPflicht = false;
+		std::string einheitArt = "gegner";
+		std::string turmArt = "geschuetz";
+		for( int i = 1; i + 1 < argc; ++i){
+			std::string arg = argv[i];
+			if( arg == "--arten"){
+				artenDatei = argv[i + 1];
+				artenPflicht = true;
+			}
+			if( arg == "--einheit-art") einheitArt = argv[i + 1];
+			if( arg == "--turm-art") turmArt = argv[i + 1];
+		}
+		Arten arten = Arten::standard();
+		if( artenPflicht || std::ifstream(artenDatei)) arten.lade(artenDatei);
+		arten.setzeBilder([&]( const std::string &name){ return atlas.sprite(name); });
+		welt.setzeArten(std::make_shared<const Arten>(std::move(arten)));
+
+		// Ein kleiner Gegner, und ein Türmchen als Vorlage für alle, die
+		// der Spieler baut. Der Turm steht erst einmal in der Mitte des
+		// Bildschirms.
+		//
 		// die Einheit kommt in die Liste der aktiven Einheiten
 		//
 		// ! Es kommt nicht DIESE Einheit in die Liste.
 		// Es wird eine Kopie davon erstellt!
 		// ! "einheit" bleibt hier.
 		// Am Besten mal ein kleines Stück Code dafür zur Demonstration.
-		aktiveEinheiten.push_back(einheit);
-
-
-		// Ein Türmchen
+		//
+		// Jede Sekunde kommt eine neue Einheit dazu.
+		// Das erledigt der Zeitplaner der Welt, kein SDL Timer mehr.
+		Einheit einheit;
 		Turm turm;
-		turm.init(textureTurm, rectTurm);
-		//aktiveTuerme.push_back(turm);
-
-		std::vector<std::array<int,4>> zuZeichnendeSchuesse;
-
+		richteSpielEin(welt, einheit, turm, einheitArt, turmArt);
 
-		SpawnInfo i{&aktiveEinheiten, &einheit};
-		auto spawnTimer = SDL_AddTimer(1000, spawnEinheit, &i);
+		// Mit --aufnahme datei schreiben wir alle Eingaben mit.
+		// Abspielen geht mit --headless --replay datei.
+		//
+		// Mit --profil wird jeder Abschnitt eines Frames gemessen, und mit
+		// den FPS kommt jede Sekunde eine Tabelle. Mit --trace datei landen
+		// am Ende alle Messungen in der Datei, für chrome://tracing.
+		// Siehe Profiler.h.
+		//
+		// Mit --schritt ms rechnet die Simulation in Schritten dieser Länge,
+		// siehe unten bei der Hauptschleife.
+		std::unique_ptr<EingabeAufnahme> aufnahme;
+		bool profil = false;
+		std::string traceDatei;
+		int schritt = 5;
+		for( int i = 1; i < argc; ++i){
+			std::string arg = argv[i];
+			if( arg == "--profil") profil = true;
+			if( i + 1 >= argc) continue;
+			if( arg == "--aufnahme") aufnahme.reset(new EingabeAufnahme(argv[i + 1]));
+			if( arg == "--trace") traceDatei = argv[i + 1];
+			if( arg == "--schritt") schritt = std::stoi(argv[i + 1]);
+		}
+		if( schritt <= 0) throw std::runtime_error("--schritt muss größer 0 sein");
+		if( profil || !traceDatei.empty()) welt.profiler.starte();
+		uint32_t tick = 0;
 
 		// Die aktuelle "Zeit" in Millisekunden
 		// wir nutzen hier 'auto' als Typangabe. C++ weiß selber, was für ein
@@ -741,6 +264,32 @@ int main(int argc, char **argv){
 		int zeitCounter = 0;
 		int framesProSekunde = 0;
 
+		// Feste Schritte
+		//
+		// Bisher bekam die Welt die Dauer des letzten Frames, in ganzen ms.
+		// Ein Frame mit 0 ms bewegt dann gar nichts, und nach einem Hänger
+		// von 200 ms springen die Einheiten ein ganzes Stück, an Türmen
+		// vorbei. Wie das Spiel läuft, hängt so von den FPS ab.
+		//
+		// Jetzt rechnet die Welt immer in Schritten von 'schritt' ms. Die
+		// echte Zeit wird im 'vorrat' gesammelt, und es werden so viele
+		// Schritte gerechnet, wie hineinpassen. Der Rest bleibt für den
+		// nächsten Frame. Auf einem schnellen Rechner gibt es also Frames
+		// ganz ohne Schritt, die kosten dann nur das Zeichnen.
+		//
+		// Damit dabei nichts ruckelt, wird zwischen den letzten beiden
+		// Schritten gezeichnet: ist der vorrat halb voll, stehen die
+		// Einheiten auf halbem Weg dazwischen.
+		//
+		// Nach einem langen Hänger wird nicht alles aufgeholt, sonst dauert
+		// der nächste Frame noch länger. Was über MAX_SCHRITTE geht, ist
+		// verloren, das Spiel läuft dann eben kurz langsamer.
+		const int MAX_SCHRITTE = 25;
+		const double tickFrequenz = SDL_GetPerformanceFrequency();
+		Uint64 letzteMessung = SDL_GetPerformanceCounter();
+		double vorrat = 0.0;
+		Uint32 simZeit = SDL_GetTicks();
+
 		bool running = true;
 
 		/*
@@ -751,6 +300,8 @@ int main(int argc, char **argv){
 		 * */
 		while(running){
 			startZeit = SDL_GetTicks();
+			Profiler::Abschnitt frame(welt.profiler, Phase::Frame);
+			Profiler::Abschnitt eingabe(welt.profiler, Phase::Eingabe);
 
 			/*
 			 * Die Event-Schleife.
@@ -771,91 +322,36 @@ int main(int argc, char **argv){
 						running = false;
 						break;
 					case SDL_MOUSEBUTTONUP:
-						erstelleNeuenTurm((*(SDL_MouseButtonEvent*)&event), aktiveTuerme, turm);
+						if( aufnahme) aufnahme->klick(tick, event.button.x, event.button.y);
+						erstelleNeuenTurm((*(SDL_MouseButtonEvent*)&event), welt, turm);
 						break;
 				}
 			}
+			eingabe.ende();
 
 			// Wir haben Events bekommen und können reagieren.
-			// Also können wir hier unsere Einheiten updaten.
-			// alle aktiven Einheiten werden geupdatet.
-			for( auto &e:aktiveEinheiten) e.update(differenzZeit);
-			//einheit.update(differenzZeit);
-			for( auto &t:aktiveTuerme) t.update(differenzZeit);
-
-
-
-			// Wir müssen hier mit den Iteratoren hantieren, da wir nur so
-			// wissen, welches Element wir nachher entfernen können.
-			// std::vector erase nimmt einen Iterator
-			// also müssen wir ihm diesen geben
-			//
-			// Warum entfernen wir die Einheit nicht gleich wenn wir wissen,
-			// dass sie hinüber ist?
-			// Tja.
-			// Das liegt hier an der Datenstruktur.
-			// Während wir über diesen Vector laufen, können wir keine Elemente
-			// davon entfernen oder irgendwo einfügen. Wer das versucht, darf
-			// sich auf Fehler einstellen.
-			// Deswegen packen wir die Einheit erst einmal zusätzlich in die
-			// extra Liste, und nehmen sie erst nachdem wir fertig sind, heraus.
-			for( auto it = aktiveEinheiten.begin(); it < aktiveEinheiten.end(); ++it){
-            //for( auto &e:aktiveEinheiten){
-				for( auto &t:aktiveTuerme){
-					if( t.shoot(*it)){
-						std::clog << "Treffer!" << std::endl;
-
-						// Der Turm hat geschossen. Das sollten wir auch anzeigen.
-						// Am einfachsten mit einer Linie von Turm zu Einheit.
-						// Zeichnen tun wir aber erst weiter unten, also speichern
-						// wir die beiden Coordinaten und zeigen sie später an.
-						// 
-						// Problem: Der Schuss wird hier von Position aus geschickt.
-						// Position ist aber oben links vom Bild/der Textur. Es
-						// sieht etwas seltsam aus. Also wäre es etwas besser, wenn
-						// wir von der Mitte des Turm aus schießen und auch die
-						// Einheit in der Mitte treffen.
-						// Trick 17: Wir wissen, dass die Bilder 32px breit und hoch
-						// sind. Die Hälfte ist die Mitte, also bei 16. Vom Rand
-						// gehen wir also einfach 16 schritte runter und rüber und
-						// sind in der Mitte.
-						// FIXME: Setzte Mitte anhand der Bildgröße und nicht nach
-						// "Wissen"
-						zuZeichnendeSchuesse.push_back({{
-								t.getPosition()[0] + 16, t.getPosition()[1] + 16,
-								it->getPosition()[0] + 16, it->getPosition()[1] + 16}});
-
-						if( it->gotHit(1)){ // FIXME: setzte Schadenswert vom Turm
-							std::clog << "Versenkt!" << std::endl;
-							// jetzt ists vorbei mit Einheit e
-							// deswegen kommt die Einheit in eine Liste
-							// die Liste der frisch Verstorbenen 
-							verloreneEinheiten.push_back(it);
-						}
-					}
-				}
-			//}
+			// Die Welt bewegt jetzt alle Einheiten und Türme, lässt die Türme
+			// schießen und räumt die toten Einheiten weg.
+			// Jeder Schritt ist ein Tick, so wie ohne Fenster.
+			Uint64 messung = SDL_GetPerformanceCounter();
+			vorrat += (messung - letzteMessung) * 1000.0 / tickFrequenz;
+			letzteMessung = messung;
+			int schritte = 0;
+			while( vorrat >= schritt && schritte < MAX_SCHRITTE){
+				simZeit += schritt;
+				if( aufnahme) aufnahme->frame(tick, schritt, simZeit);
+				welt.update(schritt, simZeit);
+				++tick;
+				++schritte;
+				vorrat -= schritt;
 			}
-
-			// jede verlorene Einheit wird jetzt von den aktiven Einheiten
-			// entfernt
-			for( auto it:verloreneEinheiten){
-				aktiveEinheiten.erase(it);
-				//
-				// jetzt nicht mehr. Wir spawnen lieber nach einer
-				// bestimmten Zeit.
-				//aktiveEinheiten.push_back(einheit); // just mal aus Spaß
-			}
-
-			// wir haben alle verlorene Einheiten von den aktiven entfernt
-			// jetzt können wir diese auch aus dieser Liste heraus nehmen
-			verloreneEinheiten.clear();
+			if( schritte == MAX_SCHRITTE && vorrat >= schritt) vorrat = 0.0;
 
 			/*
 			 * Hier unten zeichnen wir auf unseren renderer
 			 * Noch passiert nicht viel.
-			 * Wir löschen die Fläche 'clear'
-			 * und zeigen dann die Fläche an 'present'
+			 * Wir löschen die Fläche (das macht inzwischen welt.draw, siehe
+			 * Hintergrund.h) und zeigen dann die Fläche an 'present'
 			 * Dabei nutzen wir das Prinzip des DoubleBuffering.
 			 * Es gibt 2 Buffer.
 			 * Einer davon wird angezeigt, auf den anderen schreiben wir in der
@@ -864,7 +360,6 @@ int main(int argc, char **argv){
 			 * Der andere kommt zu uns nach Hinten und wir können darauf
 			 * herummalen.
 			 * */
-			SDL_RenderClear(renderer);
 
             // Eigentlich können wir hier mal unser Bildchen zeichnen.
 			// Wir kopieren dazu unsere Texture auf unsere Render-Fläche, den
@@ -875,33 +370,15 @@ int main(int argc, char **argv){
 			// auftauchen.
             //SDL_RenderCopy(renderer, textureEinheit, nullptr, &rect);
 
-            // Und hier zeichnen wir die Einheiten
-			// alle aktiven Einheiten auf den Renderer zeichnen
-			for( auto &e:aktiveEinheiten) e.draw(renderer);
-			//einheit.draw(renderer);
-			for( auto &t:aktiveTuerme) t.draw(renderer);
-
-            // Schüsse zeichnen
-			//
-			// Da wir die aber nur ein Frame lang zeichnen, könnte es sein, dass
-			// wir davon nicht viel mitbekommen. Werden wir ja im Test sehen ;-)
-			//
-			// Die Linie sollte eine Farbe != schwarz haben. Aber vorher
-			// speichern wir die aktuelle Farbe und setzen diese anschließend
-			// auch wieder. Man kann ja nicht wissen, was andere zuvor
-			// angestellt haben...
-			Uint8 rgba[4];
-			SDL_GetRenderDrawColor(renderer, &rgba[0], &rgba[1], &rgba[2], &rgba[3]);
-			SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-			for( auto &line:zuZeichnendeSchuesse){
-				SDL_RenderDrawLine(renderer, line[0], line[1], line[2], line[3]);
-			}
-			zuZeichnendeSchuesse.clear();
-			SDL_SetRenderDrawColor(renderer, rgba[0], rgba[1], rgba[2], rgba[3]);
-
+            // Und hier zeichnen wir die Einheiten, Türme und Schüsse
+			welt.draw(renderer, vorrat / schritt);
 
-			SDL_RenderPresent(renderer);
 
+			{
+				Profiler::Abschnitt anzeigen(welt.profiler, Phase::Anzeigen);
+				SDL_RenderPresent(renderer);
+			}
+			frame.ende();
 
 			// Die Zeit für ein Frame bekommen wir, in dem wir die Zeit am Ende
 			// minus der Zeit am Anfang rechnen.
@@ -915,15 +392,24 @@ int main(int argc, char **argv){
 			// FPS anzeigt.
 			++framesProSekunde;
 			if( zeitCounter >= 1000){
-				std::clog << "[INFO] FPS: " << framesProSekunde << std::endl;
+				TD_LOG(LogBereich::Spiel, LogStufe::Info, 0, "FPS: {}, Zeichenaufrufe: {}, Absenden: {} us",
+						framesProSekunde, welt.batch.zeichenAufrufe(), welt.batch.mikrosekunden());
+				if( profil){
+					// Die Tabelle kommt direkt, also erst die FPS raus.
+					logbuch().leere();
+					welt.profiler.gibAus(std::clog, "[PROFIL] ");
+					welt.profiler.neuesFenster();
+				}
 				framesProSekunde = 0;
 				zeitCounter = 0;
 			}
 		}
 
+		if( !traceDatei.empty()){
+			welt.profiler.schreibeTrace(traceDatei);
+			std::clog << "[INFO] Trace geschrieben: " << traceDatei << std::endl;
+		}
 
-		SDL_RemoveTimer(spawnTimer);
-	
 	// Fangen wir Exceptions!
 	// In dem Fall fangen wir eine Ausnahme vom Type std::runtime_error
 	// Irgendwo werden wir diese wohl geworfen haben ...
@@ -937,10 +423,11 @@ int main(int argc, char **argv){
 	 * Wir müssen noch etwas aufräumen.
 	 * Wahrscheinlich haben wir einen renderer und ein window. Die müssen noch
 	 * zerstört werden.
-	 * Auch die Texture, die wir wahrscheinlich haben, muss freigegeben werden.
+	 * Die Texture des Atlas hat der Atlas schon selber freigegeben. Die des
+	 * Hintergrunds gehört der Welt, und die lebt länger als der renderer.
+	 * Also geben wir sie vorher frei.
 	 * */
-	SDL_DestroyTexture(textureTurm);
-	SDL_DestroyTexture(textureEinheit);
+	welt.hintergrund.gibFrei();
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
 